@@ -69,11 +69,24 @@ private:\
 // is executed we will see a fatal log.
 #define NOT_IMPLEMENTED LOG(FATAL) << "Not Implemented Yet"
 
+// Splits the following for loop between the OpenMP threads of the calling
+// thread (see Caffe::set_cpu_threads) if it processes at least
+// caffe::kParallelMinCount elements. No-op if built without USE_OPENMP.
+#ifdef _OPENMP
+#define CAFFE_PARALLEL_FOR(count) _Pragma(STRINGIFY( \
+    omp parallel for if ((count) >= caffe::kParallelMinCount)))
+#else
+#define CAFFE_PARALLEL_FOR(count)
+#endif
+
 // See PR #1236
 namespace cv { class Mat; }
 
 namespace caffe {
 
+// Below this number of elements, the OpenMP overhead outweighs the speedup.
+const int kParallelMinCount = 32768;
+
 // We will use the boost shared_ptr instead of the new C++11 one mainly
 // because cuda does not work (at least now) well with C++11 features.
 using boost::shared_ptr;
@@ -166,6 +179,11 @@ class Caffe {
   inline static bool multiprocess() { return Get().multiprocess_; }
   inline static void set_multiprocess(bool val) { Get().multiprocess_ = val; }
   inline static bool root_solver() { return Get().solver_rank_ == 0; }
+  // Number of OpenMP threads of the CPU layers run by the calling thread (0
+  // keeps the OpenMP default, i.e., OMP_NUM_THREADS or all the cores). It is
+  // per thread, so several nets running in parallel can split the cores.
+  static void set_cpu_threads(const int cpu_threads);
+  inline static int cpu_threads() { return Get().cpu_threads_; }
 
  protected:
 #ifndef CPU_ONLY
@@ -181,6 +199,8 @@ class Caffe {
   int solver_rank_;
   bool multiprocess_;
 
+  int cpu_threads_;
+
  private:
   // The private constructor to avoid duplicate instantiation.
   Caffe();
@@ -12,6 +12,10 @@ namespace caffe {
 /**
  * @brief Takes at least two Blob%s and concatenates them along either the num
  *        or channel dimension, outputting the result.
+ *
+ * The bottoms marked as in_place_bottom (see caffe/util/fuse_layers.hpp) point
+ * into their slice of the top whenever the concatenation is contiguous, so
+ * their producers write the top directly and the forward pass skips them.
  */
 template <typename Dtype>
 class ConcatLayer : public Layer<Dtype> {
@@ -27,6 +31,19 @@ class ConcatLayer : public Layer<Dtype> {
   virtual inline int MinBottomBlobs() const { return 1; }
   virtual inline int ExactNumTopBlobs() const { return 1; }
 
+  /**
+   * @brief Points the in_place_bottom bottoms into their slice of the top, or
+   *        gives them back their own memory if the concatenation is not
+   *        contiguous. Called by Reshape, and to be called again whenever the
+   *        top data is moved afterwards (e.g. with Blob::set_gpu_data).
+   */
+  void ShareInPlaceBottoms(const vector<Blob<Dtype>*>& bottom,
+      const vector<Blob<Dtype>*>& top);
+  /// @brief Whether bottom i currently points into the top.
+  inline bool is_in_place_bottom(int i) const {
+    return i < in_place_.size() && in_place_[i];
+  }
+
  protected:
   /**
    * @param bottom input Blob vector (length 2+)
@@ -80,6 +97,7 @@ class ConcatLayer : public Layer<Dtype> {
   int num_concats_;
   int concat_input_size_;
   int concat_axis_;
+  vector<bool> in_place_;
 };
 
 }  // namespace caffe
@@ -1,6 +1,8 @@
 #ifndef CAFFE_CONV_LAYER_HPP_
 #define CAFFE_CONV_LAYER_HPP_
 
+#include <stdint.h>
+
 #include <vector>
 
 #include "caffe/blob.hpp"
@@ -60,12 +62,60 @@ class ConvolutionLayer : public BaseConvolutionLayer<Dtype> {
    *  - bias_term (\b optional, default true). Whether to have a bias.
    *  - engine: convolution has CAFFE (matrix multiplication) and CUDNN (library
    *    kernels + stream parallelism) engines.
+   *
+   *  In the TEST phase, the CPU forward pass of 2D, group 1, stride 1 and
+   *  dilation 1 convolutions can also run without im2col (see
+   *  caffe/util/fast_conv.hpp): Winograd F(4x4, 3x3) for 3x3 kernels and a
+   *  cache-blocked direct convolution for the other kernel sizes. With the
+   *  default AUTO CPU engine, the first forward pass times every eligible
+   *  engine, rejects the ones whose output differs from the GEMM one, keeps
+   *  the fastest and logs the per-layer speedup.
+   *  - fused_relu / fused_relu_negative_slope (\b optional, default false).
+   *  Apply a (leaky) ReLU to the output together with the bias, so a
+   *  following ReLU layer can be removed (see caffe/util/fuse_layers.hpp).
+   *  Forward only: a fused convolution cannot be backpropagated.
+   *  - int8_input_scale / int8_weight_scale (\b optional). Post-training
+   *  quantization of the TEST-phase CPU forward pass of 2D, group 1
+   *  convolutions (see caffe/util/int8_gemm.hpp): the input is quantized
+   *  with int8_input_scale and the weights with one int8_weight_scale per
+   *  output channel (max|weights| / 127 if not given). With the AUTO CPU
+   *  engine, INT8 is one more candidate of every convolution with a positive
+   *  int8_input_scale, accepted if its output is within 5% of the GEMM output
+   *  range (the network-level error is measured by the calibration).
    */
   explicit ConvolutionLayer(const LayerParameter& param)
-      : BaseConvolutionLayer<Dtype>(param) {}
+      : BaseConvolutionLayer<Dtype>(param),
+        fused_relu_(param.convolution_param().fused_relu()),
+        fused_relu_negative_slope_(
+            param.convolution_param().fused_relu_negative_slope()),
+        cpu_engine_(AUTO), winograd_weights_source_(NULL),
+        int8_input_scale_(param.convolution_param().int8_input_scale()),
+        int8_weight_scales_(
+            param.convolution_param().int8_weight_scale().begin(),
+            param.convolution_param().int8_weight_scale().end()),
+        int8_weights_source_(NULL) {}
 
   virtual inline const char* type() const { return "Convolution"; }
 
+  enum CpuEngine { AUTO, GEMM, WINOGRAD, DIRECT, INT8 };
+  /// Forces a CPU engine (e.g., for testing). Non-eligible engines fall back
+  /// to GEMM, as does everything in the TRAIN phase.
+  void set_cpu_engine(CpuEngine cpu_engine) { cpu_engine_ = cpu_engine; }
+  CpuEngine cpu_engine() const { return cpu_engine_; }
+
+  /// Replaces the INT8 quantization scales (an input scale of 0 disables it)
+  /// and selects the CPU engine again.
+  void set_int8_scales(float input_scale, const vector<float>& weight_scales) {
+    int8_input_scale_ = input_scale;
+    int8_weight_scales_ = weight_scales;
+    int8_weights_source_ = NULL;
+    cpu_engine_ = AUTO;
+  }
+  float int8_input_scale() const { return int8_input_scale_; }
+  const vector<float>& int8_weight_scales() const {
+    return int8_weight_scales_;
+  }
+
  protected:
   virtual void Forward_cpu(const vector<Blob<Dtype>*>& bottom,
       const vector<Blob<Dtype>*>& top);
@@ -77,6 +127,53 @@ class ConvolutionLayer : public BaseConvolutionLayer<Dtype> {
       const vector<bool>& propagate_down, const vector<Blob<Dtype>*>& bottom);
   virtual inline bool reverse_dimensions() { return false; }
   virtual void compute_output_shape();
+
+  // Epilogue of one image: bias (if not NULL) and the fused ReLU (if any)
+  void forward_cpu_bias_relu(Dtype* output, const Dtype* bias);
+#ifndef CPU_ONLY
+  // Same for num consecutive images
+  void forward_gpu_bias_relu(Dtype* output, const Dtype* bias, int num = 1);
+#endif
+
+  const bool fused_relu_;
+  const Dtype fused_relu_negative_slope_;
+
+ private:
+  bool is_cpu_engine_eligible(CpuEngine cpu_engine);
+  void forward_cpu_engine(CpuEngine cpu_engine,
+      const vector<Blob<Dtype>*>& bottom, const vector<Blob<Dtype>*>& top);
+  void select_cpu_engine(const vector<Blob<Dtype>*>& bottom,
+      const vector<Blob<Dtype>*>& top);
+  void forward_cpu_int8(const Dtype* input, int padded_k, Dtype* output);
+  void share_winograd_weights(const Dtype* weight);
+  void share_int8_weights(const Dtype* weight, int padded_k);
+
+  // Quantized weights of the INT8 engine, their row sums and scales
+  struct Int8Weights {
+    vector<int8_t> weights;
+    vector<int> row_sums;
+    vector<float> row_scales;
+  };
+
+  CpuEngine cpu_engine_;
+  // Winograd-domain weights, taken again whenever the weights blob memory
+  // changes (e.g., Net::ShareTrainedLayersWith). They are computed once per
+  // weights memory and shared by all the layers pointing to it (e.g., the nets
+  // sharing a weights net), so they cost 36 / 9 times the 3x3 weights once
+  // per process rather than once per net.
+  shared_ptr<const Blob<Dtype> > winograd_weights_;
+  const Dtype* winograd_weights_source_;
+  Blob<Dtype> winograd_buffer_;
+  // INT8 engine: scales, the quantized weights (shared like the Winograd
+  // ones, keyed by the weights memory and int8_weight_scales_) and the
+  // int8/int32 buffers
+  float int8_input_scale_;
+  vector<float> int8_weight_scales_;
+  const Dtype* int8_weights_source_;
+  shared_ptr<const Int8Weights> int8_weights_;
+  vector<int8_t> int8_input_;
+  vector<int8_t> int8_rows_;
+  vector<int> int8_output_;
 };
 
 }  // namespace caffe
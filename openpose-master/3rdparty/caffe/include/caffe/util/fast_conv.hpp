@@ -0,0 +1,47 @@
+#ifndef _CAFFE_UTIL_FAST_CONV_HPP_
+#define _CAFFE_UTIL_FAST_CONV_HPP_
+
+namespace caffe {
+
+// CPU convolution kernels that avoid the im2col expansion of the GEMM path.
+// All of them are for a single image, group 1, stride 1 and dilation 1, with
+// the usual Caffe layouts (weights: num_output x channels x kernel_h x
+// kernel_w, images: channels x height x width) and output size
+// (height + 2 * pad_h - kernel_h + 1) x (width + 2 * pad_w - kernel_w + 1).
+
+// Number of output tiles transformed together by winograd_f4x4_3x3_cpu.
+const int kWinogradTileBlock = 256;
+
+// Transforms 3x3 weights into the Winograd F(4x4, 3x3) domain:
+// weights_winograd is 36 x num_output x channels.
+template <typename Dtype>
+void winograd_f4x4_3x3_weights_cpu(const Dtype* weights, const int num_output,
+    const int channels, Dtype* weights_winograd);
+
+// Number of Dtype elements of the workspace of winograd_f4x4_3x3_cpu.
+inline int winograd_f4x4_3x3_workspace_size(const int channels,
+    const int num_output) {
+  return 36 * (channels + num_output) * kWinogradTileBlock;
+}
+
+// 3x3 convolution with Winograd F(4x4, 3x3): each 6x6 input tile gives a 4x4
+// output tile with 36 (instead of 144) multiplications per channel pair,
+// computed as 36 GEMMs over blocks of kWinogradTileBlock tiles.
+template <typename Dtype>
+void winograd_f4x4_3x3_cpu(const Dtype* data_im, const int channels,
+    const int height, const int width, const int pad_h, const int pad_w,
+    const Dtype* weights_winograd, const int num_output, Dtype* data_out,
+    Dtype* workspace);
+
+// Direct convolution for any kernel size, blocked over output channels and
+// output rows so that the input and output rows being accumulated stay in
+// cache. It needs no workspace.
+template <typename Dtype>
+void direct_conv_cpu(const Dtype* data_im, const int channels,
+    const int height, const int width, const int kernel_h, const int kernel_w,
+    const int pad_h, const int pad_w, const Dtype* weights,
+    const int num_output, Dtype* data_out);
+
+}  // namespace caffe
+
+#endif  // _CAFFE_UTIL_FAST_CONV_HPP_
@@ -0,0 +1,24 @@
+#ifndef CAFFE_UTIL_FUSE_LAYERS_HPP_
+#define CAFFE_UTIL_FUSE_LAYERS_HPP_
+
+#include "caffe/proto/caffe.pb.h"
+
+namespace caffe {
+
+// Copy NetParameters with the inference-only layer fusions applied (run by
+// Net::Init in the TEST phase, unless force_backward is set):
+//  - A ReLU layer that is the first reader of a Convolution output (either in
+//    place or as its only reader) is removed and applied in the convolution
+//    epilogue instead (fused_relu). The convolution then produces the ReLU top
+//    directly.
+//  - The Concat bottoms whose memory is not shared with any other blob (i.e.
+//    produced by a single layer that does not share data, optionally modified
+//    by in-place layers, and only read by the Concat) are marked as
+//    in_place_bottom, so they are written directly into the Concat top.
+// The removed ReLU layers and the pre-ReLU blobs no longer exist in the Net.
+void FuseLayersForInference(const NetParameter& param,
+    NetParameter* param_fused);
+
+}  // namespace caffe
+
+#endif  // CAFFE_UTIL_FUSE_LAYERS_HPP_
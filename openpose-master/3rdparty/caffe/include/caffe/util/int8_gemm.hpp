@@ -0,0 +1,57 @@
+#ifndef _CAFFE_UTIL_INT8_GEMM_HPP_
+#define _CAFFE_UTIL_INT8_GEMM_HPP_
+
+#include <stdint.h>
+
+namespace caffe {
+
+// CPU kernels of the INT8 convolution engine (post-training quantization):
+// weights are quantized per output channel and activations per tensor, both
+// symmetric to [-127, 127] (x ~= q * scale). The dot products are computed in
+// int32 with AVX-512 VNNI, AVX-VNNI or AVX2, the best one supported by the CPU
+// (detected at run time, so no -march flag is needed with GCC), and with plain
+// C++ otherwise.
+
+// The K dimension of the int8 matrices is zero-padded to a multiple of this.
+const int kInt8GemmAlignment = 64;
+
+inline int int8_gemm_padded_k(const int k) {
+  return (k + kInt8GemmAlignment - 1) / kInt8GemmAlignment
+      * kInt8GemmAlignment;
+}
+
+// Name of the int8 dot product instructions used by int8_gemm_cpu on this CPU.
+const char* int8_gemm_isa();
+
+// Quantizes num_output x k weights with one scale per row (if scales is
+// NULL, they are computed as max|row| / 127 and written into scales_out) into
+// num_output x padded_k int8 rows. row_sums receives the sum of each
+// quantized row (needed by int8_gemm_cpu).
+template <typename Dtype>
+void int8_quantize_weights_cpu(const Dtype* weights, const int num_output,
+    const int k, const float* scales, float* scales_out, int8_t* weights_int8,
+    int* row_sums);
+
+// q = round(x / scale), saturated to [-127, 127].
+template <typename Dtype>
+void int8_quantize_cpu(const int n, const Dtype* x, const float scale,
+    int8_t* q);
+
+// im2col of a quantized channels x height x width image, but transposed: one
+// row of padded_k int8 values (channels x kernel_h x kernel_w, then zeros)
+// per output pixel.
+void int8_im2row_cpu(const int8_t* data_im, const int channels,
+    const int height, const int width, const int kernel_h, const int kernel_w,
+    const int pad_h, const int pad_w, const int stride_h, const int stride_w,
+    const int dilation_h, const int dilation_w, const int padded_k,
+    int8_t* data_row);
+
+// C (m x n, int32) = A (m x padded_k) * B^T, with B n x padded_k, i.e. every
+// output is the dot product of a weight row and an im2row row. a_row_sums are
+// the row sums given by int8_quantize_weights_cpu.
+void int8_gemm_cpu(const int m, const int n, const int padded_k,
+    const int8_t* a, const int* a_row_sums, const int8_t* b, int* c);
+
+}  // namespace caffe
+
+#endif  // _CAFFE_UTIL_INT8_GEMM_HPP_
@@ -0,0 +1,107 @@
+#ifndef CAFFE_UTIL_LAYER_SCHEDULER_HPP_
+#define CAFFE_UTIL_LAYER_SCHEDULER_HPP_
+
+#include <deque>
+#include <vector>
+
+#include "caffe/common.hpp"
+#include "caffe/net.hpp"
+
+/**
+ Forward declare boost::thread instead of including boost/thread.hpp
+ to avoid a boost/NVCC issues (#1009, #1010) on OSX.
+ */
+namespace boost {
+class thread;
+class mutex;
+template <typename Mutex> class unique_lock;
+}
+
+namespace caffe {
+
+/**
+ * @brief Inference-only forward pass that runs the independent branches of a
+ *        Net concurrently (e.g. the L1 and L2 branches of each stage of the
+ *        OpenPose networks).
+ *
+ * Each layer depends on the previous layers that write the blobs it reads
+ * (read after write) and on the previous readers and writers of the blobs it
+ * writes (write after read/write). A layer is run by the first free thread
+ * (the calling one or one of num_threads - 1 workers) as soon as its
+ * dependency counter reaches zero. The cpu_threads OpenMP threads are split
+ * between the layers that can run at the same time: each layer uses
+ * cpu_threads / min(num_threads, #layers at its depth of the DAG).
+ *
+ * Memory shared between blobs that the Net does not know about (e.g. an
+ * external memory planner aliasing blobs with non-overlapping lifetimes) must
+ * respect precedes(): two layers that do not precede each other can run at the
+ * same time. The before/after forward callbacks and the debug info of Net are
+ * not used. In GPU mode (a single CUDA stream), ForwardFromTo is the
+ * sequential Net::ForwardFromTo.
+ */
+template <typename Dtype>
+class LayerScheduler {
+ public:
+  /**
+   * @param num_threads Maximum number of layers run at the same time. <= 1
+   *        runs the layers sequentially.
+   * @param cpu_threads OpenMP threads split between the concurrent layers
+   *        (see Caffe::set_cpu_threads). 0 uses all the logical cores.
+   */
+  LayerScheduler(Net<Dtype>* net, const int num_threads,
+      const int cpu_threads = 0);
+  ~LayerScheduler();
+
+  /// @brief Same result than Net::ForwardFromTo(start, end).
+  Dtype ForwardFromTo(const int start, const int end);
+  Dtype Forward() { return ForwardFromTo(0, net_->layers().size() - 1); }
+
+  /// @brief Layers that must finish before the given layer starts.
+  inline const vector<int>& dependencies(const int layer) const {
+    return dependencies_[layer];
+  }
+  /// @brief Whether layer before (transitively) finishes before layer after
+  ///        starts. False for before == after.
+  inline bool precedes(const int before, const int after) const {
+    return ancestors_[after][before];
+  }
+  inline int num_threads() const { return num_threads_; }
+  /// @brief OpenMP threads used by the given layer.
+  inline int layer_cpu_threads(const int layer) const {
+    return layer_cpu_threads_[layer];
+  }
+
+ private:
+  void InitDependencies();
+  void StartWorkers();
+  void WorkerEntry();
+  // Runs the ready layers until the current ForwardFromTo is finished (caller)
+  // or the workers are stopped (worker). The lock of sync_ is held, except
+  // while running a layer.
+  void RunReadyLayers(boost::unique_lock<boost::mutex>* lock,
+      const bool caller);
+
+  Net<Dtype>* net_;
+  const int num_threads_;
+  vector<vector<int> > dependencies_;
+  vector<vector<int> > dependents_;
+  vector<vector<bool> > ancestors_;
+  vector<int> layer_cpu_threads_;
+
+  // State of the current ForwardFromTo (guarded by sync_)
+  class sync;
+  shared_ptr<sync> sync_;
+  vector<shared_ptr<boost::thread> > workers_;
+  std::deque<int> ready_layers_;
+  vector<int> pending_dependencies_;
+  int end_;
+  int remaining_layers_;
+  Dtype loss_;
+  bool stop_;
+
+  DISABLE_COPY_AND_ASSIGN(LayerScheduler);
+};
+
+}  // namespace caffe
+
+#endif  // CAFFE_UTIL_LAYER_SCHEDULER_HPP_
@@ -3,6 +3,9 @@
 #include <cmath>
 #include <cstdio>
 #include <ctime>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "caffe/common.hpp"
 #include "caffe/util/rng.hpp"
@@ -19,6 +22,22 @@ Caffe& Caffe::Get() {
   return *(thread_instance_.get());
 }
 
+void Caffe::set_cpu_threads(const int cpu_threads) {
+  CHECK_GE(cpu_threads, 0);
+  Get().cpu_threads_ = cpu_threads;
+#ifdef _OPENMP
+  // OpenMP keeps the number of threads per calling thread
+  if (cpu_threads > 0) {
+    omp_set_num_threads(cpu_threads);
+  }
+#else
+  if (cpu_threads > 1) {
+    LOG_FIRST_N(WARNING, 1) << "Caffe was built without USE_OPENMP, the CPU "
+        << "layers will run single-threaded.";
+  }
+#endif
+}
+
 // random seeding
 int64_t cluster_seedgen(void) {
   int64_t s, seed, pid;
@@ -53,7 +72,8 @@ void GlobalInit(int* pargc, char*** pargv) {
 
 Caffe::Caffe()
     : random_generator_(), mode_(Caffe::CPU),
-      solver_count_(1), solver_rank_(0), multiprocess_(false) { }
+      solver_count_(1), solver_rank_(0), multiprocess_(false),
+      cpu_threads_(0) { }
 
 Caffe::~Caffe() { }
 
@@ -107,7 +127,8 @@ void* Caffe::RNG::generator() {
 Caffe::Caffe()
     : cublas_handle_(NULL), curand_generator_(NULL), random_generator_(),
     mode_(Caffe::CPU),
-    solver_count_(1), solver_rank_(0), multiprocess_(false) {
+    solver_count_(1), solver_rank_(0), multiprocess_(false),
+    cpu_threads_(0) {
   // Try to create a cublas handler, and report an error if failed (but we will
   // keep the program running as one might just want to run CPU code).
   if (cublasCreate(&cublas_handle_) != CUBLAS_STATUS_SUCCESS) {
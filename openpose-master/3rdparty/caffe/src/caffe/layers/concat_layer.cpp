@@ -11,6 +11,9 @@ void ConcatLayer<Dtype>::LayerSetUp(const vector<Blob<Dtype>*>& bottom,
   const ConcatParameter& concat_param = this->layer_param_.concat_param();
   CHECK(!(concat_param.has_axis() && concat_param.has_concat_dim()))
       << "Either axis or concat_dim should be specified; not both.";
+  CHECK(concat_param.in_place_bottom_size() == 0
+      || concat_param.in_place_bottom_size() == bottom.size())
+      << "in_place_bottom must be specified either 0 or bottom_size times.";
 }
 
 template <typename Dtype>
@@ -50,6 +53,41 @@ void ConcatLayer<Dtype>::Reshape(const vector<Blob<Dtype>*>& bottom,
   if (bottom.size() == 1) {
     top[0]->ShareData(*bottom[0]);
     top[0]->ShareDiff(*bottom[0]);
+  } else {
+    ShareInPlaceBottoms(bottom, top);
+  }
+}
+
+template <typename Dtype>
+void ConcatLayer<Dtype>::ShareInPlaceBottoms(
+      const vector<Blob<Dtype>*>& bottom, const vector<Blob<Dtype>*>& top) {
+  const ConcatParameter& concat_param = this->layer_param_.concat_param();
+  in_place_.resize(bottom.size(), false);
+  Dtype* top_data = NULL;
+  int offset_concat_axis = 0;
+  for (int i = 0; i < bottom.size(); ++i) {
+    const bool in_place = (concat_param.in_place_bottom_size() > 0
+        && concat_param.in_place_bottom(i) && num_concats_ == 1
+        && bottom[i]->count() > 0);
+    if (in_place) {
+      const bool gpu_mode = (Caffe::mode() == Caffe::GPU);
+      if (!top_data) {
+        top_data = (gpu_mode ? top[0]->mutable_gpu_data()
+            : top[0]->mutable_cpu_data());
+      }
+      Dtype* slice_data = top_data + offset_concat_axis * concat_input_size_;
+      if (gpu_mode) {
+        bottom[i]->set_gpu_data(slice_data);
+      } else {
+        bottom[i]->set_cpu_data(slice_data);
+      }
+    } else if (in_place_[i]) {
+      // No longer contiguous: back to its own memory
+      Blob<Dtype> own_data(bottom[i]->shape());
+      bottom[i]->ShareData(own_data);
+    }
+    in_place_[i] = in_place;
+    offset_concat_axis += bottom[i]->shape(concat_axis_);
   }
 }
 
@@ -58,18 +96,30 @@ void ConcatLayer<Dtype>::Forward_cpu(const vector<Blob<Dtype>*>& bottom,
       const vector<Blob<Dtype>*>& top) {
   if (bottom.size() == 1) { return; }
   Dtype* top_data = top[0]->mutable_cpu_data();
-  int offset_concat_axis = 0;
   const int top_concat_axis = top[0]->shape(concat_axis_);
+  // One copy per (bottom, concat), copied in parallel
+  vector<int> offsets_concat_axis(bottom.size(), 0);
+  for (int i = 1; i < bottom.size(); ++i) {
+    offsets_concat_axis[i] = offsets_concat_axis[i - 1]
+        + bottom[i - 1]->shape(concat_axis_);
+  }
+  // In-place bottoms are already in the top (synced if they were written on
+  // the GPU)
   for (int i = 0; i < bottom.size(); ++i) {
+    if (in_place_[i]) { bottom[i]->cpu_data(); }
+  }
+  const int num_copies = bottom.size() * num_concats_;
+  CAFFE_PARALLEL_FOR(top[0]->count())
+  for (int copy = 0; copy < num_copies; ++copy) {
+    const int i = copy / num_concats_;
+    const int n = copy % num_concats_;
+    if (in_place_[i]) { continue; }
     const Dtype* bottom_data = bottom[i]->cpu_data();
     const int bottom_concat_axis = bottom[i]->shape(concat_axis_);
-    for (int n = 0; n < num_concats_; ++n) {
-      caffe_copy(bottom_concat_axis * concat_input_size_,
-          bottom_data + n * bottom_concat_axis * concat_input_size_,
-          top_data + (n * top_concat_axis + offset_concat_axis)
-              * concat_input_size_);
-    }
-    offset_concat_axis += bottom_concat_axis;
+    caffe_copy(bottom_concat_axis * concat_input_size_,
+        bottom_data + n * bottom_concat_axis * concat_input_size_,
+        top_data + (n * top_concat_axis + offsets_concat_axis[i])
+            * concat_input_size_);
   }
 }
 
@@ -1,9 +1,52 @@
+#include <boost/thread.hpp>
+#include <boost/weak_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <utility>
 #include <vector>
 
 #include "caffe/layers/conv_layer.hpp"
+#include "caffe/util/benchmark.hpp"
+#include "caffe/util/fast_conv.hpp"
+#include "caffe/util/int8_gemm.hpp"
 
 namespace caffe {
 
+// Process-wide caches of the weights transformed by the Winograd and INT8
+// engines, keyed by the weights memory (and the INT8 weight scales). Layers
+// sharing their weights blobs reuse the same entry, which is released with the
+// last layer using it.
+typedef std::pair<const void*, vector<float> > TransformedWeightsKey;
+
+static boost::mutex transformed_weights_mutex;
+
+template <typename Value>
+std::map<TransformedWeightsKey, boost::weak_ptr<const Value> >&
+    transformed_weights_cache() {
+  static std::map<TransformedWeightsKey, boost::weak_ptr<const Value> > cache;
+  return cache;
+}
+
+// Returns the cached entry of key (NULL if none) and drops the expired ones.
+// Must be called with transformed_weights_mutex locked.
+template <typename Value>
+shared_ptr<const Value> find_transformed_weights(
+    const TransformedWeightsKey& key) {
+  typedef std::map<TransformedWeightsKey, boost::weak_ptr<const Value> > Cache;
+  Cache& cache = transformed_weights_cache<Value>();
+  for (typename Cache::iterator it = cache.begin(); it != cache.end();) {
+    if (it->second.expired()) {
+      cache.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  typename Cache::const_iterator it = cache.find(key);
+  return (it == cache.end() ? shared_ptr<const Value>() : it->second.lock());
+}
+
 template <typename Dtype>
 void ConvolutionLayer<Dtype>::compute_output_shape() {
   const int* kernel_shape_data = this->kernel_shape_.cpu_data();
@@ -22,26 +65,279 @@ void ConvolutionLayer<Dtype>::compute_output_shape() {
 }
 
 template <typename Dtype>
-void ConvolutionLayer<Dtype>::Forward_cpu(const vector<Blob<Dtype>*>& bottom,
-      const vector<Blob<Dtype>*>& top) {
+bool ConvolutionLayer<Dtype>::is_cpu_engine_eligible(CpuEngine cpu_engine) {
+  if (cpu_engine == GEMM) {
+    return true;
+  }
+  if (this->phase_ != TEST || this->num_spatial_axes_ != 2
+      || this->force_nd_im2col_ || this->group_ != 1) {
+    return false;
+  }
+  if (cpu_engine == INT8) {
+    return int8_input_scale_ > 0;
+  }
+  const int* kernel_shape_data = this->kernel_shape_.cpu_data();
+  const int* stride_data = this->stride_.cpu_data();
+  const int* dilation_data = this->dilation_.cpu_data();
+  for (int i = 0; i < 2; ++i) {
+    if (stride_data[i] != 1 || dilation_data[i] != 1) {
+      return false;
+    }
+  }
+  if (cpu_engine == WINOGRAD) {
+    return kernel_shape_data[0] == 3 && kernel_shape_data[1] == 3;
+  }
+  // GEMM needs no im2col for 1x1 kernels without padding
+  return cpu_engine == DIRECT && !this->is_1x1_;
+}
+
+template <typename Dtype>
+void ConvolutionLayer<Dtype>::forward_cpu_engine(CpuEngine cpu_engine,
+      const vector<Blob<Dtype>*>& bottom, const vector<Blob<Dtype>*>& top) {
   const Dtype* weight = this->blobs_[0]->cpu_data();
+  const int channels = this->channels_;
+  // Only used (and only valid) for the 2D engines
+  const int height = (cpu_engine == GEMM ? 0 : this->input_shape(1));
+  const int width = (cpu_engine == GEMM ? 0 : this->input_shape(2));
+  const int* kernel_shape_data = this->kernel_shape_.cpu_data();
+  const int* pad_data = this->pad_.cpu_data();
+  // Only used by INT8
+  const int padded_k = int8_gemm_padded_k(this->blobs_[0]->count(1));
+  if (cpu_engine == INT8) {
+    if (int8_weights_source_ != weight) {
+      share_int8_weights(weight, padded_k);
+    }
+    int8_input_.resize(this->bottom_dim_);
+    int8_rows_.resize(this->out_spatial_dim_ * padded_k);
+    int8_output_.resize(this->num_output_ * this->out_spatial_dim_);
+  } else if (cpu_engine == WINOGRAD) {
+    if (winograd_weights_source_ != weight) {
+      share_winograd_weights(weight);
+    }
+    vector<int> buffer_shape(1, winograd_f4x4_3x3_workspace_size(channels,
+        this->num_output_));
+    winograd_buffer_.Reshape(buffer_shape);
+  }
   for (int i = 0; i < bottom.size(); ++i) {
     const Dtype* bottom_data = bottom[i]->cpu_data();
     Dtype* top_data = top[i]->mutable_cpu_data();
     for (int n = 0; n < this->num_; ++n) {
-      this->forward_cpu_gemm(bottom_data + n * this->bottom_dim_, weight,
-          top_data + n * this->top_dim_);
-      if (this->bias_term_) {
-        const Dtype* bias = this->blobs_[1]->cpu_data();
-        this->forward_cpu_bias(top_data + n * this->top_dim_, bias);
+      if (cpu_engine == INT8) {
+        forward_cpu_int8(bottom_data + n * this->bottom_dim_, padded_k,
+            top_data + n * this->top_dim_);
+      } else if (cpu_engine == WINOGRAD) {
+        winograd_f4x4_3x3_cpu(bottom_data + n * this->bottom_dim_, channels,
+            height, width, pad_data[0], pad_data[1],
+            winograd_weights_->cpu_data(), this->num_output_,
+            top_data + n * this->top_dim_,
+            winograd_buffer_.mutable_cpu_data());
+      } else if (cpu_engine == DIRECT) {
+        direct_conv_cpu(bottom_data + n * this->bottom_dim_, channels, height,
+            width, kernel_shape_data[0], kernel_shape_data[1], pad_data[0],
+            pad_data[1], weight, this->num_output_,
+            top_data + n * this->top_dim_);
+      } else {
+        this->forward_cpu_gemm(bottom_data + n * this->bottom_dim_, weight,
+            top_data + n * this->top_dim_);
       }
+      forward_cpu_bias_relu(top_data + n * this->top_dim_,
+          this->bias_term_ ? this->blobs_[1]->cpu_data() : NULL);
+    }
+  }
+}
+
+template <typename Dtype>
+void ConvolutionLayer<Dtype>::share_winograd_weights(const Dtype* weight) {
+  boost::mutex::scoped_lock lock(transformed_weights_mutex);
+  const TransformedWeightsKey key(weight, vector<float>());
+  winograd_weights_ = find_transformed_weights<Blob<Dtype> >(key);
+  if (!winograd_weights_) {
+    shared_ptr<Blob<Dtype> > winograd_weights(
+        new Blob<Dtype>(1, 36, this->num_output_, this->channels_));
+    winograd_f4x4_3x3_weights_cpu(weight, this->num_output_, this->channels_,
+        winograd_weights->mutable_cpu_data());
+    transformed_weights_cache<Blob<Dtype> >()[key] = winograd_weights;
+    winograd_weights_ = winograd_weights;
+  }
+  winograd_weights_source_ = weight;
+}
+
+template <typename Dtype>
+void ConvolutionLayer<Dtype>::share_int8_weights(const Dtype* weight,
+      const int padded_k) {
+  const bool has_scales = !int8_weight_scales_.empty();
+  if (has_scales) {
+    CHECK_EQ(int8_weight_scales_.size(), this->num_output_)
+        << "Convolution " << this->layer_param_.name()
+        << " needs one int8_weight_scale per output channel.";
+  }
+  boost::mutex::scoped_lock lock(transformed_weights_mutex);
+  const TransformedWeightsKey key(weight, int8_weight_scales_);
+  int8_weights_ = find_transformed_weights<Int8Weights>(key);
+  if (!int8_weights_) {
+    shared_ptr<Int8Weights> int8_weights(new Int8Weights());
+    int8_weights->row_scales = int8_weight_scales_;
+    int8_weights->row_scales.resize(this->num_output_);
+    int8_weights->weights.resize(this->num_output_ * padded_k);
+    int8_weights->row_sums.resize(this->num_output_);
+    int8_quantize_weights_cpu(weight, this->num_output_,
+        this->blobs_[0]->count(1),
+        has_scales ? &int8_weight_scales_[0] : NULL,
+        &int8_weights->row_scales[0], &int8_weights->weights[0],
+        &int8_weights->row_sums[0]);
+    transformed_weights_cache<Int8Weights>()[key] = int8_weights;
+    int8_weights_ = int8_weights;
+  }
+  int8_weights_source_ = weight;
+}
+
+template <typename Dtype>
+void ConvolutionLayer<Dtype>::forward_cpu_int8(const Dtype* input,
+      const int padded_k, Dtype* output) {
+  const int* kernel_shape_data = this->kernel_shape_.cpu_data();
+  const int* stride_data = this->stride_.cpu_data();
+  const int* pad_data = this->pad_.cpu_data();
+  const int* dilation_data = this->dilation_.cpu_data();
+  int8_quantize_cpu(this->bottom_dim_, input, int8_input_scale_,
+      &int8_input_[0]);
+  int8_im2row_cpu(&int8_input_[0], this->channels_, this->input_shape(1),
+      this->input_shape(2), kernel_shape_data[0], kernel_shape_data[1],
+      pad_data[0], pad_data[1], stride_data[0], stride_data[1],
+      dilation_data[0], dilation_data[1], padded_k, &int8_rows_[0]);
+  int8_gemm_cpu(this->num_output_, this->out_spatial_dim_, padded_k,
+      &int8_weights_->weights[0], &int8_weights_->row_sums[0], &int8_rows_[0],
+      &int8_output_[0]);
+  // Dequantization
+  const int spatial_dim = this->out_spatial_dim_;
+  CAFFE_PARALLEL_FOR(this->num_output_ * spatial_dim)
+  for (int c = 0; c < this->num_output_; ++c) {
+    const Dtype scale = Dtype(int8_input_scale_)
+        * int8_weights_->row_scales[c];
+    const int* output_int32 = &int8_output_[c * spatial_dim];
+    Dtype* output_c = output + c * spatial_dim;
+    for (int i = 0; i < spatial_dim; ++i) {
+      output_c[i] = scale * output_int32[i];
+    }
+  }
+}
+
+template <typename Dtype>
+void ConvolutionLayer<Dtype>::forward_cpu_bias_relu(Dtype* output,
+      const Dtype* bias) {
+  if (!fused_relu_) {
+    if (bias) {
+      this->forward_cpu_bias(output, bias);
+    }
+    return;
+  }
+  // Single pass over the output for both the bias and the ReLU
+  const int spatial_dim = this->out_spatial_dim_;
+  const Dtype negative_slope = fused_relu_negative_slope_;
+  CAFFE_PARALLEL_FOR(this->num_output_ * spatial_dim)
+  for (int c = 0; c < this->num_output_; ++c) {
+    const Dtype bias_c = (bias ? bias[c] : Dtype(0));
+    Dtype* output_c = output + c * spatial_dim;
+    for (int i = 0; i < spatial_dim; ++i) {
+      const Dtype value = output_c[i] + bias_c;
+      output_c[i] = std::max(value, Dtype(0))
+          + negative_slope * std::min(value, Dtype(0));
+    }
+  }
+}
+
+template <typename Dtype>
+void ConvolutionLayer<Dtype>::select_cpu_engine(
+      const vector<Blob<Dtype>*>& bottom, const vector<Blob<Dtype>*>& top) {
+  const char* engine_names[] = {"AUTO", "GEMM", "Winograd", "direct", "INT8"};
+  vector<CpuEngine> candidates;
+  if (is_cpu_engine_eligible(WINOGRAD)) {
+    candidates.push_back(WINOGRAD);
+  }
+  if (is_cpu_engine_eligible(DIRECT)) {
+    candidates.push_back(DIRECT);
+  }
+  if (is_cpu_engine_eligible(INT8)) {
+    candidates.push_back(INT8);
+  }
+  cpu_engine_ = GEMM;
+  if (candidates.empty()) {
+    return;
+  }
+  // Reference: GEMM output and time (second run, the first one allocates)
+  CPUTimer timer;
+  forward_cpu_engine(GEMM, bottom, top);
+  timer.Start();
+  forward_cpu_engine(GEMM, bottom, top);
+  const double gemm_ms = timer.MicroSeconds() / 1000.;
+  Blob<Dtype> reference;
+  reference.CopyFrom(*top[0], false, true);
+  const Dtype* reference_data = reference.cpu_data();
+  Dtype reference_max = 0;
+  for (int i = 0; i < reference.count(); ++i) {
+    reference_max = std::max(reference_max, std::abs(reference_data[i]));
+  }
+  std::ostringstream report;
+  report << "Convolution " << this->layer_param_.name() << " ("
+         << top[0]->shape_string() << "): GEMM " << gemm_ms << " ms";
+  double best_ms = gemm_ms;
+  for (int c = 0; c < candidates.size(); ++c) {
+    forward_cpu_engine(candidates[c], bottom, top);
+    timer.Start();
+    forward_cpu_engine(candidates[c], bottom, top);
+    const double candidate_ms = timer.MicroSeconds() / 1000.;
+    const Dtype* top_data = top[0]->cpu_data();
+    Dtype max_difference = 0;
+    for (int i = 0; i < reference.count(); ++i) {
+      max_difference = std::max(max_difference,
+          std::abs(top_data[i] - reference_data[i]));
+    }
+    // INT8 also has the quantization error of the input
+    const Dtype tolerance = (candidates[c] == INT8 ? Dtype(5e-2) : Dtype(1e-3));
+    const bool matches = (max_difference <= tolerance * reference_max);
+    report << ", " << engine_names[candidates[c]];
+    if (candidates[c] == INT8) {
+      report << " (" << int8_gemm_isa() << ")";
     }
+    report << " " << candidate_ms
+           << " ms (" << gemm_ms / std::max(candidate_ms, 1e-3)
+           << "x, max difference "
+           << max_difference << (matches ? ")" : ", rejected)");
+    if (matches && candidate_ms < best_ms) {
+      best_ms = candidate_ms;
+      cpu_engine_ = candidates[c];
+    }
+  }
+  report << " -> " << engine_names[cpu_engine_];
+  LOG(INFO) << report.str();
+  // Memory of the engines not selected
+  if (cpu_engine_ != WINOGRAD) {
+    winograd_weights_.reset();
+    winograd_weights_source_ = NULL;
+  }
+  if (cpu_engine_ != INT8) {
+    int8_weights_.reset();
+    int8_weights_source_ = NULL;
+    vector<int8_t>().swap(int8_input_);
+    vector<int8_t>().swap(int8_rows_);
+    vector<int>().swap(int8_output_);
+  }
+}
+
+template <typename Dtype>
+void ConvolutionLayer<Dtype>::Forward_cpu(const vector<Blob<Dtype>*>& bottom,
+      const vector<Blob<Dtype>*>& top) {
+  if (cpu_engine_ == AUTO) {
+    select_cpu_engine(bottom, top);
   }
+  forward_cpu_engine(is_cpu_engine_eligible(cpu_engine_) ? cpu_engine_ : GEMM,
+      bottom, top);
 }
 
 template <typename Dtype>
 void ConvolutionLayer<Dtype>::Backward_cpu(const vector<Blob<Dtype>*>& top,
       const vector<bool>& propagate_down, const vector<Blob<Dtype>*>& bottom) {
+  CHECK(!fused_relu_) << "Convolution " << this->layer_param_.name()
+      << " has a fused ReLU and cannot be backpropagated.";
   const Dtype* weight = this->blobs_[0]->cpu_data();
   Dtype* weight_diff = this->blobs_[0]->mutable_cpu_diff();
   for (int i = 0; i < top.size(); ++i) {
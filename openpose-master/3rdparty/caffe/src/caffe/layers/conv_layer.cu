@@ -4,6 +4,42 @@
 
 namespace caffe {
 
+template <typename Dtype>
+__global__ void BiasReLUForward(const int n, Dtype* output, const Dtype* bias,
+    const int channels, const int spatial_dim, const Dtype negative_slope) {
+  CUDA_KERNEL_LOOP(index, n) {
+    Dtype value = output[index];
+    if (bias) {
+      value += bias[(index / spatial_dim) % channels];
+    }
+    output[index] = (value > 0 ? value : value * negative_slope);
+  }
+}
+
+template <typename Dtype>
+void ConvolutionLayer<Dtype>::forward_gpu_bias_relu(Dtype* output,
+      const Dtype* bias, int num) {
+  if (!fused_relu_) {
+    if (bias) {
+      for (int n = 0; n < num; ++n) {
+        this->forward_gpu_bias(output + n * this->top_dim_, bias);
+      }
+    }
+    return;
+  }
+  // Single pass over the output for both the bias and the ReLU
+  const int count = num * this->top_dim_;
+  // NOLINT_NEXT_LINE(whitespace/operators)
+  BiasReLUForward<Dtype><<<CAFFE_GET_BLOCKS(count), CAFFE_CUDA_NUM_THREADS>>>(
+      count, output, bias, this->num_output_, this->out_spatial_dim_,
+      fused_relu_negative_slope_);
+  CUDA_POST_KERNEL_CHECK;
+}
+template void ConvolutionLayer<float>::forward_gpu_bias_relu(float* output,
+    const float* bias, int num);
+template void ConvolutionLayer<double>::forward_gpu_bias_relu(double* output,
+    const double* bias, int num);
+
 template <typename Dtype>
 void ConvolutionLayer<Dtype>::Forward_gpu(const vector<Blob<Dtype>*>& bottom,
       const vector<Blob<Dtype>*>& top) {
@@ -14,10 +50,8 @@ void ConvolutionLayer<Dtype>::Forward_gpu(const vector<Blob<Dtype>*>& bottom,
     for (int n = 0; n < this->num_; ++n) {
       this->forward_gpu_gemm(bottom_data + n * this->bottom_dim_, weight,
           top_data + n * this->top_dim_);
-      if (this->bias_term_) {
-        const Dtype* bias = this->blobs_[1]->gpu_data();
-        this->forward_gpu_bias(top_data + n * this->top_dim_, bias);
-      }
+      forward_gpu_bias_relu(top_data + n * this->top_dim_,
+          this->bias_term_ ? this->blobs_[1]->gpu_data() : NULL);
     }
   }
 }
@@ -25,6 +59,8 @@ void ConvolutionLayer<Dtype>::Forward_gpu(const vector<Blob<Dtype>*>& bottom,
 template <typename Dtype>
 void ConvolutionLayer<Dtype>::Backward_gpu(const vector<Blob<Dtype>*>& top,
       const vector<bool>& propagate_down, const vector<Blob<Dtype>*>& bottom) {
+  CHECK(!fused_relu_) << "Convolution " << this->layer_param_.name()
+      << " has a fused ReLU and cannot be backpropagated.";
   const Dtype* weight = this->blobs_[0]->gpu_data();
   Dtype* weight_diff = this->blobs_[0]->mutable_gpu_diff();
   for (int i = 0; i < top.size(); ++i) {
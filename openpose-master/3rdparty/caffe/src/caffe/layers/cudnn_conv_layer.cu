@@ -27,8 +27,8 @@ void CuDNNConvolutionLayer<Dtype>::Forward_gpu(
             cudnn::dataType<Dtype>::zero,
             top_descs_[i], top_data + top_offset_ * g));
 
-      // Bias.
-      if (this->bias_term_) {
+      // Bias (with the ReLU below if fused).
+      if (this->bias_term_ && !this->fused_relu_) {
         const Dtype* bias_data = this->blobs_[1]->gpu_data();
         CUDNN_CHECK(cudnnAddTensor(handle_[g],
               cudnn::dataType<Dtype>::one,
@@ -42,12 +42,19 @@ void CuDNNConvolutionLayer<Dtype>::Forward_gpu(
     // stream, by launching an empty kernel into the default (null) stream.
     // NOLINT_NEXT_LINE(whitespace/operators)
     sync_conv_groups<<<1, 1>>>();
+
+    if (this->fused_relu_) {
+      this->forward_gpu_bias_relu(top_data,
+          this->bias_term_ ? this->blobs_[1]->gpu_data() : NULL, this->num_);
+    }
   }
 }
 
 template <typename Dtype>
 void CuDNNConvolutionLayer<Dtype>::Backward_gpu(const vector<Blob<Dtype>*>& top,
     const vector<bool>& propagate_down, const vector<Blob<Dtype>*>& bottom) {
+  CHECK(!this->fused_relu_) << "Convolution " << this->layer_param_.name()
+      << " has a fused ReLU and cannot be backpropagated.";
   const Dtype* weight = NULL;
   Dtype* weight_diff = NULL;
   if (this->param_propagate_down_[0]) {
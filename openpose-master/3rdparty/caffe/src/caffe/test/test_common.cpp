@@ -27,6 +27,14 @@ TEST_F(CommonTest, TestBrewMode) {
   EXPECT_EQ(Caffe::mode(), Caffe::GPU);
 }
 
+TEST_F(CommonTest, TestCpuThreads) {
+  EXPECT_EQ(Caffe::cpu_threads(), 0);
+  Caffe::set_cpu_threads(2);
+  EXPECT_EQ(Caffe::cpu_threads(), 2);
+  Caffe::set_cpu_threads(0);
+  EXPECT_EQ(Caffe::cpu_threads(), 0);
+}
+
 TEST_F(CommonTest, TestRandSeedCPU) {
   SyncedMemory data_a(10 * sizeof(int));
   SyncedMemory data_b(10 * sizeof(int));
@@ -166,6 +166,52 @@ TYPED_TEST(ConcatLayerTest, TestForwardChannels) {
   }
 }
 
+TYPED_TEST(ConcatLayerTest, TestForwardInPlaceBottoms) {
+  typedef typename TypeParam::Dtype Dtype;
+  LayerParameter layer_param;
+  layer_param.mutable_concat_param()->add_in_place_bottom(true);
+  layer_param.mutable_concat_param()->add_in_place_bottom(false);
+  ConcatLayer<Dtype> layer(layer_param);
+  // A single concatenation: bottom 0 points into the top
+  this->blob_bottom_0_->Reshape(1, 3, 6, 5);
+  this->blob_bottom_1_->Reshape(1, 5, 6, 5);
+  layer.SetUp(this->blob_bottom_vec_0_, this->blob_top_vec_);
+  EXPECT_TRUE(layer.is_in_place_bottom(0));
+  EXPECT_FALSE(layer.is_in_place_bottom(1));
+  FillerParameter filler_param;
+  GaussianFiller<Dtype> filler(filler_param);
+  filler.Fill(this->blob_bottom_0_);
+  filler.Fill(this->blob_bottom_1_);
+  layer.Forward(this->blob_bottom_vec_0_, this->blob_top_vec_);
+  for (int c = 0; c < 8; ++c) {
+    for (int h = 0; h < this->blob_top_->height(); ++h) {
+      for (int w = 0; w < this->blob_top_->width(); ++w) {
+        EXPECT_EQ(this->blob_top_->data_at(0, c, h, w), c < 3
+            ? this->blob_bottom_0_->data_at(0, c, h, w)
+            : this->blob_bottom_1_->data_at(0, c - 3, h, w));
+      }
+    }
+  }
+  // Several concatenations: bottom 0 gets its own memory back
+  this->blob_bottom_0_->Reshape(2, 3, 6, 5);
+  this->blob_bottom_1_->Reshape(2, 5, 6, 5);
+  layer.Reshape(this->blob_bottom_vec_0_, this->blob_top_vec_);
+  EXPECT_FALSE(layer.is_in_place_bottom(0));
+  filler.Fill(this->blob_bottom_0_);
+  filler.Fill(this->blob_bottom_1_);
+  layer.Forward(this->blob_bottom_vec_0_, this->blob_top_vec_);
+  for (int n = 0; n < 2; ++n) {
+    for (int c = 0; c < 3; ++c) {
+      for (int h = 0; h < this->blob_top_->height(); ++h) {
+        for (int w = 0; w < this->blob_top_->width(); ++w) {
+          EXPECT_EQ(this->blob_top_->data_at(n, c, h, w),
+              this->blob_bottom_0_->data_at(n, c, h, w));
+        }
+      }
+    }
+  }
+}
+
 TYPED_TEST(ConcatLayerTest, TestGradientTrivial) {
   typedef typename TypeParam::Dtype Dtype;
   LayerParameter layer_param;
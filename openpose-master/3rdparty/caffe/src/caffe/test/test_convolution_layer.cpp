@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -467,6 +469,240 @@ TYPED_TEST(ConvolutionLayerTest, Test1x1Convolution) {
   }
 }
 
+TYPED_TEST(ConvolutionLayerTest, TestWinogradConvolution) {
+  typedef typename TypeParam::Dtype Dtype;
+  // Enough 4x4 output tiles for several Winograd tile blocks
+  vector<int> bottom_shape;
+  bottom_shape.push_back(2);
+  bottom_shape.push_back(3);
+  bottom_shape.push_back(70);
+  bottom_shape.push_back(66);
+  this->blob_bottom_->Reshape(bottom_shape);
+  FillerParameter filler_param;
+  GaussianFiller<Dtype> filler(filler_param);
+  filler.Fill(this->blob_bottom_);
+  LayerParameter layer_param;
+  layer_param.set_phase(TEST);
+  ConvolutionParameter* convolution_param =
+      layer_param.mutable_convolution_param();
+  convolution_param->add_kernel_size(3);
+  convolution_param->add_pad(1);
+  convolution_param->set_num_output(5);
+  convolution_param->mutable_weight_filler()->set_type("gaussian");
+  convolution_param->mutable_bias_filler()->set_type("constant");
+  convolution_param->mutable_bias_filler()->set_value(0.1);
+  ConvolutionLayer<Dtype> layer(layer_param);
+  layer.set_cpu_engine(ConvolutionLayer<Dtype>::WINOGRAD);
+  layer.SetUp(this->blob_bottom_vec_, this->blob_top_vec_);
+  layer.Forward(this->blob_bottom_vec_, this->blob_top_vec_);
+  // Check against reference convolution.
+  caffe_conv(this->blob_bottom_, convolution_param, layer.blobs(),
+      this->MakeReferenceTop(this->blob_top_));
+  const Dtype* top_data = this->blob_top_->cpu_data();
+  const Dtype* ref_top_data = this->ref_blob_top_->cpu_data();
+  for (int i = 0; i < this->blob_top_->count(); ++i) {
+    EXPECT_NEAR(top_data[i], ref_top_data[i], 1e-3);
+  }
+}
+
+TYPED_TEST(ConvolutionLayerTest, TestSharedWinogradWeights) {
+  typedef typename TypeParam::Dtype Dtype;
+  LayerParameter layer_param;
+  layer_param.set_phase(TEST);
+  ConvolutionParameter* convolution_param =
+      layer_param.mutable_convolution_param();
+  convolution_param->add_kernel_size(3);
+  convolution_param->add_pad(1);
+  convolution_param->set_num_output(5);
+  convolution_param->mutable_weight_filler()->set_type("gaussian");
+  convolution_param->mutable_bias_filler()->set_type("gaussian");
+  // Second layer sharing the weights of the first one (and so its
+  // Winograd-domain weights), with other weights before the sharing
+  ConvolutionLayer<Dtype> layer(layer_param);
+  layer.set_cpu_engine(ConvolutionLayer<Dtype>::WINOGRAD);
+  layer.SetUp(this->blob_bottom_vec_, this->blob_top_vec_);
+  layer.Forward(this->blob_bottom_vec_, this->blob_top_vec_);
+  ConvolutionLayer<Dtype> shared_layer(layer_param);
+  shared_layer.set_cpu_engine(ConvolutionLayer<Dtype>::WINOGRAD);
+  vector<Blob<Dtype>*> top_vec(1, this->blob_top_2_);
+  shared_layer.SetUp(this->blob_bottom_vec_, top_vec);
+  shared_layer.Forward(this->blob_bottom_vec_, top_vec);
+  for (int i = 0; i < layer.blobs().size(); ++i) {
+    shared_layer.blobs()[i]->ShareData(*layer.blobs()[i]);
+  }
+  shared_layer.Forward(this->blob_bottom_vec_, top_vec);
+  // Check against reference convolution.
+  caffe_conv(this->blob_bottom_, convolution_param, layer.blobs(),
+      this->MakeReferenceTop(this->blob_top_));
+  const Dtype* top_data = this->blob_top_->cpu_data();
+  const Dtype* shared_top_data = this->blob_top_2_->cpu_data();
+  const Dtype* ref_top_data = this->ref_blob_top_->cpu_data();
+  for (int i = 0; i < this->blob_top_->count(); ++i) {
+    EXPECT_NEAR(top_data[i], ref_top_data[i], 1e-3);
+    EXPECT_NEAR(shared_top_data[i], ref_top_data[i], 1e-3);
+  }
+}
+
+TYPED_TEST(ConvolutionLayerTest, TestDirectConvolution) {
+  typedef typename TypeParam::Dtype Dtype;
+  LayerParameter layer_param;
+  layer_param.set_phase(TEST);
+  ConvolutionParameter* convolution_param =
+      layer_param.mutable_convolution_param();
+  convolution_param->set_kernel_h(5);
+  convolution_param->set_kernel_w(3);
+  convolution_param->set_pad_h(2);
+  convolution_param->set_pad_w(0);
+  convolution_param->set_num_output(11);
+  convolution_param->mutable_weight_filler()->set_type("gaussian");
+  convolution_param->mutable_bias_filler()->set_type("constant");
+  convolution_param->mutable_bias_filler()->set_value(0.1);
+  ConvolutionLayer<Dtype> layer(layer_param);
+  layer.set_cpu_engine(ConvolutionLayer<Dtype>::DIRECT);
+  layer.SetUp(this->blob_bottom_vec_, this->blob_top_vec_);
+  layer.Forward(this->blob_bottom_vec_, this->blob_top_vec_);
+  // Check against reference convolution.
+  caffe_conv(this->blob_bottom_, convolution_param, layer.blobs(),
+      this->MakeReferenceTop(this->blob_top_));
+  const Dtype* top_data = this->blob_top_->cpu_data();
+  const Dtype* ref_top_data = this->ref_blob_top_->cpu_data();
+  for (int i = 0; i < this->blob_top_->count(); ++i) {
+    EXPECT_NEAR(top_data[i], ref_top_data[i], 1e-4);
+  }
+}
+
+TYPED_TEST(ConvolutionLayerTest, TestAutoCpuEngineConvolution) {
+  typedef typename TypeParam::Dtype Dtype;
+  this->blob_bottom_vec_.push_back(this->blob_bottom_2_);
+  this->blob_top_vec_.push_back(this->blob_top_2_);
+  LayerParameter layer_param;
+  layer_param.set_phase(TEST);
+  ConvolutionParameter* convolution_param =
+      layer_param.mutable_convolution_param();
+  convolution_param->add_kernel_size(3);
+  convolution_param->add_pad(1);
+  convolution_param->set_num_output(4);
+  convolution_param->mutable_weight_filler()->set_type("gaussian");
+  convolution_param->mutable_bias_filler()->set_type("constant");
+  convolution_param->mutable_bias_filler()->set_value(0.1);
+  ConvolutionLayer<Dtype> layer(layer_param);
+  layer.SetUp(this->blob_bottom_vec_, this->blob_top_vec_);
+  layer.Forward(this->blob_bottom_vec_, this->blob_top_vec_);
+  if (Caffe::mode() == Caffe::CPU) {
+    EXPECT_NE(ConvolutionLayer<Dtype>::AUTO, layer.cpu_engine());
+  }
+  // Check against reference convolution.
+  const Dtype* top_data;
+  const Dtype* ref_top_data;
+  caffe_conv(this->blob_bottom_, convolution_param, layer.blobs(),
+      this->MakeReferenceTop(this->blob_top_));
+  top_data = this->blob_top_->cpu_data();
+  ref_top_data = this->ref_blob_top_->cpu_data();
+  for (int i = 0; i < this->blob_top_->count(); ++i) {
+    EXPECT_NEAR(top_data[i], ref_top_data[i], 1e-3);
+  }
+  caffe_conv(this->blob_bottom_2_, convolution_param, layer.blobs(),
+      this->MakeReferenceTop(this->blob_top_2_));
+  top_data = this->blob_top_2_->cpu_data();
+  ref_top_data = this->ref_blob_top_->cpu_data();
+  for (int i = 0; i < this->blob_top_2_->count(); ++i) {
+    EXPECT_NEAR(top_data[i], ref_top_data[i], 1e-3);
+  }
+}
+
+TYPED_TEST(ConvolutionLayerTest, TestFusedReLUConvolution) {
+  typedef typename TypeParam::Dtype Dtype;
+  LayerParameter layer_param;
+  layer_param.set_phase(TEST);
+  ConvolutionParameter* convolution_param =
+      layer_param.mutable_convolution_param();
+  convolution_param->add_kernel_size(3);
+  convolution_param->add_stride(2);
+  convolution_param->set_num_output(4);
+  convolution_param->mutable_weight_filler()->set_type("gaussian");
+  convolution_param->mutable_bias_filler()->set_type("gaussian");
+  convolution_param->set_fused_relu(true);
+  convolution_param->set_fused_relu_negative_slope(0.25);
+  ConvolutionLayer<Dtype> layer(layer_param);
+  layer.SetUp(this->blob_bottom_vec_, this->blob_top_vec_);
+  layer.Forward(this->blob_bottom_vec_, this->blob_top_vec_);
+  // Check against reference convolution followed by a leaky ReLU.
+  caffe_conv(this->blob_bottom_, convolution_param, layer.blobs(),
+      this->MakeReferenceTop(this->blob_top_));
+  const Dtype* top_data = this->blob_top_->cpu_data();
+  const Dtype* ref_top_data = this->ref_blob_top_->cpu_data();
+  for (int i = 0; i < this->blob_top_->count(); ++i) {
+    const Dtype ref_value = (ref_top_data[i] > 0 ? ref_top_data[i]
+        : Dtype(0.25) * ref_top_data[i]);
+    EXPECT_NEAR(top_data[i], ref_value, 1e-4);
+  }
+}
+
+TYPED_TEST(ConvolutionLayerTest, TestInt8Convolution) {
+  typedef typename TypeParam::Dtype Dtype;
+  LayerParameter layer_param;
+  layer_param.set_phase(TEST);
+  ConvolutionParameter* convolution_param =
+      layer_param.mutable_convolution_param();
+  convolution_param->add_kernel_size(3);
+  convolution_param->add_stride(2);
+  convolution_param->add_pad(1);
+  convolution_param->set_num_output(4);
+  convolution_param->mutable_weight_filler()->set_type("gaussian");
+  convolution_param->mutable_bias_filler()->set_type("gaussian");
+  const Dtype* bottom_data = this->blob_bottom_->cpu_data();
+  Dtype bottom_max = 0;
+  for (int i = 0; i < this->blob_bottom_->count(); ++i) {
+    bottom_max = std::max(bottom_max, std::abs(bottom_data[i]));
+  }
+  convolution_param->set_int8_input_scale(bottom_max / 127);
+  ConvolutionLayer<Dtype> layer(layer_param);
+  layer.set_cpu_engine(ConvolutionLayer<Dtype>::INT8);
+  layer.SetUp(this->blob_bottom_vec_, this->blob_top_vec_);
+  layer.Forward(this->blob_bottom_vec_, this->blob_top_vec_);
+  // Check against reference convolution, up to the quantization error.
+  caffe_conv(this->blob_bottom_, convolution_param, layer.blobs(),
+      this->MakeReferenceTop(this->blob_top_));
+  const Dtype* top_data = this->blob_top_->cpu_data();
+  const Dtype* ref_top_data = this->ref_blob_top_->cpu_data();
+  Dtype ref_max = 0;
+  for (int i = 0; i < this->blob_top_->count(); ++i) {
+    ref_max = std::max(ref_max, std::abs(ref_top_data[i]));
+  }
+  for (int i = 0; i < this->blob_top_->count(); ++i) {
+    EXPECT_NEAR(top_data[i], ref_top_data[i], 2e-2 * ref_max);
+  }
+  // Explicit per-channel weight scales give the same quantization.
+  const Blob<Dtype>& weights = *layer.blobs()[0];
+  vector<float> weight_scales(4);
+  for (int c = 0; c < 4; ++c) {
+    Dtype weight_max = 0;
+    for (int i = 0; i < weights.count(1); ++i) {
+      weight_max = std::max(weight_max,
+          std::abs(weights.cpu_data()[c * weights.count(1) + i]));
+    }
+    weight_scales[c] = weight_max / 127;
+  }
+  Blob<Dtype> top_computed_scales;
+  top_computed_scales.CopyFrom(*this->blob_top_, false, true);
+  layer.set_int8_scales(bottom_max / 127, weight_scales);
+  layer.set_cpu_engine(ConvolutionLayer<Dtype>::INT8);
+  layer.Forward(this->blob_bottom_vec_, this->blob_top_vec_);
+  for (int i = 0; i < this->blob_top_->count(); ++i) {
+    EXPECT_NEAR(this->blob_top_->cpu_data()[i],
+        top_computed_scales.cpu_data()[i], 1e-4);
+  }
+  // The AUTO CPU engine only keeps INT8 if it is accurate enough.
+  layer.set_int8_scales(bottom_max / 127, weight_scales);
+  layer.Forward(this->blob_bottom_vec_, this->blob_top_vec_);
+  if (Caffe::mode() == Caffe::CPU) {
+    EXPECT_NE(layer.cpu_engine(), ConvolutionLayer<Dtype>::AUTO);
+  }
+  for (int i = 0; i < this->blob_top_->count(); ++i) {
+    EXPECT_NEAR(top_data[i], ref_top_data[i], 5e-2 * ref_max);
+  }
+}
+
 TYPED_TEST(ConvolutionLayerTest, TestSimpleConvolutionGroup) {
   typedef typename TypeParam::Dtype Dtype;
   LayerParameter layer_param;
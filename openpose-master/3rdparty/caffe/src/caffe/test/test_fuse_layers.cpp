@@ -0,0 +1,145 @@
+#include <string>
+
+#include "google/protobuf/text_format.h"
+#include "gtest/gtest.h"
+
+#include "caffe/common.hpp"
+#include "caffe/proto/caffe.pb.h"
+#include "caffe/util/fuse_layers.hpp"
+
+#include "caffe/test/test_caffe_main.hpp"
+
+namespace caffe {
+
+class FuseLayersTest : public ::testing::Test {
+ protected:
+  void RunFusionTest(
+      const string& input_param_string, const string& output_param_string) {
+    // Test that FuseLayersForInference called on the proto specified by
+    // input_param_string results in the proto specified by
+    // output_param_string.
+    NetParameter input_param;
+    CHECK(google::protobuf::TextFormat::ParseFromString(
+        input_param_string, &input_param));
+    NetParameter expected_output_param;
+    CHECK(google::protobuf::TextFormat::ParseFromString(
+        output_param_string, &expected_output_param));
+    NetParameter actual_output_param;
+    FuseLayersForInference(input_param, &actual_output_param);
+    EXPECT_EQ(expected_output_param.DebugString(),
+        actual_output_param.DebugString());
+    // Also test idempotence.
+    NetParameter double_fused_param;
+    FuseLayersForInference(actual_output_param, &double_fused_param);
+    EXPECT_EQ(actual_output_param.DebugString(),
+       double_fused_param.DebugString());
+  }
+};
+
+TEST_F(FuseLayersTest, TestFuseInPlaceReLU) {
+  const string& input_proto =
+      "name: 'TestNetwork' "
+      "layer { name: 'data' type: 'Input' top: 'data' } "
+      "layer { name: 'conv' type: 'Convolution' bottom: 'data' top: 'conv' } "
+      "layer { name: 'relu' type: 'ReLU' bottom: 'conv' top: 'conv' "
+      "        relu_param { negative_slope: 0.1 } } "
+      "layer { name: 'pool' type: 'Pooling' bottom: 'conv' top: 'pool' } ";
+  const string& expected_output_proto =
+      "name: 'TestNetwork' "
+      "layer { name: 'data' type: 'Input' top: 'data' } "
+      "layer { name: 'conv' type: 'Convolution' bottom: 'data' top: 'conv' "
+      "        convolution_param { fused_relu: true "
+      "                            fused_relu_negative_slope: 0.1 } } "
+      "layer { name: 'pool' type: 'Pooling' bottom: 'conv' top: 'pool' } ";
+  this->RunFusionTest(input_proto, expected_output_proto);
+}
+
+TEST_F(FuseLayersTest, TestFuseReLU) {
+  const string& input_proto =
+      "name: 'TestNetwork' "
+      "layer { name: 'data' type: 'Input' top: 'data' } "
+      "layer { name: 'conv' type: 'Convolution' bottom: 'data' top: 'conv' } "
+      "layer { name: 'relu' type: 'ReLU' bottom: 'conv' top: 'relu' } "
+      "layer { name: 'pool' type: 'Pooling' bottom: 'relu' top: 'pool' } ";
+  const string& expected_output_proto =
+      "name: 'TestNetwork' "
+      "layer { name: 'data' type: 'Input' top: 'data' } "
+      "layer { name: 'conv' type: 'Convolution' bottom: 'data' top: 'relu' "
+      "        convolution_param { fused_relu: true "
+      "                            fused_relu_negative_slope: 0 } } "
+      "layer { name: 'pool' type: 'Pooling' bottom: 'relu' top: 'pool' } ";
+  this->RunFusionTest(input_proto, expected_output_proto);
+}
+
+TEST_F(FuseLayersTest, TestNoFusionPreReLUReader) {
+  // The pooling layer reads the convolution output before the ReLU
+  const string& input_proto =
+      "name: 'TestNetwork' "
+      "layer { name: 'data' type: 'Input' top: 'data' } "
+      "layer { name: 'conv' type: 'Convolution' bottom: 'data' top: 'conv' } "
+      "layer { name: 'pool' type: 'Pooling' bottom: 'conv' top: 'pool' } "
+      "layer { name: 'relu' type: 'ReLU' bottom: 'conv' top: 'conv' } ";
+  this->RunFusionTest(input_proto, input_proto);
+}
+
+TEST_F(FuseLayersTest, TestNoFusionSharedReLUBottom) {
+  // The pre-ReLU blob is also read by the pooling layer
+  const string& input_proto =
+      "name: 'TestNetwork' "
+      "layer { name: 'data' type: 'Input' top: 'data' } "
+      "layer { name: 'conv' type: 'Convolution' bottom: 'data' top: 'conv' } "
+      "layer { name: 'relu' type: 'ReLU' bottom: 'conv' top: 'relu' } "
+      "layer { name: 'pool' type: 'Pooling' bottom: 'conv' top: 'pool' } ";
+  this->RunFusionTest(input_proto, input_proto);
+}
+
+TEST_F(FuseLayersTest, TestInPlaceConcatBottoms) {
+  // 'conv1' (with an in-place ReLU) and 'conv2' are only read by the Concat,
+  // while 'data_split_1' shares the 'data' memory
+  const string& input_proto =
+      "name: 'TestNetwork' "
+      "layer { name: 'data' type: 'Input' top: 'data' } "
+      "layer { name: 'data_split' type: 'Split' bottom: 'data' "
+      "        top: 'data_split_0' top: 'data_split_1' } "
+      "layer { name: 'conv1' type: 'Convolution' bottom: 'data_split_0' "
+      "        top: 'conv1' } "
+      "layer { name: 'relu1' type: 'ReLU' bottom: 'conv1' top: 'conv1' } "
+      "layer { name: 'conv2' type: 'Convolution' bottom: 'conv1' "
+      "        top: 'conv2' } "
+      "layer { name: 'sigmoid2' type: 'Sigmoid' bottom: 'conv2' "
+      "        top: 'conv2' } "
+      "layer { name: 'concat' type: 'Concat' bottom: 'conv2' "
+      "        bottom: 'data_split_1' top: 'concat' } ";
+  const string& expected_output_proto =
+      "name: 'TestNetwork' "
+      "layer { name: 'data' type: 'Input' top: 'data' } "
+      "layer { name: 'data_split' type: 'Split' bottom: 'data' "
+      "        top: 'data_split_0' top: 'data_split_1' } "
+      "layer { name: 'conv1' type: 'Convolution' bottom: 'data_split_0' "
+      "        top: 'conv1' "
+      "        convolution_param { fused_relu: true "
+      "                            fused_relu_negative_slope: 0 } } "
+      "layer { name: 'conv2' type: 'Convolution' bottom: 'conv1' "
+      "        top: 'conv2' } "
+      "layer { name: 'sigmoid2' type: 'Sigmoid' bottom: 'conv2' "
+      "        top: 'conv2' } "
+      "layer { name: 'concat' type: 'Concat' bottom: 'conv2' "
+      "        bottom: 'data_split_1' top: 'concat' "
+      "        concat_param { in_place_bottom: true "
+      "                       in_place_bottom: false } } ";
+  this->RunFusionTest(input_proto, expected_output_proto);
+}
+
+TEST_F(FuseLayersTest, TestNoInPlaceConcatBottomReadAfter) {
+  // The in-place Sigmoid runs after the Concat, so 'conv' must keep its memory
+  const string& input_proto =
+      "name: 'TestNetwork' "
+      "layer { name: 'data' type: 'Input' top: 'data' top: 'data2' } "
+      "layer { name: 'conv' type: 'Convolution' bottom: 'data' top: 'conv' } "
+      "layer { name: 'concat' type: 'Concat' bottom: 'conv' bottom: 'data2' "
+      "        top: 'concat' } "
+      "layer { name: 'sigmoid' type: 'Sigmoid' bottom: 'conv' top: 'conv' } ";
+  this->RunFusionTest(input_proto, input_proto);
+}
+
+}  // namespace caffe
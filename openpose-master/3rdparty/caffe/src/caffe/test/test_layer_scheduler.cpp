@@ -0,0 +1,140 @@
+#include <string>
+#include <vector>
+
+#include "google/protobuf/text_format.h"
+#include "gtest/gtest.h"
+
+#include "caffe/blob.hpp"
+#include "caffe/common.hpp"
+#include "caffe/filler.hpp"
+#include "caffe/net.hpp"
+#include "caffe/util/layer_scheduler.hpp"
+#include "caffe/util/math_functions.hpp"
+
+#include "caffe/test/test_caffe_main.hpp"
+
+namespace caffe {
+
+template <typename Dtype>
+class LayerSchedulerTest : public CPUDeviceTest<Dtype> {
+ protected:
+  LayerSchedulerTest() : seed_(1701) {}
+
+  // Two branches (with an in-place ReLU) reading the same input, like the L1
+  // and L2 branches of an OpenPose stage, and a Concat of both
+  void InitBranchNet() {
+    const string& proto =
+        "name: 'BranchNetwork' "
+        "state { phase: TEST } "
+        "layer { name: 'data' type: 'Input' top: 'data' "
+        "        input_param { shape { dim: 2 dim: 3 dim: 9 dim: 11 } } } "
+        "layer { name: 'conv_a1' type: 'Convolution' bottom: 'data' "
+        "        top: 'conv_a1' "
+        "        convolution_param { num_output: 4 kernel_size: 3 pad: 1 "
+        "          weight_filler { type: 'gaussian' std: 0.1 } "
+        "          bias_filler { type: 'gaussian' std: 0.1 } } } "
+        "layer { name: 'relu_a1' type: 'ReLU' bottom: 'conv_a1' "
+        "        top: 'conv_a1' } "
+        "layer { name: 'conv_a2' type: 'Convolution' bottom: 'conv_a1' "
+        "        top: 'conv_a2' "
+        "        convolution_param { num_output: 5 kernel_size: 1 "
+        "          weight_filler { type: 'gaussian' std: 0.1 } } } "
+        "layer { name: 'conv_b1' type: 'Convolution' bottom: 'data' "
+        "        top: 'conv_b1' "
+        "        convolution_param { num_output: 2 kernel_size: 3 pad: 1 "
+        "          weight_filler { type: 'gaussian' std: 0.1 } } } "
+        "layer { name: 'concat' type: 'Concat' bottom: 'conv_a2' "
+        "        bottom: 'conv_b1' top: 'concat' } ";
+    NetParameter param;
+    CHECK(google::protobuf::TextFormat::ParseFromString(proto, &param));
+    net_.reset(new Net<Dtype>(param));
+    Caffe::set_random_seed(seed_);
+    FillerParameter filler_param;
+    GaussianFiller<Dtype> filler(filler_param);
+    filler.Fill(net_->input_blobs()[0]);
+  }
+
+  int LayerIndex(const string& layer_name) {
+    const vector<string>& layer_names = net_->layer_names();
+    for (int i = 0; i < layer_names.size(); ++i) {
+      if (layer_names[i] == layer_name) { return i; }
+    }
+    LOG(FATAL) << "Unknown layer " << layer_name;
+    return -1;
+  }
+
+  void ExpectOutputNear(const Blob<Dtype>& expected) {
+    const Blob<Dtype>& output = *net_->blob_by_name("concat");
+    ASSERT_EQ(expected.shape(), output.shape());
+    for (int i = 0; i < expected.count(); ++i) {
+      EXPECT_NEAR(expected.cpu_data()[i], output.cpu_data()[i], 1e-5);
+    }
+  }
+
+  int seed_;
+  shared_ptr<Net<Dtype> > net_;
+};
+
+TYPED_TEST_CASE(LayerSchedulerTest, TestDtypes);
+
+TYPED_TEST(LayerSchedulerTest, TestDependencies) {
+  this->InitBranchNet();
+  LayerScheduler<TypeParam> scheduler(this->net_.get(), 2, 2);
+  const int data = this->LayerIndex("data");
+  const int conv_a1 = this->LayerIndex("conv_a1");
+  const int conv_a2 = this->LayerIndex("conv_a2");
+  const int conv_b1 = this->LayerIndex("conv_b1");
+  const int concat = this->LayerIndex("concat");
+  // Branches
+  EXPECT_TRUE(scheduler.precedes(conv_a1, conv_a2));
+  EXPECT_FALSE(scheduler.precedes(conv_a1, conv_b1));
+  EXPECT_FALSE(scheduler.precedes(conv_b1, conv_a1));
+  EXPECT_FALSE(scheduler.precedes(conv_a2, conv_b1));
+  EXPECT_FALSE(scheduler.precedes(conv_b1, conv_a2));
+  EXPECT_FALSE(scheduler.precedes(conv_a1, conv_a1));
+  // Transitive dependencies
+  EXPECT_TRUE(scheduler.precedes(data, conv_a2));
+  EXPECT_TRUE(scheduler.precedes(data, concat));
+  EXPECT_TRUE(scheduler.precedes(conv_a1, concat));
+  EXPECT_TRUE(scheduler.precedes(conv_b1, concat));
+  EXPECT_FALSE(scheduler.precedes(concat, conv_a1));
+  // Both branches run at the same time with half of the OpenMP threads
+  EXPECT_EQ(1, scheduler.layer_cpu_threads(conv_a1));
+  EXPECT_EQ(1, scheduler.layer_cpu_threads(conv_b1));
+  EXPECT_EQ(2, scheduler.layer_cpu_threads(concat));
+}
+
+TYPED_TEST(LayerSchedulerTest, TestForward) {
+  typedef TypeParam Dtype;
+  this->InitBranchNet();
+  this->net_->Forward();
+  Blob<Dtype> expected;
+  expected.CopyFrom(*this->net_->blob_by_name("concat"), false, true);
+  caffe_set(this->net_->blob_by_name("concat")->count(), Dtype(0),
+      this->net_->blob_by_name("concat")->mutable_cpu_data());
+  for (int num_threads = 1; num_threads <= 4; ++num_threads) {
+    LayerScheduler<Dtype> scheduler(this->net_.get(), num_threads);
+    // Several forward passes reuse the same workers
+    for (int i = 0; i < 3; ++i) {
+      scheduler.Forward();
+      this->ExpectOutputNear(expected);
+    }
+  }
+}
+
+TYPED_TEST(LayerSchedulerTest, TestForwardFromTo) {
+  typedef TypeParam Dtype;
+  this->InitBranchNet();
+  this->net_->Forward();
+  Blob<Dtype> expected;
+  expected.CopyFrom(*this->net_->blob_by_name("concat"), false, true);
+  caffe_set(this->net_->blob_by_name("concat")->count(), Dtype(0),
+      this->net_->blob_by_name("concat")->mutable_cpu_data());
+  LayerScheduler<Dtype> scheduler(this->net_.get(), 3);
+  const int concat = this->LayerIndex("concat");
+  scheduler.ForwardFromTo(0, concat - 1);
+  scheduler.ForwardFromTo(concat, concat);
+  this->ExpectOutputNear(expected);
+}
+
+}  // namespace caffe
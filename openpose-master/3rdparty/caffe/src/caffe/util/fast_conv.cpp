@@ -0,0 +1,234 @@
+#include <algorithm>
+
+#include "caffe/util/fast_conv.hpp"
+#include "caffe/util/math_functions.hpp"
+
+namespace caffe {
+
+// Winograd F(4x4, 3x3) matrices (Lavin & Gray, "Fast Algorithms for
+// Convolutional Neural Networks"): Y = A^T [(G g G^T) .* (B^T d B)] A
+static const double kWinogradG[6][3] = {
+  {1.0 / 4, 0, 0},
+  {-1.0 / 6, -1.0 / 6, -1.0 / 6},
+  {-1.0 / 6, 1.0 / 6, -1.0 / 6},
+  {1.0 / 24, 1.0 / 12, 1.0 / 6},
+  {1.0 / 24, -1.0 / 12, 1.0 / 6},
+  {0, 0, 1}
+};
+
+template <typename Dtype>
+void winograd_f4x4_3x3_weights_cpu(const Dtype* weights, const int num_output,
+    const int channels, Dtype* weights_winograd) {
+  const int matrix_size = num_output * channels;
+  for (int k = 0; k < num_output; ++k) {
+    for (int c = 0; c < channels; ++c) {
+      const Dtype* g = weights + (k * channels + c) * 9;
+      // G g
+      double g_left[6][3];
+      for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 3; ++j) {
+          g_left[i][j] = kWinogradG[i][0] * g[j] + kWinogradG[i][1] * g[3 + j]
+              + kWinogradG[i][2] * g[6 + j];
+        }
+      }
+      // (G g) G^T
+      Dtype* u = weights_winograd + k * channels + c;
+      for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+          u[(i * 6 + j) * matrix_size] = g_left[i][0] * kWinogradG[j][0]
+              + g_left[i][1] * kWinogradG[j][1]
+              + g_left[i][2] * kWinogradG[j][2];
+        }
+      }
+    }
+  }
+}
+
+// v = B^T d B for a 6x6 tile
+template <typename Dtype>
+inline void winograd_input_transform(const Dtype d[6][6], Dtype v[6][6]) {
+  Dtype t[6][6];
+  for (int j = 0; j < 6; ++j) {
+    t[0][j] = 4 * d[0][j] - 5 * d[2][j] + d[4][j];
+    t[1][j] = -4 * (d[1][j] + d[2][j]) + d[3][j] + d[4][j];
+    t[2][j] = 4 * (d[1][j] - d[2][j]) - d[3][j] + d[4][j];
+    t[3][j] = 2 * (d[3][j] - d[1][j]) - d[2][j] + d[4][j];
+    t[4][j] = 2 * (d[1][j] - d[3][j]) - d[2][j] + d[4][j];
+    t[5][j] = 4 * d[1][j] - 5 * d[3][j] + d[5][j];
+  }
+  for (int i = 0; i < 6; ++i) {
+    v[i][0] = 4 * t[i][0] - 5 * t[i][2] + t[i][4];
+    v[i][1] = -4 * (t[i][1] + t[i][2]) + t[i][3] + t[i][4];
+    v[i][2] = 4 * (t[i][1] - t[i][2]) - t[i][3] + t[i][4];
+    v[i][3] = 2 * (t[i][3] - t[i][1]) - t[i][2] + t[i][4];
+    v[i][4] = 2 * (t[i][1] - t[i][3]) - t[i][2] + t[i][4];
+    v[i][5] = 4 * t[i][1] - 5 * t[i][3] + t[i][5];
+  }
+}
+
+// y = A^T m A for a 6x6 tile
+template <typename Dtype>
+inline void winograd_output_transform(const Dtype m[6][6], Dtype y[4][4]) {
+  Dtype t[4][6];
+  for (int j = 0; j < 6; ++j) {
+    t[0][j] = m[0][j] + m[1][j] + m[2][j] + m[3][j] + m[4][j];
+    t[1][j] = m[1][j] - m[2][j] + 2 * (m[3][j] - m[4][j]);
+    t[2][j] = m[1][j] + m[2][j] + 4 * (m[3][j] + m[4][j]);
+    t[3][j] = m[1][j] - m[2][j] + 8 * (m[3][j] - m[4][j]) + m[5][j];
+  }
+  for (int i = 0; i < 4; ++i) {
+    y[i][0] = t[i][0] + t[i][1] + t[i][2] + t[i][3] + t[i][4];
+    y[i][1] = t[i][1] - t[i][2] + 2 * (t[i][3] - t[i][4]);
+    y[i][2] = t[i][1] + t[i][2] + 4 * (t[i][3] + t[i][4]);
+    y[i][3] = t[i][1] - t[i][2] + 8 * (t[i][3] - t[i][4]) + t[i][5];
+  }
+}
+
+template <typename Dtype>
+void winograd_f4x4_3x3_cpu(const Dtype* data_im, const int channels,
+    const int height, const int width, const int pad_h, const int pad_w,
+    const Dtype* weights_winograd, const int num_output, Dtype* data_out,
+    Dtype* workspace) {
+  const int output_h = height + 2 * pad_h - 2;
+  const int output_w = width + 2 * pad_w - 2;
+  const int tiles_w = (output_w + 3) / 4;
+  const int num_tiles = (output_h + 3) / 4 * tiles_w;
+  for (int tile_begin = 0; tile_begin < num_tiles;
+       tile_begin += kWinogradTileBlock) {
+    const int block = std::min(kWinogradTileBlock, num_tiles - tile_begin);
+    // V: 36 x channels x block, M: 36 x num_output x block
+    Dtype* v_block = workspace;
+    Dtype* m_block = workspace + 36 * channels * block;
+    // Input transform
+    CAFFE_PARALLEL_FOR(36 * channels * block)
+    for (int c = 0; c < channels; ++c) {
+      const Dtype* data_channel = data_im + c * height * width;
+      for (int t = 0; t < block; ++t) {
+        const int tile = tile_begin + t;
+        const int y0 = tile / tiles_w * 4 - pad_h;
+        const int x0 = tile % tiles_w * 4 - pad_w;
+        Dtype d[6][6];
+        for (int i = 0; i < 6; ++i) {
+          const int y = y0 + i;
+          for (int j = 0; j < 6; ++j) {
+            const int x = x0 + j;
+            d[i][j] = (y >= 0 && y < height && x >= 0 && x < width)
+                ? data_channel[y * width + x] : Dtype(0);
+          }
+        }
+        Dtype v[6][6];
+        winograd_input_transform(d, v);
+        Dtype* v_tile = v_block + c * block + t;
+        for (int xi = 0; xi < 36; ++xi) {
+          v_tile[xi * channels * block] = v[xi / 6][xi % 6];
+        }
+      }
+    }
+    // Element-wise products summed over channels: one GEMM per position
+    for (int xi = 0; xi < 36; ++xi) {
+      caffe_cpu_gemm<Dtype>(CblasNoTrans, CblasNoTrans, num_output, block,
+          channels, (Dtype)1., weights_winograd + xi * num_output * channels,
+          v_block + xi * channels * block, (Dtype)0.,
+          m_block + xi * num_output * block);
+    }
+    // Output transform
+    CAFFE_PARALLEL_FOR(36 * num_output * block)
+    for (int k = 0; k < num_output; ++k) {
+      Dtype* data_out_channel = data_out + k * output_h * output_w;
+      for (int t = 0; t < block; ++t) {
+        const Dtype* m_tile = m_block + k * block + t;
+        Dtype m[6][6];
+        for (int xi = 0; xi < 36; ++xi) {
+          m[xi / 6][xi % 6] = m_tile[xi * num_output * block];
+        }
+        Dtype y[4][4];
+        winograd_output_transform(m, y);
+        const int tile = tile_begin + t;
+        const int y0 = tile / tiles_w * 4;
+        const int x0 = tile % tiles_w * 4;
+        const int rows = std::min(4, output_h - y0);
+        const int cols = std::min(4, output_w - x0);
+        for (int i = 0; i < rows; ++i) {
+          for (int j = 0; j < cols; ++j) {
+            data_out_channel[(y0 + i) * output_w + x0 + j] = y[i][j];
+          }
+        }
+      }
+    }
+  }
+}
+
+// Output channels and (roughly) output values accumulated together by
+// direct_conv_cpu, so that the output block fits in the L2 cache.
+static const int kDirectOutputBlock = 8;
+static const int kDirectBlockSize = 16384;
+
+template <typename Dtype>
+void direct_conv_cpu(const Dtype* data_im, const int channels,
+    const int height, const int width, const int kernel_h, const int kernel_w,
+    const int pad_h, const int pad_w, const Dtype* weights,
+    const int num_output, Dtype* data_out) {
+  const int output_h = height + 2 * pad_h - kernel_h + 1;
+  const int output_w = width + 2 * pad_w - kernel_w + 1;
+  const int row_block = std::max(1,
+      kDirectBlockSize / (kDirectOutputBlock * output_w));
+  caffe_set(num_output * output_h * output_w, Dtype(0), data_out);
+  CAFFE_PARALLEL_FOR(num_output * output_h * output_w)
+  for (int k_begin = 0; k_begin < num_output;
+       k_begin += kDirectOutputBlock) {
+    const int k_end = std::min(num_output, k_begin + kDirectOutputBlock);
+    for (int row_begin = 0; row_begin < output_h; row_begin += row_block) {
+      const int row_end = std::min(output_h, row_begin + row_block);
+      for (int c = 0; c < channels; ++c) {
+        const Dtype* data_channel = data_im + c * height * width;
+        for (int k = k_begin; k < k_end; ++k) {
+          const Dtype* kernel =
+              weights + (k * channels + c) * kernel_h * kernel_w;
+          Dtype* data_out_channel = data_out + k * output_h * output_w;
+          for (int ky = 0; ky < kernel_h; ++ky) {
+            // Output rows whose input row is inside the image
+            const int y_begin = std::max(row_begin, pad_h - ky);
+            const int y_end = std::min(row_end, height + pad_h - ky);
+            for (int kx = 0; kx < kernel_w; ++kx) {
+              const Dtype weight = kernel[ky * kernel_w + kx];
+              const int x_begin = std::max(0, pad_w - kx);
+              const int x_end = std::min(output_w, width + pad_w - kx);
+              for (int y = y_begin; y < y_end; ++y) {
+                const Dtype* input_row = data_channel
+                    + (y + ky - pad_h) * width + x_begin + kx - pad_w;
+                Dtype* output_row = data_out_channel + y * output_w + x_begin;
+                for (int x = 0; x < x_end - x_begin; ++x) {
+                  output_row[x] += weight * input_row[x];
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Explicit instantiation
+template void winograd_f4x4_3x3_weights_cpu<float>(const float* weights,
+    const int num_output, const int channels, float* weights_winograd);
+template void winograd_f4x4_3x3_weights_cpu<double>(const double* weights,
+    const int num_output, const int channels, double* weights_winograd);
+template void winograd_f4x4_3x3_cpu<float>(const float* data_im,
+    const int channels, const int height, const int width, const int pad_h,
+    const int pad_w, const float* weights_winograd, const int num_output,
+    float* data_out, float* workspace);
+template void winograd_f4x4_3x3_cpu<double>(const double* data_im,
+    const int channels, const int height, const int width, const int pad_h,
+    const int pad_w, const double* weights_winograd, const int num_output,
+    double* data_out, double* workspace);
+template void direct_conv_cpu<float>(const float* data_im, const int channels,
+    const int height, const int width, const int kernel_h, const int kernel_w,
+    const int pad_h, const int pad_w, const float* weights,
+    const int num_output, float* data_out);
+template void direct_conv_cpu<double>(const double* data_im,
+    const int channels, const int height, const int width, const int kernel_h,
+    const int kernel_w, const int pad_h, const int pad_w,
+    const double* weights, const int num_output, double* data_out);
+
+}  // namespace caffe
@@ -0,0 +1,157 @@
+#include <string>
+#include <vector>
+
+#include "caffe/common.hpp"
+#include "caffe/util/fuse_layers.hpp"
+
+namespace caffe {
+
+namespace {
+
+bool HasBottom(const LayerParameter& layer_param, const string& blob_name) {
+  for (int i = 0; i < layer_param.bottom_size(); ++i) {
+    if (layer_param.bottom(i) == blob_name) { return true; }
+  }
+  return false;
+}
+
+bool HasTop(const LayerParameter& layer_param, const string& blob_name) {
+  for (int i = 0; i < layer_param.top_size(); ++i) {
+    if (layer_param.top(i) == blob_name) { return true; }
+  }
+  return false;
+}
+
+// Whether the layer computes blob_name in place (top and bottom at the same
+// index, see Net::AppendTop)
+bool IsInPlace(const LayerParameter& layer_param, const string& blob_name) {
+  for (int i = 0; i < layer_param.top_size(); ++i) {
+    if (layer_param.top(i) == blob_name && i < layer_param.bottom_size()
+        && layer_param.bottom(i) == blob_name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Whether the tops of the layer may share the memory of another blob (bottom
+// or internal) instead of being written by it. Layers without bottoms (net
+// inputs and data layers) are also excluded, as they are filled externally.
+bool MayShareTopData(const LayerParameter& layer_param) {
+  const string& type = layer_param.type();
+  return layer_param.bottom_size() == 0 || type == "Split"
+      || type == "Flatten" || type == "Reshape" || type == "Concat"
+      || (type == "Slice" && layer_param.top_size() == 1) || type == "RNN"
+      || type == "LSTM" || type == "Python";
+}
+
+// Index of the first layer after layer_id that reads blob_name, or -1 if the
+// blob is overwritten (or never read) first
+int NextReader(const NetParameter& param, const vector<bool>& removed,
+    const int layer_id, const string& blob_name) {
+  for (int i = layer_id + 1; i < param.layer_size(); ++i) {
+    if (removed[i]) { continue; }
+    if (HasBottom(param.layer(i), blob_name)) { return i; }
+    if (HasTop(param.layer(i), blob_name)) { return -1; }
+  }
+  return -1;
+}
+
+void FuseConvolutionReLU(NetParameter* param, vector<bool>* removed) {
+  for (int i = 0; i < param->layer_size(); ++i) {
+    LayerParameter* conv_param = param->mutable_layer(i);
+    if (conv_param->type() != "Convolution" || conv_param->top_size() != 1
+        || conv_param->bottom_size() != 1 || conv_param->loss_weight_size()
+        || conv_param->convolution_param().fused_relu()) {
+      continue;
+    }
+    const string blob_name = conv_param->top(0);
+    const int relu_id = NextReader(*param, *removed, i, blob_name);
+    if (relu_id < 0) { continue; }
+    const LayerParameter& relu_param = param->layer(relu_id);
+    if (relu_param.type() != "ReLU" || relu_param.bottom_size() != 1
+        || relu_param.top_size() != 1 || relu_param.loss_weight_size()) {
+      continue;
+    }
+    // Not in place: the pre-ReLU blob must have no other reader
+    const string& relu_top = relu_param.top(0);
+    if (relu_top != blob_name && (relu_top == conv_param->bottom(0)
+        || NextReader(*param, *removed, relu_id, blob_name) >= 0)) {
+      continue;
+    }
+    LOG_IF(INFO, Caffe::root_solver()) << "Fusing " << relu_param.name()
+        << " into " << conv_param->name();
+    ConvolutionParameter* convolution_param =
+        conv_param->mutable_convolution_param();
+    convolution_param->set_fused_relu(true);
+    convolution_param->set_fused_relu_negative_slope(
+        relu_param.relu_param().negative_slope());
+    conv_param->set_top(0, relu_top);
+    (*removed)[relu_id] = true;
+  }
+}
+
+void MarkInPlaceConcatBottoms(NetParameter* param,
+    const vector<bool>& removed) {
+  for (int i = 0; i < param->layer_size(); ++i) {
+    LayerParameter* concat_param = param->mutable_layer(i);
+    if (removed[i] || concat_param->type() != "Concat"
+        || concat_param->bottom_size() < 2) {
+      continue;
+    }
+    vector<bool> in_place(concat_param->bottom_size(), false);
+    bool any_in_place = false;
+    for (int j = 0; j < concat_param->bottom_size(); ++j) {
+      const string& blob_name = concat_param->bottom(j);
+      int num_readers = 0;
+      int producer_id = -1;
+      bool eligible = true;
+      for (int k = 0; k < param->layer_size() && eligible; ++k) {
+        const LayerParameter& layer_param = param->layer(k);
+        if (removed[k]) { continue; }
+        if (k == i) {
+          for (int b = 0; b < layer_param.bottom_size(); ++b) {
+            num_readers += (layer_param.bottom(b) == blob_name);
+          }
+        } else if (IsInPlace(layer_param, blob_name)) {
+          // In-place layers share the Blob, but must run before the Concat
+          eligible = (k < i && producer_id >= 0);
+        } else if (HasBottom(layer_param, blob_name)) {
+          eligible = false;
+        } else if (HasTop(layer_param, blob_name)) {
+          eligible = (producer_id < 0 && k < i
+              && !MayShareTopData(layer_param));
+          producer_id = k;
+        }
+      }
+      in_place[j] = (eligible && producer_id >= 0 && num_readers == 1);
+      any_in_place = any_in_place || in_place[j];
+    }
+    if (any_in_place) {
+      ConcatParameter* concat = concat_param->mutable_concat_param();
+      concat->clear_in_place_bottom();
+      for (int j = 0; j < concat_param->bottom_size(); ++j) {
+        concat->add_in_place_bottom(in_place[j]);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void FuseLayersForInference(const NetParameter& param,
+    NetParameter* param_fused) {
+  NetParameter fused(param);
+  vector<bool> removed(fused.layer_size(), false);
+  FuseConvolutionReLU(&fused, &removed);
+  MarkInPlaceConcatBottoms(&fused, removed);
+  param_fused->CopyFrom(fused);
+  param_fused->clear_layer();
+  for (int i = 0; i < fused.layer_size(); ++i) {
+    if (!removed[i]) {
+      param_fused->add_layer()->CopyFrom(fused.layer(i));
+    }
+  }
+}
+
+}  // namespace caffe
@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <cmath>
+
+#include "caffe/common.hpp"
+#include "caffe/util/int8_gemm.hpp"
+
+// The x86 kernels are compiled for their instruction set with a target
+// attribute (no -mavx2 nor -march flag needed) and int8_gemm_cpu picks the best
+// one supported by the CPU at run time. Compilers without target attributes
+// only get the kernels enabled by their compilation flags.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define INT8_TARGET(isa) __attribute__((target(isa)))
+#define INT8_CPU_SUPPORTS(feature) __builtin_cpu_supports(feature)
+#define INT8_AVX2
+#if !defined(__clang__) && __GNUC__ >= 8
+#define INT8_AVX512_VNNI
+#endif
+#if !defined(__clang__) && __GNUC__ >= 11
+#define INT8_AVX_VNNI
+#endif
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define INT8_TARGET(isa)
+#define INT8_CPU_SUPPORTS(feature) true
+#define INT8_AVX2
+#if defined(__AVX512VNNI__)
+#define INT8_AVX512_VNNI
+#endif
+#if defined(__AVXVNNI__)
+#define INT8_AVX_VNNI
+#endif
+#endif
+
+namespace caffe {
+
+template <typename Dtype>
+void int8_quantize_weights_cpu(const Dtype* weights, const int num_output,
+    const int k, const float* scales, float* scales_out, int8_t* weights_int8,
+    int* row_sums) {
+  const int padded_k = int8_gemm_padded_k(k);
+  for (int m = 0; m < num_output; ++m) {
+    const Dtype* row = weights + m * k;
+    float scale;
+    if (scales) {
+      scale = scales[m];
+    } else {
+      Dtype max_abs = 0;
+      for (int i = 0; i < k; ++i) {
+        max_abs = std::max(max_abs, std::abs(row[i]));
+      }
+      scale = (max_abs > 0 ? static_cast<float>(max_abs) / 127.f : 1.f);
+      scales_out[m] = scale;
+    }
+    int8_quantize_cpu(k, row, scale, weights_int8 + m * padded_k);
+    std::fill(weights_int8 + m * padded_k + k,
+        weights_int8 + (m + 1) * padded_k, 0);
+    int row_sum = 0;
+    for (int i = 0; i < k; ++i) {
+      row_sum += weights_int8[m * padded_k + i];
+    }
+    row_sums[m] = row_sum;
+  }
+}
+
+template void int8_quantize_weights_cpu<float>(const float* weights,
+    const int num_output, const int k, const float* scales,
+    float* scales_out, int8_t* weights_int8, int* row_sums);
+template void int8_quantize_weights_cpu<double>(const double* weights,
+    const int num_output, const int k, const float* scales,
+    float* scales_out, int8_t* weights_int8, int* row_sums);
+
+template <typename Dtype>
+void int8_quantize_cpu(const int n, const Dtype* x, const float scale,
+    int8_t* q) {
+  const Dtype inverse_scale = Dtype(1) / scale;
+  CAFFE_PARALLEL_FOR(n)
+  for (int i = 0; i < n; ++i) {
+    const Dtype value = std::floor(x[i] * inverse_scale + Dtype(0.5));
+    q[i] = static_cast<int8_t>(
+        std::min(std::max(value, Dtype(-127)), Dtype(127)));
+  }
+}
+
+template void int8_quantize_cpu<float>(const int n, const float* x,
+    const float scale, int8_t* q);
+template void int8_quantize_cpu<double>(const int n, const double* x,
+    const float scale, int8_t* q);
+
+void int8_im2row_cpu(const int8_t* data_im, const int channels,
+    const int height, const int width, const int kernel_h, const int kernel_w,
+    const int pad_h, const int pad_w, const int stride_h, const int stride_w,
+    const int dilation_h, const int dilation_w, const int padded_k,
+    int8_t* data_row) {
+  const int output_h = (height + 2 * pad_h
+      - (dilation_h * (kernel_h - 1) + 1)) / stride_h + 1;
+  const int output_w = (width + 2 * pad_w
+      - (dilation_w * (kernel_w - 1) + 1)) / stride_w + 1;
+  const int k = channels * kernel_h * kernel_w;
+  CAFFE_PARALLEL_FOR(output_h * output_w * padded_k)
+  for (int output_row = 0; output_row < output_h; ++output_row) {
+    for (int output_col = 0; output_col < output_w; ++output_col) {
+      int8_t* row = data_row
+          + (output_row * output_w + output_col) * padded_k;
+      for (int channel = 0; channel < channels; ++channel) {
+        const int8_t* channel_im = data_im + channel * height * width;
+        for (int kernel_row = 0; kernel_row < kernel_h; ++kernel_row) {
+          const int input_row = output_row * stride_h - pad_h
+              + kernel_row * dilation_h;
+          const bool row_inside = (input_row >= 0 && input_row < height);
+          for (int kernel_col = 0; kernel_col < kernel_w; ++kernel_col) {
+            const int input_col = output_col * stride_w - pad_w
+                + kernel_col * dilation_w;
+            *(row++) = (row_inside && input_col >= 0 && input_col < width
+                ? channel_im[input_row * width + input_col] : 0);
+          }
+        }
+      }
+      std::fill(row, row + padded_k - k, 0);
+    }
+  }
+}
+
+// Every kernel computes a tile of tile_m weight rows x tile_n im2row rows, as
+// many int32 accumulators as the vector registers allow:
+// sums[i * tile_n + j] = dot(a_rows[i], b_rows[j]) over padded_k int8 values
+template <int tile_m, int tile_n>
+static void int8_gemm_tile_cpp(const int8_t* const* a_rows,
+    const int* /* a_row_sums */, const int8_t* const* b_rows,
+    const int padded_k, int* sums) {
+  for (int i = 0; i < tile_m; ++i) {
+    for (int j = 0; j < tile_n; ++j) {
+      int sum = 0;
+      for (int k = 0; k < padded_k; ++k) {
+        sum += a_rows[i][k] * b_rows[j][k];
+      }
+      sums[i * tile_n + j] = sum;
+    }
+  }
+}
+
+#ifdef INT8_AVX2
+// Sum of the 8 int32 of accumulator
+INT8_TARGET("avx2")
+static inline int int8_reduce_add_avx2(const __m256i accumulator) {
+  const __m128i sum_128 = _mm_add_epi32(_mm256_castsi256_si128(accumulator),
+      _mm256_extracti128_si256(accumulator, 1));
+  const __m128i sum_64 = _mm_add_epi32(sum_128,
+      _mm_unpackhi_epi64(sum_128, sum_128));
+  const __m128i sum_32 = _mm_add_epi32(sum_64, _mm_shuffle_epi32(sum_64, 1));
+  return _mm_cvtsi128_si32(sum_32);
+}
+#endif
+
+#ifdef INT8_AVX512_VNNI
+INT8_TARGET("avx512f,avx512bw,avx512vnni")
+static void int8_gemm_tile_avx512_vnni(const int8_t* const* a_rows,
+    const int* a_row_sums, const int8_t* const* b_rows, const int padded_k,
+    int* sums) {
+  // vpdpbusd multiplies unsigned by signed bytes: b + 128 is unsigned, and
+  // the extra 128 * sum(a) is subtracted at the end
+  __m512i accumulators[4][4];
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      accumulators[i][j] = _mm512_setzero_si512();
+    }
+  }
+  const __m512i sign_bits = _mm512_set1_epi8(static_cast<char>(0x80));
+  for (int k = 0; k < padded_k; k += 64) {
+    __m512i b[4];
+    for (int j = 0; j < 4; ++j) {
+      b[j] = _mm512_xor_si512(_mm512_loadu_si512(b_rows[j] + k), sign_bits);
+    }
+    for (int i = 0; i < 4; ++i) {
+      const __m512i a = _mm512_loadu_si512(a_rows[i] + k);
+      for (int j = 0; j < 4; ++j) {
+        accumulators[i][j] = _mm512_dpbusd_epi32(accumulators[i][j], b[j], a);
+      }
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      int lanes[16];
+      _mm512_storeu_si512(lanes, accumulators[i][j]);
+      int sum = -128 * a_row_sums[i];
+      for (int lane = 0; lane < 16; ++lane) {
+        sum += lanes[lane];
+      }
+      sums[i * 4 + j] = sum;
+    }
+  }
+}
+#endif
+
+
+#ifdef INT8_AVX_VNNI
+INT8_TARGET("avx2,avxvnni")
+static void int8_gemm_tile_avx_vnni(const int8_t* const* a_rows,
+    const int* a_row_sums, const int8_t* const* b_rows, const int padded_k,
+    int* sums) {
+  // Same unsigned x signed trick than with AVX-512 VNNI
+  __m256i accumulators[4][2];
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      accumulators[i][j] = _mm256_setzero_si256();
+    }
+  }
+  const __m256i sign_bits = _mm256_set1_epi8(static_cast<char>(0x80));
+  for (int k = 0; k < padded_k; k += 32) {
+    __m256i b[2];
+    for (int j = 0; j < 2; ++j) {
+      b[j] = _mm256_xor_si256(_mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(b_rows[j] + k)), sign_bits);
+    }
+    for (int i = 0; i < 4; ++i) {
+      const __m256i a = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(a_rows[i] + k));
+      for (int j = 0; j < 2; ++j) {
+        accumulators[i][j] = _mm256_dpbusd_avx_epi32(accumulators[i][j], b[j],
+            a);
+      }
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      sums[i * 2 + j] = int8_reduce_add_avx2(accumulators[i][j])
+          - 128 * a_row_sums[i];
+    }
+  }
+}
+#endif
+
+#ifdef INT8_AVX2
+INT8_TARGET("avx2")
+static void int8_gemm_tile_avx2(const int8_t* const* a_rows,
+    const int* /* a_row_sums */, const int8_t* const* b_rows,
+    const int padded_k, int* sums) {
+  // Sign-extended to int16, so the pairwise products never saturate
+  __m256i accumulators[4][2];
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      accumulators[i][j] = _mm256_setzero_si256();
+    }
+  }
+  for (int k = 0; k < padded_k; k += 16) {
+    __m256i b[2];
+    for (int j = 0; j < 2; ++j) {
+      b[j] = _mm256_cvtepi8_epi16(_mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(b_rows[j] + k)));
+    }
+    for (int i = 0; i < 4; ++i) {
+      const __m256i a = _mm256_cvtepi8_epi16(_mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(a_rows[i] + k)));
+      for (int j = 0; j < 2; ++j) {
+        accumulators[i][j] = _mm256_add_epi32(accumulators[i][j],
+            _mm256_madd_epi16(a, b[j]));
+      }
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      sums[i * 2 + j] = int8_reduce_add_avx2(accumulators[i][j]);
+    }
+  }
+}
+#endif
+
+template <int tile_m, int tile_n, void (*tile)(const int8_t* const*,
+    const int*, const int8_t* const*, const int, int*)>
+static void int8_gemm_tiles(const int m, const int n, const int padded_k,
+    const int8_t* a, const int* a_row_sums, const int8_t* b, int* c) {
+  const int num_n_tiles = (n + tile_n - 1) / tile_n;
+  CAFFE_PARALLEL_FOR(m * n)
+  for (int n_tile = 0; n_tile < num_n_tiles; ++n_tile) {
+    // Tiles on the edges repeat the last row, and drop its results
+    const int n_begin = n_tile * tile_n;
+    const int8_t* b_rows[tile_n];
+    for (int j = 0; j < tile_n; ++j) {
+      b_rows[j] = b + std::min(n_begin + j, n - 1) * padded_k;
+    }
+    for (int m_begin = 0; m_begin < m; m_begin += tile_m) {
+      const int8_t* a_rows[tile_m];
+      int row_sums[tile_m];
+      for (int i = 0; i < tile_m; ++i) {
+        const int row = std::min(m_begin + i, m - 1);
+        a_rows[i] = a + row * padded_k;
+        row_sums[i] = a_row_sums[row];
+      }
+      int sums[tile_m * tile_n];
+      tile(a_rows, row_sums, b_rows, padded_k, sums);
+      for (int i = 0; i < tile_m && m_begin + i < m; ++i) {
+        for (int j = 0; j < tile_n && n_begin + j < n; ++j) {
+          c[(m_begin + i) * n + n_begin + j] = sums[i * tile_n + j];
+        }
+      }
+    }
+  }
+}
+
+typedef void (*Int8GemmFunction)(const int m, const int n,
+    const int padded_k, const int8_t* a, const int* a_row_sums,
+    const int8_t* b, int* c);
+
+struct Int8GemmKernel {
+  Int8GemmFunction function;
+  const char* isa;
+};
+
+// Best kernel supported by the CPU
+static Int8GemmKernel select_int8_gemm_kernel() {
+  Int8GemmKernel kernel = {&int8_gemm_tiles<4, 2, int8_gemm_tile_cpp<4, 2> >,
+                           "C++"};
+#if defined(__GNUC__) && defined(INT8_AVX2)
+  __builtin_cpu_init();
+#endif
+#if defined(INT8_AVX512_VNNI)
+  if (INT8_CPU_SUPPORTS("avx512vnni") && INT8_CPU_SUPPORTS("avx512bw")) {
+    kernel.function = &int8_gemm_tiles<4, 4, int8_gemm_tile_avx512_vnni>;
+    kernel.isa = "AVX-512 VNNI";
+    return kernel;
+  }
+#endif
+#if defined(INT8_AVX_VNNI)
+  if (INT8_CPU_SUPPORTS("avxvnni") && INT8_CPU_SUPPORTS("avx2")) {
+    kernel.function = &int8_gemm_tiles<4, 2, int8_gemm_tile_avx_vnni>;
+    kernel.isa = "AVX-VNNI";
+    return kernel;
+  }
+#endif
+#if defined(INT8_AVX2)
+  if (INT8_CPU_SUPPORTS("avx2")) {
+    kernel.function = &int8_gemm_tiles<4, 2, int8_gemm_tile_avx2>;
+    kernel.isa = "AVX2";
+  }
+#endif
+  return kernel;
+}
+
+static const Int8GemmKernel& int8_gemm_kernel() {
+  static const Int8GemmKernel kernel = select_int8_gemm_kernel();
+  return kernel;
+}
+
+const char* int8_gemm_isa() {
+  return int8_gemm_kernel().isa;
+}
+
+void int8_gemm_cpu(const int m, const int n, const int padded_k,
+    const int8_t* a, const int* a_row_sums, const int8_t* b, int* c) {
+  int8_gemm_kernel().function(m, n, padded_k, a, a_row_sums, b, c);
+}
+
+}  // namespace caffe
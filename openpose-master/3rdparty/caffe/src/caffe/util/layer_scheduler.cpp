@@ -0,0 +1,216 @@
+#include <boost/thread.hpp>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+#include "caffe/util/layer_scheduler.hpp"
+
+namespace caffe {
+
+template <typename Dtype>
+class LayerScheduler<Dtype>::sync {
+ public:
+  boost::mutex mutex_;
+  // Notified when layers become ready, the forward pass finishes or the
+  // workers must stop
+  boost::condition_variable condition_;
+};
+
+template <typename Dtype>
+LayerScheduler<Dtype>::LayerScheduler(Net<Dtype>* net, const int num_threads,
+    const int cpu_threads)
+    : net_(net), num_threads_(std::max(num_threads, 1)), sync_(new sync()),
+      end_(-1), remaining_layers_(0), loss_(0), stop_(false) {
+  CHECK(net_);
+  CHECK_GE(cpu_threads, 0);
+  InitDependencies();
+  // Layers at the same depth of the DAG can run at the same time
+  const int num_layers = net_->layers().size();
+  vector<int> depths(num_layers, 0);
+  int max_depth = 0;
+  for (int layer = 0; layer < num_layers; ++layer) {
+    for (int i = 0; i < dependencies_[layer].size(); ++i) {
+      depths[layer] = std::max(depths[layer],
+          depths[dependencies_[layer][i]] + 1);
+    }
+    max_depth = std::max(max_depth, depths[layer]);
+  }
+  vector<int> widths(max_depth + 1, 0);
+  for (int layer = 0; layer < num_layers; ++layer) {
+    ++widths[depths[layer]];
+  }
+  const int total_cpu_threads = (cpu_threads > 0 ? cpu_threads
+      : std::max(1, static_cast<int>(boost::thread::hardware_concurrency())));
+  layer_cpu_threads_.resize(num_layers);
+  for (int layer = 0; layer < num_layers; ++layer) {
+    layer_cpu_threads_[layer] = std::max(1, total_cpu_threads
+        / std::min(num_threads_, widths[depths[layer]]));
+  }
+}
+
+template <typename Dtype>
+LayerScheduler<Dtype>::~LayerScheduler() {
+  {
+    boost::mutex::scoped_lock lock(sync_->mutex_);
+    stop_ = true;
+  }
+  sync_->condition_.notify_all();
+  for (int i = 0; i < workers_.size(); ++i) {
+    workers_[i]->join();
+  }
+}
+
+template <typename Dtype>
+void LayerScheduler<Dtype>::InitDependencies() {
+  const int num_layers = net_->layers().size();
+  const int num_blobs = net_->blobs().size();
+  dependencies_.assign(num_layers, vector<int>());
+  dependents_.assign(num_layers, vector<int>());
+  ancestors_.assign(num_layers, vector<bool>(num_layers, false));
+  // Last writer of each blob, and its readers since then
+  vector<int> last_writers(num_blobs, -1);
+  vector<vector<int> > readers(num_blobs);
+  for (int layer = 0; layer < num_layers; ++layer) {
+    vector<int>& dependencies = dependencies_[layer];
+    const vector<int>& bottom_ids = net_->bottom_ids(layer);
+    const vector<int>& top_ids = net_->top_ids(layer);
+    for (int i = 0; i < bottom_ids.size(); ++i) {
+      if (last_writers[bottom_ids[i]] >= 0) {
+        dependencies.push_back(last_writers[bottom_ids[i]]);
+      }
+    }
+    for (int i = 0; i < top_ids.size(); ++i) {
+      if (last_writers[top_ids[i]] >= 0) {
+        dependencies.push_back(last_writers[top_ids[i]]);
+      }
+      const vector<int>& blob_readers = readers[top_ids[i]];
+      for (int j = 0; j < blob_readers.size(); ++j) {
+        if (blob_readers[j] != layer) {
+          dependencies.push_back(blob_readers[j]);
+        }
+      }
+    }
+    std::sort(dependencies.begin(), dependencies.end());
+    dependencies.erase(std::unique(dependencies.begin(), dependencies.end()),
+        dependencies.end());
+    for (int i = 0; i < bottom_ids.size(); ++i) {
+      readers[bottom_ids[i]].push_back(layer);
+    }
+    for (int i = 0; i < top_ids.size(); ++i) {
+      last_writers[top_ids[i]] = layer;
+      readers[top_ids[i]].clear();
+    }
+    // Transitive closure (the dependencies always come before the layer)
+    for (int i = 0; i < dependencies.size(); ++i) {
+      const int dependency = dependencies[i];
+      dependents_[dependency].push_back(layer);
+      ancestors_[layer][dependency] = true;
+      for (int ancestor = 0; ancestor < dependency; ++ancestor) {
+        if (ancestors_[dependency][ancestor]) {
+          ancestors_[layer][ancestor] = true;
+        }
+      }
+    }
+  }
+}
+
+template <typename Dtype>
+void LayerScheduler<Dtype>::StartWorkers() {
+  try {
+    for (int i = workers_.size(); i < num_threads_ - 1; ++i) {
+      workers_.push_back(shared_ptr<boost::thread>(new boost::thread(
+          &LayerScheduler<Dtype>::WorkerEntry, this)));
+    }
+  } catch (std::exception& e) {
+    LOG(FATAL) << "Thread exception: " << e.what();
+  }
+}
+
+template <typename Dtype>
+void LayerScheduler<Dtype>::WorkerEntry() {
+  // Only used in CPU mode (the default mode of a new thread)
+  try {
+    boost::mutex::scoped_lock lock(sync_->mutex_);
+    RunReadyLayers(&lock, false);
+  } catch (std::exception& e) {
+    LOG(FATAL) << "Thread exception: " << e.what();
+  }
+}
+
+template <typename Dtype>
+void LayerScheduler<Dtype>::RunReadyLayers(
+    boost::unique_lock<boost::mutex>* lock, const bool caller) {
+  while (true) {
+    while (ready_layers_.empty()
+        && !(caller ? remaining_layers_ == 0 : stop_)) {
+      sync_->condition_.wait(*lock);
+    }
+    if (caller ? remaining_layers_ == 0 : stop_) {
+      break;
+    }
+    const int layer = ready_layers_.front();
+    ready_layers_.pop_front();
+    lock->unlock();
+    Caffe::set_cpu_threads(layer_cpu_threads_[layer]);
+    const Dtype layer_loss = net_->layers()[layer]->Forward(
+        net_->bottom_vecs()[layer], net_->top_vecs()[layer]);
+    lock->lock();
+    loss_ += layer_loss;
+    --remaining_layers_;
+    const vector<int>& dependents = dependents_[layer];
+    for (int i = 0; i < dependents.size(); ++i) {
+      const int dependent = dependents[i];
+      if (dependent <= end_ && --pending_dependencies_[dependent] == 0) {
+        ready_layers_.push_back(dependent);
+      }
+    }
+    sync_->condition_.notify_all();
+  }
+}
+
+template <typename Dtype>
+Dtype LayerScheduler<Dtype>::ForwardFromTo(const int start, const int end) {
+  CHECK_GE(start, 0);
+  CHECK_LT(end, net_->layers().size());
+  if (num_threads_ <= 1 || Caffe::mode() != Caffe::CPU) {
+    return net_->ForwardFromTo(start, end);
+  }
+  StartWorkers();
+  const int caller_cpu_threads = Caffe::cpu_threads();
+#ifdef _OPENMP
+  const int caller_omp_threads = omp_get_max_threads();
+#endif
+  boost::mutex::scoped_lock lock(sync_->mutex_);
+  // Dependencies on layers before start are already satisfied
+  end_ = end;
+  remaining_layers_ = std::max(end - start + 1, 0);
+  loss_ = 0;
+  pending_dependencies_.assign(net_->layers().size(), 0);
+  for (int layer = start; layer <= end; ++layer) {
+    const vector<int>& dependencies = dependencies_[layer];
+    for (int i = 0; i < dependencies.size(); ++i) {
+      if (dependencies[i] >= start) {
+        ++pending_dependencies_[layer];
+      }
+    }
+    if (pending_dependencies_[layer] == 0) {
+      ready_layers_.push_back(layer);
+    }
+  }
+  sync_->condition_.notify_all();
+  RunReadyLayers(&lock, true);
+  const Dtype loss = loss_;
+  lock.unlock();
+  Caffe::set_cpu_threads(caller_cpu_threads);
+#ifdef _OPENMP
+  omp_set_num_threads(caller_omp_threads);
+#endif
+  return loss;
+}
+
+INSTANTIATE_CLASS(LayerScheduler);
+
+}  // namespace caffe
@@ -0,0 +1,138 @@
+// This is a script to convert trained Caffe weights (.caffemodel) into a flat
+// binary file that can be memory-mapped and used in place (no protobuf parsing
+// and no per-blob copies at load time).
+// Usage:
+//    convert_caffemodel_to_flat net_weights.caffemodel net_weights.flat
+//
+// File layout (native endianness, every field is a uint64 unless stated):
+//    Header (32 bytes): magic "CAFFEFLT" (8 bytes), version (uint32),
+//        number of blobs (uint32), table offset, data offset
+//    Table, one entry per blob: layer name length, blob index (inside its
+//        layer), number of axes, axes..., data offset, count, layer name
+//        (chars, padded to 8 bytes)
+//    Data: float32 values of each blob, each blob aligned to 64 bytes
+
+#include <fstream>  // NOLINT(readability/streams)
+#include <string>
+#include <vector>
+
+#include "caffe/caffe.hpp"
+#include "caffe/util/upgrade_proto.hpp"
+
+using std::ofstream;
+
+using namespace caffe;  // NOLINT(build/namespaces)
+
+namespace {
+
+const char kFlatMagic[8] = {'C', 'A', 'F', 'F', 'E', 'F', 'L', 'T'};
+const uint32_t kFlatVersion = 1;
+const uint64_t kFlatHeaderSize = 32;
+const uint64_t kFlatDataAlignment = 64;
+
+uint64_t AlignTo(const uint64_t value, const uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+void WriteUint64(ofstream* output, const uint64_t value) {
+  output->write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WritePadding(ofstream* output, const uint64_t size) {
+  const std::vector<char> zeros(size, 0);
+  output->write(zeros.data(), size);
+}
+
+struct FlatEntry {
+  string layer_name;
+  uint64_t blob_index;
+  Blob<float> blob;
+  uint64_t data_offset;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  FLAGS_alsologtostderr = 1;  // Print output to stderr (while still logging)
+  ::google::InitGoogleLogging(argv[0]);
+  if (argc != 3) {
+    LOG(ERROR) << "Usage: "
+        << "convert_caffemodel_to_flat net_weights_in flat_weights_out";
+    return 1;
+  }
+
+  NetParameter net_param;
+  ReadNetParamsFromBinaryFileOrDie(argv[1], &net_param);
+
+  // Blobs (float32 whatever the proto storage was) and their offsets
+  std::vector<shared_ptr<FlatEntry> > entries;
+  uint64_t table_size = 0;
+  for (int i = 0; i < net_param.layer_size(); ++i) {
+    const LayerParameter& layer_param = net_param.layer(i);
+    for (int j = 0; j < layer_param.blobs_size(); ++j) {
+      shared_ptr<FlatEntry> entry(new FlatEntry);
+      entry->layer_name = layer_param.name();
+      entry->blob_index = j;
+      entry->blob.FromProto(layer_param.blobs(j), true);
+      table_size += (5 + entry->blob.num_axes()) * sizeof(uint64_t)
+          + AlignTo(entry->layer_name.size(), 8);
+      entries.push_back(entry);
+    }
+  }
+  const uint64_t data_offset =
+      AlignTo(kFlatHeaderSize + table_size, kFlatDataAlignment);
+  uint64_t offset = data_offset;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    entries[i]->data_offset = offset;
+    offset = AlignTo(offset + entries[i]->blob.count() * sizeof(float),
+                     kFlatDataAlignment);
+  }
+
+  ofstream output(argv[2], std::ios::out | std::ios::binary);
+  if (!output.is_open()) {
+    LOG(ERROR) << "Failed to open output file: " << argv[2];
+    return 2;
+  }
+  // Header
+  const uint32_t version_and_size[2] = {
+      kFlatVersion, static_cast<uint32_t>(entries.size())};
+  output.write(kFlatMagic, sizeof(kFlatMagic));
+  output.write(reinterpret_cast<const char*>(version_and_size),
+               sizeof(version_and_size));
+  WriteUint64(&output, kFlatHeaderSize);
+  WriteUint64(&output, data_offset);
+  // Table
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const FlatEntry& entry = *entries[i];
+    WriteUint64(&output, entry.layer_name.size());
+    WriteUint64(&output, entry.blob_index);
+    WriteUint64(&output, entry.blob.num_axes());
+    for (int axis = 0; axis < entry.blob.num_axes(); ++axis) {
+      WriteUint64(&output, entry.blob.shape(axis));
+    }
+    WriteUint64(&output, entry.data_offset);
+    WriteUint64(&output, entry.blob.count());
+    output.write(entry.layer_name.data(), entry.layer_name.size());
+    WritePadding(&output,
+                 AlignTo(entry.layer_name.size(), 8) - entry.layer_name.size());
+  }
+  // Data
+  WritePadding(&output, data_offset - kFlatHeaderSize - table_size);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const Blob<float>& blob = entries[i]->blob;
+    const uint64_t data_size = blob.count() * sizeof(float);
+    output.write(reinterpret_cast<const char*>(blob.cpu_data()), data_size);
+    WritePadding(&output, AlignTo(entries[i]->data_offset + data_size,
+                                  kFlatDataAlignment)
+                 - entries[i]->data_offset - data_size);
+  }
+  output.close();
+  if (!output) {
+    LOG(ERROR) << "Failed to write output file: " << argv[2];
+    return 2;
+  }
+
+  LOG(INFO) << "Wrote " << entries.size() << " blobs (" << offset
+            << " bytes) to " << argv[2];
+  return 0;
+}
@@ -0,0 +1,157 @@
+// ------------------------- OpenPose Library Tutorial - Hand Tracking by Person Id Test -------------------------
+// Test of op::HandDetector::trackHands and op::HandDetector::updateTracker with person ids on synthetic keypoints (no
+// Caffe network, camera or GUI required): one hand of a tracked person drops out for 1 to 4 frames while the other
+// one keeps being found. It returns 0 if all the checks pass.
+
+// GFlags: DEFINE_bool, _int32, _int64, _uint64, _double, _string
+#include <gflags/gflags.h>
+// Allow Google Flags in Ubuntu 14
+#ifndef GFLAGS_GFLAGS_H_
+    namespace gflags = google;
+#endif
+#include <openpose/headers.hpp>
+
+// Debugging
+DEFINE_int32(logging_level,             3,              "The logging level. Integer in the range [0, 255]. 0 will output any log() message, while"
+                                                        " 255 will not output any. Current OpenPose library messages are in the range 0-4: 1 for"
+                                                        " low priority messages and 4 for important ones.");
+
+// Frames a hand rectangle is reused after its hand is lost (HandDetector)
+const auto MAX_FRAMES_HAND_REUSED = 3;
+// COCO_18 arm keypoints (shoulder, elbow, wrist) of the left (hand 0) and right (hand 1) arms
+const int ARM_KEYPOINTS[2][3] = {{5, 6, 7}, {2, 3, 4}};
+// Person id given by the tracker
+const auto PERSON_ID = 7ll;
+
+int sFailures = 0;
+
+void checkTest(const bool condition, const std::string& message)
+{
+    if (!condition)
+    {
+        op::log("FAILED: " + message, op::Priority::High);
+        sFailures++;
+    }
+}
+
+// 1 person with both arms, or without the wrist of the missing hand (-1 if none)
+op::Array<float> getPose(const int missingHand)
+{
+    op::Array<float> poseKeypoints{{1, 18, 3}, 0.f};
+    for (auto arm = 0 ; arm < 2 ; arm++)
+    {
+        const auto side = (arm == 0 ? 1.f : -1.f);
+        for (auto joint = 0 ; joint < 3 ; joint++)
+        {
+            const auto keypoint = ARM_KEYPOINTS[arm][joint];
+            poseKeypoints[3*keypoint] = 320.f + side * (60.f + 50.f * joint);
+            poseKeypoints[3*keypoint+1] = 200.f + 40.f * joint;
+            poseKeypoints[3*keypoint+2] = 0.9f;
+        }
+    }
+    if (missingHand >= 0)
+        poseKeypoints[3*ARM_KEYPOINTS[missingHand][2]+2] = 0.f;
+    return poseKeypoints;
+}
+
+// Hand keypoints found by the hand network on the given hand rectangles (0 if the hand is missing)
+std::array<op::Array<float>, 2> getHandKeypoints(const std::array<op::Rectangle<float>, 2>& handRectangles,
+                                                 const int missingHand)
+{
+    std::array<op::Array<float>, 2> handKeypoints;
+    for (auto hand = 0 ; hand < 2 ; hand++)
+    {
+        handKeypoints[hand].reset({1, 21, 3}, 0.f);
+        if (hand != missingHand && handRectangles[hand].area() > 0)
+        {
+            const auto& handRectangle = handRectangles[hand];
+            for (auto keypoint = 0 ; keypoint < 21 ; keypoint++)
+            {
+                const auto ratioX = 0.25f + (keypoint % 5) / 8.f;
+                const auto ratioY = 0.25f + (keypoint / 5) / 8.f;
+                handKeypoints[hand][3*keypoint] = handRectangle.x + handRectangle.width * ratioX;
+                handKeypoints[hand][3*keypoint+1] = handRectangle.y + handRectangle.height * ratioY;
+                handKeypoints[hand][3*keypoint+2] = 0.9f;
+            }
+        }
+    }
+    return handKeypoints;
+}
+
+// Frames where the hand drops out: the lost hand is kept MAX_FRAMES_HAND_REUSED frames, the other one is tracked
+void testHandDropOut(const int missingHand, const int framesMissing)
+{
+    const auto testName = "Hand " + std::to_string(missingHand) + " missing " + std::to_string(framesMissing)
+                        + " frame(s): ";
+    op::HandDetector handDetector{op::PoseModel::COCO_18};
+    const op::Array<long long> poseIds{1, PERSON_ID};
+    auto frameId = 1ull;
+    // Both hands found
+    auto handRectangles = handDetector.trackHands(getPose(-1), 1., poseIds, frameId);
+    checkTest(handRectangles.size() == 1u && handRectangles[0][0].area() > 0 && handRectangles[0][1].area() > 0,
+              testName + "both hands detected.");
+    if (handRectangles.size() != 1u)
+        return;
+    const auto handKeypoints = getHandKeypoints(handRectangles[0], -1);
+    handDetector.updateTracker(handKeypoints, frameId, poseIds);
+    // Rectangle of the last hand keypoints found (same threshold than HandDetector)
+    const auto lastRectangle = op::getKeypointsRectangle(handKeypoints[missingHand], 0, 0.25f);
+    // One hand drops out (arm keypoint and hand keypoints missing)
+    for (auto frame = 1 ; frame <= framesMissing ; frame++)
+    {
+        frameId++;
+        handRectangles = handDetector.trackHands(getPose(missingHand), 1., poseIds, frameId);
+        const auto& handRectangle = handRectangles.at(0)[missingHand];
+        if (frame <= MAX_FRAMES_HAND_REUSED)
+            checkTest(handRectangle.x == lastRectangle.x && handRectangle.y == lastRectangle.y
+                      && handRectangle.width == lastRectangle.width && handRectangle.height == lastRectangle.height,
+                      testName + "frame " + std::to_string(frame) + " reuses the lost hand.");
+        else
+            checkTest(handRectangle.area() <= 0, testName + "frame " + std::to_string(frame)
+                      + " does not reuse a stale hand.");
+        checkTest(handRectangles[0][1-missingHand].area() > 0,
+                  testName + "frame " + std::to_string(frame) + " keeps the other hand.");
+        handDetector.updateTracker(getHandKeypoints(handRectangles[0], missingHand), frameId, poseIds);
+    }
+    // The hand comes back
+    frameId++;
+    handRectangles = handDetector.trackHands(getPose(-1), 1., poseIds, frameId);
+    checkTest(handRectangles[0][0].area() > 0 && handRectangles[0][1].area() > 0,
+              testName + "both hands detected again.");
+}
+
+int handDetectorTest()
+{
+    try
+    {
+        // logging_level
+        op::check(0 <= FLAGS_logging_level && FLAGS_logging_level <= 255, "Wrong logging_level value.",
+                  __LINE__, __FUNCTION__, __FILE__);
+        op::ConfigureLog::setPriorityThreshold((op::Priority)FLAGS_logging_level);
+        // Tests
+        for (auto missingHand = 0 ; missingHand < 2 ; missingHand++)
+            for (auto framesMissing = 1 ; framesMissing <= MAX_FRAMES_HAND_REUSED + 1 ; framesMissing++)
+                testHandDropOut(missingHand, framesMissing);
+        if (sFailures > 0)
+        {
+            op::log(std::to_string(sFailures) + " check(s) failed.", op::Priority::High);
+            return -1;
+        }
+        op::log("All the checks passed.", op::Priority::High);
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return -1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Parsing command line flags
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+    // Running handDetectorTest
+    return handDetectorTest();
+}
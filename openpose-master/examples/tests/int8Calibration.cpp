@@ -0,0 +1,241 @@
+// ------------------------- OpenPose Library Tutorial - INT8 Calibration -------------------------
+// Post-training INT8 calibration of the body pose network (CPU): it runs the float network on the frames of a
+// DatumRecording (see op::DatumRecorder), picks the quantization scale of the input of each convolution (a high
+// percentile of its absolute values over all the frames) and of each output channel of its weights (maximum
+// absolute value), and writes them together with the quantized weights into a new caffemodel. OpenPose loads it
+// instead of the float one with WrapperStructPose::int8Inference (or PoseExtractorCaffe's int8Inference). E.g.:
+//     ./build/examples/tests/int8Calibration.bin --recording_path calibration.oprec
+// writes models/pose/coco/pose_iter_440000_int8.caffemodel and prints the difference between the float and INT8
+// network outputs on the calibration frames. The output name is fixed: the trained model with the `_int8` suffix
+// before `.caffemodel`, which is the file loaded by the OpenPose demo with `--int8_inference` (it fails if it is
+// missing). Do not convert it into a `.flat` file (doc/quick_start.md), the flat format drops the INT8 scales. The
+// keypoint accuracy can then be compared with examples/tests/pose_accuracy_coco_val.sh.
+
+#include <algorithm> // std::max, std::nth_element
+#include <chrono> // `std::chrono::` functions and classes, e.g. std::chrono::high_resolution_clock
+#include <cmath> // std::abs, std::round
+#include <map>
+// GFlags: DEFINE_bool, _int32, _int64, _uint64, _double, _string
+#include <gflags/gflags.h>
+// Allow Google Flags in Ubuntu 14
+#ifndef GFLAGS_GFLAGS_H_
+    namespace gflags = google;
+#endif
+#include <caffe/net.hpp>
+#include <caffe/layers/conv_layer.hpp>
+#include <caffe/util/io.hpp> // caffe::WriteProtoToBinaryFile
+#include <openpose/headers.hpp>
+
+// Debugging
+DEFINE_int32(logging_level,             3,              "The logging level. Integer in the range [0, 255]. 0 will output any log() message, while"
+                                                        " 255 will not output any. Current OpenPose library messages are in the range 0-4: 1 for"
+                                                        " low priority messages and 4 for important ones.");
+// Calibration data
+DEFINE_string(recording_path,           "",             "DatumRecording whose frames (with their recorded net input sizes) are used for the"
+                                                        " calibration. A few hundred frames representative of the deployment are enough.");
+DEFINE_uint64(frame_last,               -1,             "Last recorded frame to use. Select -1 to use all of them.");
+// Model
+DEFINE_string(model_folder,             "models/",      "Folder path (absolute or relative) where the models (pose, face, ...) are located.");
+DEFINE_string(model_pose,               "COCO",         "Model to be calibrated. E.g. `COCO` (18 keypoints), `MPI` (15 keypoints).");
+DEFINE_string(output_model,             "",             "Calibrated caffemodel. If empty, the trained model path with the `_int8` suffix, which is"
+                                                        " the one loaded by `int8Inference`.");
+// Quantization
+DEFINE_double(percentile,               99.99,          "Percentile of the absolute input values of each convolution mapped to the int8 range"
+                                                        " (larger values saturate). 100 uses the maximum.");
+DEFINE_string(float_layers,             "",             "Comma-separated convolutions kept in float (e.g. the last layer of each stage if they"
+                                                        " dominate the error).");
+
+namespace
+{
+    // Quantized (round to nearest, saturated to [-127, 127]) and dequantized value
+    float quantize(const float value, const float scale)
+    {
+        return std::max(-127.f, std::min(127.f, std::round(value / scale))) * scale;
+    }
+
+    // Percentile of the absolute values (in-place partial sort of a copy)
+    float getAbsPercentile(const float* const values, const int count, const double percentile)
+    {
+        std::vector<float> absValues(count);
+        for (auto i = 0 ; i < count ; i++)
+            absValues[i] = std::abs(values[i]);
+        const auto index = std::min(count - 1, (int)(percentile / 100. * (count - 1) + 0.5));
+        std::nth_element(absValues.begin(), absValues.begin() + index, absValues.end());
+        return absValues[index];
+    }
+
+    void setNetInput(caffe::Net<float>& caffeNet, const op::Array<float>& inputData)
+    {
+        caffeNet.blobs()[0]->Reshape(inputData.getSize());
+        caffeNet.Reshape();
+        std::copy(inputData.getConstPtr(), inputData.getConstPtr() + inputData.getVolume(),
+                  caffeNet.blobs()[0]->mutable_cpu_data());
+    }
+
+    // Network inputs of all the calibration frames (all the recorded scales of each frame)
+    std::vector<op::Array<float>> getCalibrationInputs(const op::DatumRecording& datumRecording)
+    {
+        const op::CvMatToOpInput cvMatToOpInput;
+        auto numberFrames = datumRecording.getNumberFrames();
+        if (FLAGS_frame_last != (unsigned long long)-1)
+            numberFrames = std::min(numberFrames, (unsigned long long)FLAGS_frame_last + 1ull);
+        std::vector<op::Array<float>> inputs;
+        op::RecordedFrame recordedFrame;
+        for (auto frame = 0ull ; frame < numberFrames ; frame++)
+        {
+            datumRecording.getFrame(recordedFrame, frame);
+            for (auto& input : cvMatToOpInput.createArray(recordedFrame.cvInputData,
+                                                          recordedFrame.scaleInputToNetInputs,
+                                                          recordedFrame.netInputSizes))
+                inputs.emplace_back(std::move(input));
+        }
+        return inputs;
+    }
+}
+
+int int8Calibration()
+{
+    // logging_level
+    op::check(0 <= FLAGS_logging_level && FLAGS_logging_level <= 255, "Wrong logging_level value.",
+              __LINE__, __FUNCTION__, __FILE__);
+    op::ConfigureLog::setPriorityThreshold((op::Priority)FLAGS_logging_level);
+    op::check(0. < FLAGS_percentile && FLAGS_percentile <= 100., "Wrong percentile value.",
+              __LINE__, __FUNCTION__, __FILE__);
+    if (FLAGS_recording_path.empty())
+        op::error("A recording is required (`--recording_path`).", __LINE__, __FUNCTION__, __FILE__);
+    op::log("Starting INT8 calibration.", op::Priority::High);
+
+    // Float network
+    const auto poseModel = op::flagsToPoseModel(FLAGS_model_pose);
+    const auto caffeProto = FLAGS_model_folder + op::getPoseProtoTxt(poseModel);
+    const auto caffeTrainedModel = FLAGS_model_folder + op::getPoseTrainedModel(poseModel);
+    auto outputModel = FLAGS_output_model;
+    if (outputModel.empty())
+    {
+        outputModel = caffeTrainedModel;
+        outputModel.insert(outputModel.rfind(".caffemodel"), "_int8");
+    }
+    caffe::Caffe::set_mode(caffe::Caffe::CPU);
+    caffe::Net<float> caffeNet{caffeProto, caffe::TEST};
+    caffeNet.CopyTrainedLayersFrom(caffeTrainedModel);
+
+    // Calibration frames
+    const op::DatumRecording datumRecording{FLAGS_recording_path};
+    const auto inputs = getCalibrationInputs(datumRecording);
+    if (inputs.empty())
+        op::error("Empty recording: " + FLAGS_recording_path, __LINE__, __FUNCTION__, __FILE__);
+
+    // Convolutions to calibrate
+    const auto floatLayers = op::splitString(FLAGS_float_layers, ",");
+    std::map<int, float> inputScales;
+    for (auto layer = 0u ; layer < caffeNet.layers().size() ; layer++)
+        if (dynamic_cast<caffe::ConvolutionLayer<float>*>(caffeNet.layers()[layer].get()) != nullptr
+            && std::find(floatLayers.begin(), floatLayers.end(), caffeNet.layer_names()[layer]) == floatLayers.end())
+            inputScales[layer] = 0.f;
+
+    // Input scales: layer by layer, so every convolution input is read before any later layer can overwrite it
+    for (auto i = 0u ; i < inputs.size() ; i++)
+    {
+        setNetInput(caffeNet, inputs[i]);
+        for (auto layer = 0 ; layer < (int)caffeNet.layers().size() ; layer++)
+        {
+            auto inputScale = inputScales.find(layer);
+            if (inputScale != inputScales.end())
+            {
+                const auto& bottom = *caffeNet.bottom_vecs()[layer][0];
+                inputScale->second = std::max(inputScale->second,
+                                              getAbsPercentile(bottom.cpu_data(), bottom.count(), FLAGS_percentile)
+                                              / 127.f);
+            }
+            caffeNet.ForwardFromTo(layer, layer);
+        }
+        op::log("Calibrated on input " + std::to_string(i+1) + "/" + std::to_string(inputs.size()) + ".",
+                op::Priority::Normal);
+    }
+
+    // Per output channel weight scales, quantized weights and calibrated model
+    caffe::NetParameter netParameter;
+    caffeNet.ToProto(&netParameter);
+    std::map<std::string, caffe::LayerParameter*> layerParameters;
+    for (auto& layerParameter : *netParameter.mutable_layer())
+        layerParameters[layerParameter.name()] = &layerParameter;
+    for (const auto& inputScale : inputScales)
+    {
+        const auto& layerName = caffeNet.layer_names()[inputScale.first];
+        auto* convolutionParameter = layerParameters.at(layerName)->mutable_convolution_param();
+        auto* weightsBlob = layerParameters.at(layerName)->mutable_blobs(0);
+        const auto numberOutputs = weightsBlob->shape().dim(0);
+        const auto weightsPerOutput = weightsBlob->data_size() / numberOutputs;
+        // A constant-0 input would give a 0 scale (i.e., float): any positive one is exact
+        convolutionParameter->set_int8_input_scale(inputScale.second > 0.f ? inputScale.second : 1.f);
+        convolutionParameter->clear_int8_weight_scale();
+        for (auto output = 0 ; output < numberOutputs ; output++)
+        {
+            auto* weights = weightsBlob->mutable_data()->mutable_data() + output * weightsPerOutput;
+            auto maxWeight = 0.f;
+            for (auto i = 0 ; i < weightsPerOutput ; i++)
+                maxWeight = std::max(maxWeight, std::abs(weights[i]));
+            const auto weightScale = (maxWeight > 0.f ? maxWeight / 127.f : 1.f);
+            convolutionParameter->add_int8_weight_scale(weightScale);
+            for (auto i = 0 ; i < weightsPerOutput ; i++)
+                weights[i] = quantize(weights[i], weightScale);
+        }
+    }
+    caffe::WriteProtoToBinaryFile(netParameter, outputModel);
+    op::log(std::to_string(inputScales.size()) + " INT8 convolutions saved in " + outputModel + ".",
+            op::Priority::High);
+
+    // Float vs. INT8 network outputs on the calibration frames
+    caffe::Net<float> int8CaffeNet{caffeProto, caffe::TEST};
+    int8CaffeNet.CopyTrainedLayersFrom(netParameter);
+    for (const auto& inputScale : inputScales)
+    {
+        const auto& convolutionParameter = layerParameters.at(caffeNet.layer_names()[inputScale.first])
+                                                          ->convolution_param();
+        auto* convolutionLayer = dynamic_cast<caffe::ConvolutionLayer<float>*>(
+            int8CaffeNet.layer_by_name(caffeNet.layer_names()[inputScale.first]).get());
+        convolutionLayer->set_int8_scales(convolutionParameter.int8_input_scale(),
+                                          std::vector<float>(convolutionParameter.int8_weight_scale().begin(),
+                                                             convolutionParameter.int8_weight_scale().end()));
+    }
+    auto maxError = 0.f;
+    auto sumError = 0.;
+    auto count = 0ull;
+    auto floatSeconds = 0.;
+    auto int8Seconds = 0.;
+    for (const auto& input : inputs)
+    {
+        setNetInput(caffeNet, input);
+        setNetInput(int8CaffeNet, input);
+        const auto floatBegin = std::chrono::high_resolution_clock::now();
+        caffeNet.Forward();
+        const auto int8Begin = std::chrono::high_resolution_clock::now();
+        int8CaffeNet.Forward();
+        const auto int8End = std::chrono::high_resolution_clock::now();
+        floatSeconds += std::chrono::duration_cast<std::chrono::nanoseconds>(int8Begin - floatBegin).count() * 1e-9;
+        int8Seconds += std::chrono::duration_cast<std::chrono::nanoseconds>(int8End - int8Begin).count() * 1e-9;
+        const auto& floatOutput = *caffeNet.blob_by_name("net_output");
+        const auto& int8Output = *int8CaffeNet.blob_by_name("net_output");
+        for (auto i = 0 ; i < floatOutput.count() ; i++)
+        {
+            const auto error = std::abs(floatOutput.cpu_data()[i] - int8Output.cpu_data()[i]);
+            maxError = std::max(maxError, error);
+            sumError += error;
+        }
+        count += floatOutput.count();
+    }
+    op::log("Network output (heat maps and PAFs) difference on the calibration frames: mean = "
+            + std::to_string(sumError / count) + ", max = " + std::to_string(maxError) + ". Forward time: float = "
+            + std::to_string(1e3 * floatSeconds / inputs.size()) + " ms, INT8 = "
+            + std::to_string(1e3 * int8Seconds / inputs.size()) + " ms.", op::Priority::High);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    // Parsing command line flags
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+    // Running int8Calibration
+    return int8Calibration();
+}
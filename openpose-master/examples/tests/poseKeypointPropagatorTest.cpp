@@ -0,0 +1,148 @@
+// ------------------------- OpenPose Library Tutorial - Keyframe Keypoint Propagation Test -------------------------
+// Test of op::PoseKeypointPropagator on synthetic frames (no Caffe network, camera or GUI required): keypoints
+// propagated on a moving texture, frames reused by the motion gating, and people leaving the scene. It returns 0
+// if all the checks pass.
+
+#include <cmath> // std::abs
+// GFlags: DEFINE_bool, _int32, _int64, _uint64, _double, _string
+#include <gflags/gflags.h>
+// Allow Google Flags in Ubuntu 14
+#ifndef GFLAGS_GFLAGS_H_
+    namespace gflags = google;
+#endif
+#include <opencv2/imgproc/imgproc.hpp> // cv::GaussianBlur
+#include <openpose/headers.hpp>
+
+// Debugging
+DEFINE_int32(logging_level,             3,              "The logging level. Integer in the range [0, 255]. 0 will output any log() message, while"
+                                                        " 255 will not output any. Current OpenPose library messages are in the range 0-4: 1 for"
+                                                        " low priority messages and 4 for important ones.");
+
+// Frame size and maximum shift of the synthetic frames
+const auto FRAME_WIDTH = 320;
+const auto FRAME_HEIGHT = 240;
+const auto MAX_SHIFT = 40;
+// Maximum error (in pixels) of the propagated keypoints
+const auto MAX_ERROR = 1.f;
+
+int sFailures = 0;
+
+void checkTest(const bool condition, const std::string& message)
+{
+    if (!condition)
+    {
+        op::log("FAILED: " + message, op::Priority::High);
+        sFailures++;
+    }
+}
+
+// Crop of the texture moved by shift pixels to the left (the content moves shift pixels to the right)
+cv::Mat getFrame(const cv::Mat& texture, const int shift)
+{
+    return texture(cv::Rect{MAX_SHIFT - shift, 0, FRAME_WIDTH, FRAME_HEIGHT}).clone();
+}
+
+// 1 person with 3 keypoints
+op::Array<float> getPerson()
+{
+    op::Array<float> poseKeypoints{{1, 3, 3}, 0.f};
+    const float keypoints[] = {100.f, 80.f, 0.9f,   160.f, 120.f, 0.8f,   200.f, 160.f, 0.7f};
+    for (auto i = 0 ; i < 9 ; i++)
+        poseKeypoints[i] = keypoints[i];
+    return poseKeypoints;
+}
+
+bool isShifted(const op::Array<float>& poseKeypoints, const op::Array<float>& keyframeKeypoints, const int shift)
+{
+    if (poseKeypoints.getVolume() != keyframeKeypoints.getVolume())
+        return false;
+    for (auto keypoint = 0 ; keypoint < (int)poseKeypoints.getVolume() / 3 ; keypoint++)
+        if (std::abs(poseKeypoints[3*keypoint] - keyframeKeypoints[3*keypoint] - shift) > MAX_ERROR
+            || std::abs(poseKeypoints[3*keypoint+1] - keyframeKeypoints[3*keypoint+1]) > MAX_ERROR
+            || poseKeypoints[3*keypoint+2] <= 0.f)
+            return false;
+    return true;
+}
+
+void testPropagation(const cv::Mat& texture)
+{
+    op::PoseKeypointPropagator poseKeypointPropagator{10};
+    op::Array<float> poseKeypoints;
+    const auto person = getPerson();
+    checkTest(!poseKeypointPropagator.propagate(poseKeypoints, getFrame(texture, 0)), "First frame is a keyframe.");
+    poseKeypointPropagator.setKeyframe(person);
+    checkTest(poseKeypointPropagator.propagate(poseKeypoints, getFrame(texture, 2)), "Frame 1 is propagated.");
+    checkTest(isShifted(poseKeypoints, person, 2), "Frame 1 keypoints follow the texture.");
+    // Motion gating: the reused frame is the start of the next optical flow
+    poseKeypointPropagator.setReusedFrame(getFrame(texture, 2));
+    checkTest(poseKeypointPropagator.propagate(poseKeypoints, getFrame(texture, 4)), "Frame 3 is propagated.");
+    checkTest(isShifted(poseKeypoints, person, 4), "Frame 3 keypoints follow the texture.");
+    checkTest(std::abs(poseKeypoints[2] - 0.5f * person[2]) < 1e-6f, "Propagated scores are scaled.");
+}
+
+void testPeopleLeaving(const cv::Mat& texture)
+{
+    op::PoseKeypointPropagator poseKeypointPropagator{2};
+    op::Array<float> poseKeypoints;
+    // Keyframe with 1 person and propagated frame (it fills the optical flow buffers)
+    poseKeypointPropagator.propagate(poseKeypoints, getFrame(texture, 0));
+    poseKeypointPropagator.setKeyframe(getPerson());
+    checkTest(poseKeypointPropagator.propagate(poseKeypoints, getFrame(texture, 1)), "Person is propagated.");
+    // The person leaves the scene: the next keyframes have no people, so nothing can be propagated
+    checkTest(!poseKeypointPropagator.propagate(poseKeypoints, getFrame(texture, 2)), "Interval keyframe.");
+    poseKeypointPropagator.setKeyframe(op::Array<float>{});
+    for (auto frame = 3 ; frame < 6 ; frame++)
+    {
+        poseKeypoints = op::Array<float>{};
+        checkTest(!poseKeypointPropagator.propagate(poseKeypoints, getFrame(texture, frame)),
+                  "Frame " + std::to_string(frame) + " without people is a keyframe.");
+        checkTest(poseKeypoints.empty(), "Frame " + std::to_string(frame) + " keypoints are not modified.");
+        poseKeypointPropagator.setKeyframe(op::Array<float>{});
+    }
+    // The person comes back
+    const auto person = getPerson();
+    checkTest(!poseKeypointPropagator.propagate(poseKeypoints, getFrame(texture, 6)), "Frame 6 is a keyframe.");
+    poseKeypointPropagator.setKeyframe(person);
+    checkTest(poseKeypointPropagator.propagate(poseKeypoints, getFrame(texture, 7)), "Frame 7 is propagated.");
+    checkTest(isShifted(poseKeypoints, person, 1), "Frame 7 keypoints follow the texture.");
+}
+
+int poseKeypointPropagatorTest()
+{
+    try
+    {
+        // logging_level
+        op::check(0 <= FLAGS_logging_level && FLAGS_logging_level <= 255, "Wrong logging_level value.",
+                  __LINE__, __FUNCTION__, __FILE__);
+        op::ConfigureLog::setPriorityThreshold((op::Priority)FLAGS_logging_level);
+        // Smooth random texture (trackable by the optical flow)
+        cv::Mat texture{FRAME_HEIGHT, FRAME_WIDTH + MAX_SHIFT, CV_8UC3};
+        cv::RNG rng{12345};
+        rng.fill(texture, cv::RNG::UNIFORM, 0, 256);
+        cv::GaussianBlur(texture, texture, cv::Size{5, 5}, 0);
+        // Tests
+        testPropagation(texture);
+        testPeopleLeaving(texture);
+        if (sFailures > 0)
+        {
+            op::log(std::to_string(sFailures) + " check(s) failed.", op::Priority::High);
+            return -1;
+        }
+        op::log("All the checks passed.", op::Priority::High);
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        return -1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Parsing command line flags
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+    // Running poseKeypointPropagatorTest
+    return poseKeypointPropagatorTest();
+}
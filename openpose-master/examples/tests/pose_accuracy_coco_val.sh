@@ -25,6 +25,9 @@ $OP_BIN --image_dir $IMAGE_FOLDER --write_coco_json ${JSON_FOLDER}1.json --no_di
     # 1 scale - Debugging
 # $OP_BIN --image_dir $IMAGE_FOLDER --write_coco_json ${JSON_FOLDER}1.json --no_display --write_images ~/Desktop/CppValidation/
 
+#     # 1 scale - INT8 (models/pose/coco/pose_iter_440000_int8.caffemodel from ./build/examples/tests/int8Calibration.bin, CPU version), compare with 1.json
+# $OP_BIN --image_dir $IMAGE_FOLDER --write_coco_json ${JSON_FOLDER}1_int8.json --no_display --render_pose 0 --int8_inference
+
 #     # 3 scales
 # $OP_BIN --image_dir $IMAGE_FOLDER --write_coco_json ${JSON_FOLDER}1_3.json --no_display --render_pose 0 --scale_number 3 --scale_gap 0.25
 
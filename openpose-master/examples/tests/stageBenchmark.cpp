@@ -0,0 +1,382 @@
+// ------------------------- OpenPose Library Tutorial - Stage Micro-Benchmark -------------------------
+// Benchmark of each pipeline stage in isolation (no Caffe network, camera or GUI required), on either a recorded
+// image or synthetic data. For each stage, it prints ns/op, and the bytes/op and allocations/op of operator new only
+// (cv::Mat buffers come from cv::fastMalloc and are not counted). It can save the results as JSON, so regressions
+// can be compared across commits. With --model_folder, it also compares the multi-scale pose network run scale
+// after scale or with concurrent scales (CPU version). E.g.:
+//     ./build/examples/tests/stageBenchmark.bin --label $(git rev-parse --short HEAD) --output_json bench.json
+
+#include <algorithm> // std::max_element
+#include <atomic>
+#include <chrono> // `std::chrono::` functions and classes, e.g. std::chrono::milliseconds
+#include <cmath> // std::ceil, std::exp
+#include <cstdlib> // std::malloc, std::free
+#include <fstream>
+#include <new> // std::bad_alloc
+#include <random>
+#include <thread>
+// GFlags: DEFINE_bool, _int32, _int64, _uint64, _double, _string
+#include <gflags/gflags.h>
+// Allow Google Flags in Ubuntu 14
+#ifndef GFLAGS_GFLAGS_H_
+    namespace gflags = google;
+#endif
+#include <openpose/headers.hpp>
+
+// Debugging
+DEFINE_int32(logging_level,             3,              "The logging level. Integer in the range [0, 255]. 0 will output any log() message, while"
+                                                        " 255 will not output any. Current OpenPose library messages are in the range 0-4: 1 for"
+                                                        " low priority messages and 4 for important ones.");
+// Input
+DEFINE_string(image_path,               "",             "Recorded frame to benchmark on. If empty, a synthetic 1280x720 frame is used.");
+DEFINE_string(net_resolution,           "656x368",      "Multiples of 16. Same meaning than in the OpenPose demo.");
+DEFINE_int32(num_people,                5,              "Number of synthetic people drawn into the heat maps.");
+DEFINE_int32(seed,                      0,              "Random seed for the synthetic data (same seed -> same data).");
+// Benchmark
+DEFINE_int32(iterations,                100,            "Number of timed iterations per stage.");
+DEFINE_int32(warm_up,                   5,              "Number of untimed iterations per stage.");
+DEFINE_string(write_folder,             "/tmp/",        "Folder where the JSON/YAML savers write their files.");
+DEFINE_string(label,                    "",             "Label stored with the results (e.g. the commit hash).");
+DEFINE_string(output_json,              "",             "If not empty, machine-readable results are saved in this JSON file.");
+// Multi-scale pose network
+DEFINE_string(model_folder,             "",             "If not empty, folder of the pose models, and the multi-scale pose network is also benchmarked"
+                                                        " (sequential vs concurrent scales, as PoseExtractorCaffe in the CPU version).");
+DEFINE_int32(scale_number,              2,              "Number of scales of the multi-scale pose network benchmark.");
+DEFINE_double(scale_gap,                0.3,            "Scale gap between scales, same meaning than in the OpenPose demo.");
+
+// operator new usage counters (replaced global operator new/delete). The cv::Mat buffers are not counted
+std::atomic<unsigned long long> sAllocatedBytes{0ull};
+std::atomic<unsigned long long> sAllocations{0ull};
+
+void* operator new(std::size_t size)
+{
+    sAllocatedBytes += size;
+    sAllocations++;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+struct BenchmarkResult
+{
+    std::string name;
+    int iterations;
+    double nsPerOp;
+    double bytesPerOp;
+    double allocationsPerOp;
+};
+
+template <typename TFunction>
+BenchmarkResult benchmark(const std::string& name, const TFunction& function)
+{
+    for (auto i = 0 ; i < FLAGS_warm_up ; i++)
+        function();
+    const unsigned long long bytesBegin = sAllocatedBytes;
+    const unsigned long long allocationsBegin = sAllocations;
+    const auto timerBegin = std::chrono::high_resolution_clock::now();
+    for (auto i = 0 ; i < FLAGS_iterations ; i++)
+        function();
+    const auto totalNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now() - timerBegin
+    ).count();
+    const auto iterations = std::max(1, FLAGS_iterations);
+    const BenchmarkResult result{name, iterations, totalNs / iterations,
+                                 (double)(sAllocatedBytes - bytesBegin) / iterations,
+                                 (double)(sAllocations - allocationsBegin) / iterations};
+    op::log(name + ": " + std::to_string(result.nsPerOp) + " ns/op, " + std::to_string(result.bytesPerOp)
+            + " new bytes/op, " + std::to_string(result.allocationsPerOp) + " new allocs/op", op::Priority::High);
+    return result;
+}
+
+// Synthetic network output: Gaussian peaks on each body part and unit vectors along each limb on each PAF channel
+std::vector<float> createSyntheticNetOutput(const op::PoseModel poseModel, const int numberChannels,
+                                            const int width, const int height, const int numberPeople,
+                                            const int seed)
+{
+    std::vector<float> netOutput(numberChannels * width * height, 0.f);
+    const auto numberBodyParts = (int)op::getPoseNumberBodyParts(poseModel);
+    const auto& bodyPartPairs = op::getPosePartPairs(poseModel);
+    const auto& mapIdx = op::getPoseMapIndex(poseModel);
+    const auto channelOffset = width * height;
+    std::mt19937 generator{(unsigned int)seed};
+    std::uniform_real_distribution<float> center{0.2f, 0.8f};
+    std::uniform_real_distribution<float> offset{-0.1f, 0.1f};
+    for (auto person = 0 ; person < numberPeople ; person++)
+    {
+        const auto centerX = center(generator) * width;
+        const auto centerY = center(generator) * height;
+        std::vector<cv::Point2f> parts(numberBodyParts);
+        for (auto part = 0 ; part < numberBodyParts ; part++)
+            parts[part] = {centerX + offset(generator) * width, centerY + offset(generator) * height};
+        // Heat maps
+        for (auto part = 0 ; part < numberBodyParts ; part++)
+        {
+            auto* heatMapPtr = netOutput.data() + part * channelOffset;
+            for (auto y = 0 ; y < height ; y++)
+                for (auto x = 0 ; x < width ; x++)
+                {
+                    const auto dx = x - parts[part].x;
+                    const auto dy = y - parts[part].y;
+                    heatMapPtr[y*width+x] = std::max(heatMapPtr[y*width+x], std::exp(-(dx*dx + dy*dy) / 2.f));
+                }
+        }
+        // PAFs
+        for (auto pair = 0u ; pair < bodyPartPairs.size() / 2 ; pair++)
+        {
+            const auto& partA = parts[bodyPartPairs[2*pair]];
+            const auto& partB = parts[bodyPartPairs[2*pair+1]];
+            const auto norm = std::max(1e-3f, (float)cv::norm(partB - partA));
+            const cv::Point2f direction{(partB.x - partA.x) / norm, (partB.y - partA.y) / norm};
+            auto* pafXPtr = netOutput.data() + mapIdx[2*pair] * channelOffset;
+            auto* pafYPtr = netOutput.data() + mapIdx[2*pair+1] * channelOffset;
+            const auto numberSteps = (int)std::ceil(norm) + 1;
+            for (auto step = 0 ; step <= numberSteps ; step++)
+            {
+                const auto x = op::intRound(partA.x + (partB.x - partA.x) * step / numberSteps);
+                const auto y = op::intRound(partA.y + (partB.y - partA.y) * step / numberSteps);
+                if (0 <= x && x < width && 0 <= y && y < height)
+                {
+                    pafXPtr[y*width+x] = direction.x;
+                    pafYPtr[y*width+x] = direction.y;
+                }
+            }
+        }
+    }
+    return netOutput;
+}
+
+void saveResultsJson(const std::vector<BenchmarkResult>& results, const std::string& path)
+{
+    std::ofstream jsonFile{path};
+    jsonFile << "{\n  \"label\": \"" << FLAGS_label << "\",\n  \"net_resolution\": \"" << FLAGS_net_resolution
+             << "\",\n  \"task_pool_threads\": " << op::TaskPool::getInstance().getNumberThreads()
+             << ",\n  \"results\": [\n";
+    for (auto i = 0u ; i < results.size() ; i++)
+    {
+        const auto& result = results[i];
+        jsonFile << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+                 << ", \"ns_per_op\": " << result.nsPerOp << ", \"new_bytes_per_op\": " << result.bytesPerOp
+                 << ", \"new_allocs_per_op\": " << result.allocationsPerOp << "}"
+                 << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    jsonFile << "  ]\n}\n";
+}
+
+int stageBenchmark()
+{
+    // logging_level
+    op::check(0 <= FLAGS_logging_level && FLAGS_logging_level <= 255, "Wrong logging_level value.",
+              __LINE__, __FUNCTION__, __FILE__);
+    op::ConfigureLog::setPriorityThreshold((op::Priority)FLAGS_logging_level);
+    op::log("Starting stage benchmark.", op::Priority::High);
+
+    // Input frame
+    cv::Mat frame;
+    if (!FLAGS_image_path.empty())
+        frame = op::loadImage(FLAGS_image_path, CV_LOAD_IMAGE_COLOR);
+    else
+    {
+        frame = cv::Mat{720, 1280, CV_8UC3};
+        // cv::RNG maps the seed 0 to a non-zero state (a zero state only generates zeros)
+        cv::RNG rng{(uint64)FLAGS_seed};
+        rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+    }
+    if (frame.empty())
+        op::error("Could not open or find the image: " + FLAGS_image_path, __LINE__, __FUNCTION__, __FILE__);
+    const op::Point<int> frameSize{frame.cols, frame.rows};
+
+    // Sizes
+    const auto poseModel = op::PoseModel::COCO_18;
+    const auto netInputSize = op::flagsToPoint(FLAGS_net_resolution, "656x368");
+    const auto netDecreaseFactor = op::getPoseNetDecreaseFactor(poseModel);
+    const op::Point<int> netOutputSize{op::intRound(netInputSize.x / netDecreaseFactor),
+                                       op::intRound(netInputSize.y / netDecreaseFactor)};
+    const auto& mapIdx = op::getPoseMapIndex(poseModel);
+    const auto numberChannels = (int)*std::max_element(mapIdx.begin(), mapIdx.end()) + 1;
+    const auto numberBodyParts = (int)op::getPoseNumberBodyParts(poseModel);
+    const auto maxPeaks = (int)op::getPoseMaxPeaks(poseModel);
+    const auto scaleInputToNetInput = std::min(netInputSize.x / (double)frameSize.x,
+                                               netInputSize.y / (double)frameSize.y);
+    const auto scaleNetToOutput = 1. / scaleInputToNetInput;
+
+    // Data shared among stages
+    const auto netOutput = createSyntheticNetOutput(poseModel, numberChannels, netOutputSize.x, netOutputSize.y,
+                                                    FLAGS_num_people, FLAGS_seed);
+    std::vector<float> heatMaps(numberChannels * netInputSize.area());
+    std::vector<float> peaks(numberBodyParts * (maxPeaks+1) * 3);
+    std::vector<int> nmsKernel(numberBodyParts * netInputSize.area());
+    op::Array<float> poseKeypoints;
+    op::Array<float> poseScores;
+    op::Array<float> frameArray{{3, frameSize.y, frameSize.x}, 0.f};
+    std::vector<BenchmarkResult> results;
+
+    // 1. cv::Mat to network input
+    const op::CvMatToOpInput cvMatToOpInput;
+    results.emplace_back(benchmark("CvMatToOpInput", [&]
+    {
+        cvMatToOpInput.createArray(frame, {scaleInputToNetInput}, {netInputSize});
+    }));
+    // 2. Resize and merge (network output -> network input resolution)
+    results.emplace_back(benchmark("resizeAndMergeCpu", [&]
+    {
+        op::resizeAndMergeCpu(heatMaps.data(), std::vector<const float*>{netOutput.data()},
+                              {1, numberChannels, netInputSize.y, netInputSize.x},
+                              {{1, numberChannels, netOutputSize.y, netOutputSize.x}}, {1.f});
+    }));
+    // 3. Non-maximum suppression
+    const auto nmsThreshold = op::getPoseDefaultNmsThreshold(poseModel);
+    results.emplace_back(benchmark("nmsCpu", [&]
+    {
+        op::nmsCpu(peaks.data(), nmsKernel.data(), heatMaps.data(), nmsThreshold,
+                   {1, numberBodyParts, maxPeaks+1, 3}, {1, numberBodyParts, netInputSize.y, netInputSize.x});
+    }));
+    // 4. Body part connection
+    results.emplace_back(benchmark("connectBodyPartsCpu", [&]
+    {
+        op::connectBodyPartsCpu(poseKeypoints, poseScores, heatMaps.data(), peaks.data(), poseModel,
+                                netInputSize, maxPeaks, op::getPoseDefaultConnectInterMinAboveThreshold(poseModel),
+                                op::getPoseDefaultConnectInterThreshold(poseModel),
+                                (int)op::getPoseDefaultMinSubsetCnt(poseModel),
+                                op::getPoseDefaultConnectMinSubsetScore(poseModel), (float)scaleNetToOutput);
+    }));
+    op::log("Detected people: " + std::to_string(poseKeypoints.getSize(0)), op::Priority::High);
+    // 5. Keypoint scaling (including the copy of the keypoints)
+    const op::KeypointScaler keypointScaler{op::ScaleMode::ZeroToOne};
+    results.emplace_back(benchmark("KeypointScaler", [&]
+    {
+        auto poseKeypointsScaled = poseKeypoints.clone();
+        keypointScaler.scale(poseKeypointsScaled, 1., 1., frameSize);
+    }));
+    // 6. Rendering
+    results.emplace_back(benchmark("renderPoseKeypointsCpu", [&]
+    {
+        op::renderPoseKeypointsCpu(frameArray, poseKeypoints, poseModel, 0.05f);
+    }));
+    // 7. Savers
+    const op::KeypointSaver jsonSaver{FLAGS_write_folder, op::DataFormat::Json};
+    results.emplace_back(benchmark("KeypointSaver_json", [&]
+    {
+        jsonSaver.saveKeypoints({poseKeypoints}, "stage_benchmark", "pose");
+    }));
+    const op::KeypointSaver yamlSaver{FLAGS_write_folder, op::DataFormat::Yaml};
+    results.emplace_back(benchmark("KeypointSaver_yaml", [&]
+    {
+        yamlSaver.saveKeypoints({poseKeypoints}, "stage_benchmark", "pose");
+    }));
+    const op::KeypointJsonSaver keypointJsonSaver{FLAGS_write_folder};
+    results.emplace_back(benchmark("KeypointJsonSaver", [&]
+    {
+        keypointJsonSaver.save({std::make_pair(poseKeypoints, std::string{"pose_keypoints"})}, "stage_benchmark");
+    }));
+    // 8. Queue hops (1 frame = 1 emplace + 1 pop)
+    typedef std::shared_ptr<std::vector<op::Datum>> TDatumsPtr;
+    op::Queue<TDatumsPtr> queue{-1};
+    results.emplace_back(benchmark("queueHop_sameThread", [&]
+    {
+        auto datums = std::make_shared<std::vector<op::Datum>>(1);
+        queue.waitAndEmplace(datums);
+        queue.waitAndPop(datums);
+    }));
+    op::Queue<TDatumsPtr> queueIn{2};
+    op::Queue<TDatumsPtr> queueOut{2};
+    queueIn.addPusher();
+    queueOut.addPusher();
+    std::thread echoThread{[&]
+    {
+        TDatumsPtr datums;
+        while (queueIn.waitAndPop(datums))
+            queueOut.waitAndEmplace(datums);
+    }};
+    results.emplace_back(benchmark("queueHop_roundTrip", [&]
+    {
+        auto datums = std::make_shared<std::vector<op::Datum>>(1);
+        queueIn.waitAndEmplace(datums);
+        queueOut.waitAndPop(datums);
+    }));
+    queueIn.stop();
+    echoThread.join();
+    // 9. Multi-scale pose network: 1 net per scale, run one after the other with all the cores or at the same time
+    // with the cores split between them
+    if (!FLAGS_model_folder.empty())
+    {
+        const auto numberScales = std::max(1, FLAGS_scale_number);
+        std::vector<std::shared_ptr<op::NetCaffe>> caffeNets;
+        std::vector<op::Array<float>> inputNetData;
+        for (auto i = 0 ; i < numberScales ; i++)
+        {
+            const auto scale = 1. - i * FLAGS_scale_gap;
+            const op::Point<int> scaleNetInputSize{16 * std::max(1, op::intRound(netInputSize.x * scale / 16.)),
+                                                   16 * std::max(1, op::intRound(netInputSize.y * scale / 16.))};
+            inputNetData.emplace_back(cvMatToOpInput.createArray(
+                frame, {scaleInputToNetInput * scaleNetInputSize.x / netInputSize.x}, {scaleNetInputSize}
+            ).at(0));
+            caffeNets.emplace_back(std::make_shared<op::NetCaffe>(
+                FLAGS_model_folder + op::getPoseProtoTxt(poseModel),
+                FLAGS_model_folder + op::getPoseTrainedModel(poseModel), 0, false
+            ));
+            caffeNets.back()->initializationOnThread();
+        }
+        const auto numberCores = std::max(1, (int)std::thread::hardware_concurrency());
+        for (auto& caffeNet : caffeNets)
+            caffeNet->setIntraOpThreads(numberCores);
+        const auto sequential = benchmark("poseNetScales_sequential", [&]
+        {
+            for (auto i = 0 ; i < numberScales ; i++)
+                caffeNets[i]->forwardPass(inputNetData[i]);
+        });
+        for (auto& caffeNet : caffeNets)
+            caffeNet->setIntraOpThreads(std::max(1, numberCores / numberScales));
+        const auto concurrent = benchmark("poseNetScales_concurrent", [&]
+        {
+            op::TaskPool::getInstance().parallelFor(
+                "poseNetScales", 0, numberScales,
+                [&](const int scaleBegin, const int scaleEnd)
+                {
+                    for (auto i = scaleBegin ; i < scaleEnd ; i++)
+                        caffeNets[i]->forwardPass(inputNetData[i]);
+                },
+                1
+            );
+        });
+        op::log("Concurrent scales speedup: " + std::to_string(sequential.nsPerOp / concurrent.nsPerOp) + "x ("
+                + std::to_string(numberScales) + " scales, " + std::to_string(numberCores) + " cores)",
+                op::Priority::High);
+        results.emplace_back(sequential);
+        results.emplace_back(concurrent);
+    }
+
+    // Intra-stage parallelism statistics
+    op::TaskPool::getInstance().printStatistics();
+
+    // Machine-readable results
+    if (!FLAGS_output_json.empty())
+    {
+        saveResultsJson(results, FLAGS_output_json);
+        op::log("Results saved in " + FLAGS_output_json, op::Priority::High);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    // Parsing command line flags
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+    // Running stageBenchmark
+    return stageBenchmark();
+}
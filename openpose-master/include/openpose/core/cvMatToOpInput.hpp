@@ -9,9 +9,14 @@ namespace op
     class OP_API CvMatToOpInput
     {
     public:
+        /**
+         * @param netInputRoi If not empty, only this region of cvInputData is fed to the net (scaleInputToNetInputs
+         * and netInputSizes refer to it).
+         */
         std::vector<Array<float>> createArray(const cv::Mat& cvInputData,
                                               const std::vector<double>& scaleInputToNetInputs,
-                                              const std::vector<Point<int>>& netInputSizes) const;
+                                              const std::vector<Point<int>>& netInputSizes,
+                                              const Rectangle<int>& netInputRoi = Rectangle<int>{}) const;
     };
 }
 
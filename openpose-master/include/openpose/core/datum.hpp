@@ -152,6 +152,25 @@ namespace op
          */
         std::vector<Point<int>> netInputSizes;
 
+        /**
+         * Net input resolution chosen for this frame by the adaptive net resolution (see NetResolutionController).
+         * {0, 0} if the net input resolution is fixed.
+         */
+        Point<int> netInputResolution;
+
+        /**
+         * Region of Datum::cvInputData fed to the pose deep net (ROI-cropped inference, see InputRoiTracker).
+         * scaleInputToNetInputs and netInputSizes refer to this region, while the keypoints are given in
+         * Datum::cvInputData coordinates. Empty (area 0) if the full frame is used.
+         */
+        Rectangle<int> netInputRoi;
+
+        /**
+         * Whether the pose of the previous frame is reused for this one (motion gating, see MotionGate): the pose
+         * network is skipped and inputNetData is empty.
+         */
+        bool poseReused;
+
         /**
          * Scale ratio between the input Datum::cvInputData and the output Datum::cvOutputData.
          */
@@ -9,10 +9,13 @@
 #include <openpose/core/datum.hpp>
 #include <openpose/core/enumClasses.hpp>
 #include <openpose/core/gpuRenderer.hpp>
+#include <openpose/core/inputRoiTracker.hpp>
 #include <openpose/core/keypointScaler.hpp>
 #include <openpose/core/macros.hpp>
+#include <openpose/core/motionGate.hpp>
 #include <openpose/core/net.hpp>
 #include <openpose/core/netCaffe.hpp>
+#include <openpose/core/netResolutionController.hpp>
 #include <openpose/core/nmsBase.hpp>
 #include <openpose/core/nmsCaffe.hpp>
 #include <openpose/core/opOutputToCvMat.hpp>
@@ -0,0 +1,54 @@
+#ifndef OPENPOSE_CORE_INPUT_ROI_TRACKER_HPP
+#define OPENPOSE_CORE_INPUT_ROI_TRACKER_HPP
+
+#include <mutex>
+#include <openpose/core/common.hpp>
+
+namespace op
+{
+    /**
+     * ROI-cropped inference: instead of the full frame, the pose network is fed with a padded region around the
+     * people found in the last processed frames, so it spends its input pixels on the people rather than on the
+     * background (i.e., higher effective resolution for the same net input size).
+     * The full frame is used (re-detection) every fullFrameInterval frames, when no people were found or when some
+     * of them were lost inside the ROI.
+     * getRoi() is called by WScaleAndSizeExtractor and update() by WPoseExtractor, possibly from different threads
+     * and a few frames apart, which the padding must absorb.
+     */
+    class OP_API InputRoiTracker
+    {
+    public:
+        /**
+         * @param fullFrameInterval The full frame is processed at least once every fullFrameInterval frames.
+         * @param padding Padding added to each side of the people bounding box, relative to its size.
+         * @param maxRoiAreaRatio If the ROI covers more than this ratio of the frame area, the full frame is used.
+         * @param keypointThreshold Minimum score of a keypoint to be included in the people bounding box.
+         */
+        InputRoiTracker(const int fullFrameInterval = 30, const float padding = 0.3f,
+                        const float maxRoiAreaRatio = 0.6f, const float keypointThreshold = 0.05f);
+
+        /**
+         * ROI of the next frame to be fed to the pose network, or an empty Rectangle (area 0) for the full frame.
+         */
+        Rectangle<int> getRoi(const Point<int>& inputSize);
+
+        /**
+         * Pose keypoints (in full frame coordinates) of a frame processed with the given ROI (getRoi()).
+         */
+        void update(const Array<float>& poseKeypoints, const Rectangle<int>& roi);
+
+    private:
+        const int mFullFrameInterval;
+        const float mPadding;
+        const float mMaxRoiAreaRatio;
+        const float mKeypointThreshold;
+        std::mutex mMutex;
+        int mFramesSinceFullFrame;
+        int mNumberPeople;
+        Rectangle<float> mPeopleRectangle;
+
+        DELETE_COPY(InputRoiTracker);
+    };
+}
+
+#endif // OPENPOSE_CORE_INPUT_ROI_TRACKER_HPP
@@ -0,0 +1,44 @@
+#ifndef OPENPOSE_CORE_MOTION_GATE_HPP
+#define OPENPOSE_CORE_MOTION_GATE_HPP
+
+#include <opencv2/core/core.hpp> // cv::Mat
+#include <openpose/core/common.hpp>
+
+namespace op
+{
+    /**
+     * Motion gating: the frames that barely differ from the last processed one (e.g., an empty room or a static
+     * person) skip the pose network and reuse the keypoints of the previous frame.
+     * The motion score is the mean absolute difference ([0, 255]) between a downsampled gray version of the frame
+     * and the one of the last processed frame (so slow changes accumulate until they trigger the network).
+     * The frames must be given in order.
+     */
+    class OP_API MotionGate
+    {
+    public:
+        /**
+         * @param motionThreshold Frames with a motion score lower or equal than this threshold are skipped.
+         * @param maxReusedFrames The pose network is run at least once every maxReusedFrames + 1 frames.
+         * @param thumbnailWidth Width of the downsampled frames compared.
+         */
+        MotionGate(const float motionThreshold, const int maxReusedFrames = 30, const int thumbnailWidth = 64);
+
+        /**
+         * It must be called for every frame. If it returns true, the pose network can be skipped for cvInputData
+         * (i.e., the keypoints of the previous frame are reused).
+         */
+        bool isStatic(const cv::Mat& cvInputData);
+
+    private:
+        const float mMotionThreshold;
+        const int mMaxReusedFrames;
+        const int mThumbnailWidth;
+        int mReusedFrames;
+        cv::Mat mThumbnail;
+        cv::Mat mProcessedThumbnail;
+
+        DELETE_COPY(MotionGate);
+    };
+}
+
+#endif // OPENPOSE_CORE_MOTION_GATE_HPP
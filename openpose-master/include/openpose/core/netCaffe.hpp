@@ -6,20 +6,91 @@
 
 namespace op
 {
+    /**
+     * Per-layer statistics of the NetCaffe forward passes (see NetCaffe::setLayerProfiling).
+     */
+    struct OP_API LayerStatistics
+    {
+        std::string name;
+        std::string type;
+        unsigned long long calls;
+        double totalMs;
+        double maxMs;
+        unsigned long long outputBytes;
+        std::vector<int> outputShape;
+    };
+
+    /**
+     * Caffe network wrapper. The trained weights are loaded once per process (and GPU) and shared read-only by all
+     * the NetCaffe instances using the same prototxt and model, while each instance keeps its own activations.
+     * The trained model can be either a .caffemodel or a flat file written by convert_caffemodel_to_flat (Caffe
+     * tools), which is memory-mapped and used in place (no parsing nor copy of the weights at load time). If a flat
+     * file with the same name and the `.flat` extension exists beside the .caffemodel (e.g.,
+     * models/pose/coco/pose_iter_440000.flat), it is loaded instead, so the default model paths pick it up.
+     */
     class OP_API NetCaffe : public Net
     {
     public:
+        /**
+         * @param planMemory If true (default), the intermediate blobs whose lifetimes do not overlap share a single
+         * memory arena (inference only: their diffs are never allocated and their data is only valid while it is
+         * used by the forward pass). Only the input blob and the lastBlobName blob keep their own memory.
+         * @param intraOpThreads Number of threads of the Caffe CPU layers run by the thread calling
+         * initializationOnThread(), forwardPass() or forwardPassRemaining() (Caffe::set_cpu_threads). 0 (default)
+         * keeps the OpenMP default.
+         * @param earlyExitBlobNames If not empty, forwardPass() stops as soon as these blobs are computed and
+         * getOutputBlob() is their concatenation along the channels (in the given order), e.g. the outputs of an
+         * intermediate stage with the same channels than lastBlobName. forwardPassRemaining() can then complete the
+         * forward pass if required.
+         * @param interOpThreads Maximum number of independent layers (e.g., the L1 and L2 branches of the pose
+         * stages) run at the same time on the CPU (caffe::LayerScheduler), splitting the intraOpThreads between
+         * them. 1 (default) runs the layers sequentially. Ignored by the GPU version.
+         */
         NetCaffe(const std::string& caffeProto, const std::string& caffeTrainedModel, const int gpuId = 0,
-                 const bool enableGoogleLogging = true, const std::string& lastBlobName = "net_output");
+                 const bool enableGoogleLogging = true, const std::string& lastBlobName = "net_output",
+                 const bool planMemory = true, const int intraOpThreads = 0,
+                 const std::vector<std::string>& earlyExitBlobNames = {}, const int interOpThreads = 1);
 
         virtual ~NetCaffe();
 
         void initializationOnThread();
 
+        /**
+         * It can be called from a thread other than the one calling initializationOnThread() (e.g., a TaskPool
+         * thread), but not concurrently on the same instance.
+         */
         void forwardPass(const Array<float>& inputNetData) const;
 
+        /**
+         * After an early-exit forwardPass(), it runs the remaining layers and getOutputBlob() becomes a copy of
+         * lastBlobName. No effect otherwise.
+         */
+        void forwardPassRemaining() const;
+
+        /**
+         * It changes the intraOpThreads of the next forward passes, e.g., to split the cores between several nets
+         * run at the same time. It must not be called during a forward pass of this instance.
+         */
+        void setIntraOpThreads(const int intraOpThreads);
+
         boost::shared_ptr<caffe::Blob<float>> getOutputBlob() const;
 
+        /**
+         * Layer statistics (one element per layer) accumulated since the last report. Empty if the layer profiling
+         * is disabled.
+         */
+        std::vector<LayerStatistics> getLayerStatistics() const;
+
+        /**
+         * Opt-in instrumentation of the forward passes of all the NetCaffe instances (e.g., pose, hand and face
+         * networks): each layer Forward is timed (the layers then run sequentially, with a GPU synchronization after
+         * each of them) and the bytes of its output blobs are recorded.
+         * Every numberFrames forward passes with the same input size, each network logs its layers sorted by time
+         * and, if reportFolder is not empty, it writes them as JSON into reportFolder.
+         * @param numberFrames Number of frames of each report. 0 (default) disables the profiling.
+         */
+        static void setLayerProfiling(const unsigned long long numberFrames, const std::string& reportFolder = "");
+
     private:
         // PIMPL idiom
         // http://www.cppsamples.com/common-tasks/pimpl.html
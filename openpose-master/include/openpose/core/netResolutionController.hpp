@@ -0,0 +1,60 @@
+#ifndef OPENPOSE_CORE_NET_RESOLUTION_CONTROLLER_HPP
+#define OPENPOSE_CORE_NET_RESOLUTION_CONTROLLER_HPP
+
+#include <mutex>
+#include <openpose/core/common.hpp>
+
+namespace op
+{
+    /**
+     * Adaptive net input resolution: closed-loop controller that steps the net input height through a ladder of
+     * multiples of 16 (from the configured net input resolution down to minNetInputHeight) so the pose network
+     * latency stays around targetLatencyMs.
+     * It steps down when the averaged latency is higher than targetLatencyMs * (1 + hysteresis), and it steps up
+     * when the expected latency of the upper step (latency proportional to the net input area) is lower than
+     * targetLatencyMs * (1 - hysteresis). It waits framesPerDecision frames at each step before deciding again.
+     * getNetInputResolution() is called by WScaleAndSizeExtractor and reportLatency() by WPoseExtractor, possibly
+     * from different threads.
+     */
+    class OP_API NetResolutionController
+    {
+    public:
+        /**
+         * @param netInputResolution Maximum net input resolution. Its height must be > 0 and a multiple of 16, its
+         * width can be <= 0 (adapted to the input aspect ratio by ScaleAndSizeExtractor).
+         * @param targetLatencyMs Target pose network latency per frame, in milliseconds.
+         * @param minNetInputHeight Minimum net input height (multiple of 16).
+         * @param heightStep Height difference between consecutive steps of the ladder (multiple of 16).
+         * @param hysteresis Relative band around targetLatencyMs in which the resolution is kept.
+         * @param framesPerDecision Number of frames averaged at each step before stepping again.
+         */
+        NetResolutionController(const Point<int>& netInputResolution, const double targetLatencyMs,
+                                const int minNetInputHeight = 160, const int heightStep = 32,
+                                const double hysteresis = 0.15, const int framesPerDecision = 10);
+
+        /**
+         * Net input resolution for the next frame.
+         */
+        Point<int> getNetInputResolution();
+
+        /**
+         * Pose network latency of a frame processed with the given netInputResolution (getNetInputResolution()).
+         * The frames of a previous step (still in the pipeline after a step change) are ignored.
+         */
+        void reportLatency(const Point<int>& netInputResolution, const double latencyMs);
+
+    private:
+        const double mTargetLatencyMs;
+        const double mHysteresis;
+        const int mFramesPerDecision;
+        std::vector<Point<int>> mLadder;
+        std::mutex mMutex;
+        unsigned int mStep;
+        int mFrames;
+        double mLatencyMs;
+
+        DELETE_COPY(NetResolutionController);
+    };
+}
+
+#endif // OPENPOSE_CORE_NET_RESOLUTION_CONTROLLER_HPP
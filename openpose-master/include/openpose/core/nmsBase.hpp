@@ -5,9 +5,20 @@
 
 namespace op
 {
+    // kernelPtr is only used by nmsGpu (nmsCpu ignores it, so it can be nullptr)
     template <typename T>
     OP_API void nmsCpu(T* targetPtr, int* kernelPtr, const T* const sourcePtr, const T threshold, const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize);
 
+    /**
+     * Same output than nmsCpu, but the peaks of each channel are only searched inside windows[channel] (e.g.,
+     * around the tracked people joints), and channels without windows get no peaks. peakOwnersPtr (same layout than
+     * the peaks, i.e., maxPeaks+1 elements per channel) gets the index of the window where each peak was found.
+     */
+    template <typename T>
+    OP_API void nmsWindowsCpu(T* targetPtr, int* peakOwnersPtr, const T* const sourcePtr, const T threshold,
+                              const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize,
+                              const std::vector<std::vector<Rectangle<int>>>& windows);
+
     template <typename T>
     OP_API void nmsGpu(T* targetPtr, int* kernelPtr, const T* const sourcePtr, const T threshold, const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize);
 }
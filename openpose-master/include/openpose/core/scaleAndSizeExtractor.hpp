@@ -15,6 +15,13 @@ namespace op
         std::tuple<std::vector<double>, std::vector<Point<int>>, double, Point<int>> extract(
             const Point<int>& inputResolution) const;
 
+        /**
+         * Same as extract(inputResolution), but with the given net input resolution instead of the one of the
+         * constructor (e.g., adaptive net resolution, see NetResolutionController).
+         */
+        std::tuple<std::vector<double>, std::vector<Point<int>>, double, Point<int>> extract(
+            const Point<int>& inputResolution, const Point<int>& netInputResolution) const;
+
     private:
         const Point<int> mNetInputResolution;
         const Point<int> mOutputSize;
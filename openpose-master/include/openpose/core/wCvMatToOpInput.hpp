@@ -3,6 +3,7 @@
 
 #include <openpose/core/common.hpp>
 #include <openpose/core/cvMatToOpInput.hpp>
+#include <openpose/core/motionGate.hpp>
 #include <openpose/thread/worker.hpp>
 
 namespace op
@@ -11,7 +12,12 @@ namespace op
     class WCvMatToOpInput : public Worker<TDatums>
     {
     public:
-        explicit WCvMatToOpInput(const std::shared_ptr<CvMatToOpInput>& cvMatToOpInput);
+        /**
+         * @param motionGate If not nullptr, the static frames (see MotionGate) are marked with Datum::poseReused
+         * and their net input is not created.
+         */
+        explicit WCvMatToOpInput(const std::shared_ptr<CvMatToOpInput>& cvMatToOpInput,
+                                 const std::shared_ptr<MotionGate>& motionGate = nullptr);
 
         void initializationOnThread();
 
@@ -19,6 +25,7 @@ namespace op
 
     private:
         const std::shared_ptr<CvMatToOpInput> spCvMatToOpInput;
+        const std::shared_ptr<MotionGate> spMotionGate;
 
         DELETE_COPY(WCvMatToOpInput);
     };
@@ -33,8 +40,10 @@ namespace op
 namespace op
 {
     template<typename TDatums>
-    WCvMatToOpInput<TDatums>::WCvMatToOpInput(const std::shared_ptr<CvMatToOpInput>& cvMatToOpInput) :
-        spCvMatToOpInput{cvMatToOpInput}
+    WCvMatToOpInput<TDatums>::WCvMatToOpInput(const std::shared_ptr<CvMatToOpInput>& cvMatToOpInput,
+                                              const std::shared_ptr<MotionGate>& motionGate) :
+        spCvMatToOpInput{cvMatToOpInput},
+        spMotionGate{motionGate}
     {
     }
 
@@ -56,9 +65,17 @@ namespace op
                 const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
                 // cv::Mat -> float*
                 for (auto& tDatum : *tDatums)
-                    tDatum.inputNetData = spCvMatToOpInput->createArray(tDatum.cvInputData,
-                                                                        tDatum.scaleInputToNetInputs,
-                                                                        tDatum.netInputSizes);
+                {
+                    // Motion gating: no net input for the static frames
+                    tDatum.poseReused = (spMotionGate != nullptr && spMotionGate->isStatic(tDatum.cvInputData));
+                    if (tDatum.poseReused)
+                        tDatum.inputNetData.clear();
+                    else
+                        tDatum.inputNetData = spCvMatToOpInput->createArray(tDatum.cvInputData,
+                                                                            tDatum.scaleInputToNetInputs,
+                                                                            tDatum.netInputSizes,
+                                                                            tDatum.netInputRoi);
+                }
                 // Profiling speed
                 Profiler::timerEnd(profilerKey);
                 Profiler::printAveragedTimeMsOnIterationX(profilerKey, __LINE__, __FUNCTION__, __FILE__);
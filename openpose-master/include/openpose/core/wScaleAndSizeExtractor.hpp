@@ -2,6 +2,8 @@
 #define OPENPOSE_CORE_W_SCALE_AND_SIZE_EXTRACTOR_HPP
 
 #include <openpose/core/common.hpp>
+#include <openpose/core/inputRoiTracker.hpp>
+#include <openpose/core/netResolutionController.hpp>
 #include <openpose/core/scaleAndSizeExtractor.hpp>
 #include <openpose/thread/worker.hpp>
 
@@ -11,7 +13,16 @@ namespace op
     class WScaleAndSizeExtractor : public Worker<TDatums>
     {
     public:
-        explicit WScaleAndSizeExtractor(const std::shared_ptr<ScaleAndSizeExtractor>& scaleAndSizeExtractor);
+        /**
+         * @param inputRoiTracker If not nullptr, the net input is a ROI around the tracked people (see
+         * InputRoiTracker) instead of the full frame.
+         * @param netResolutionController If not nullptr, the net input resolution of each frame is given by it
+         * (adaptive net resolution, see NetResolutionController).
+         */
+        explicit WScaleAndSizeExtractor(
+            const std::shared_ptr<ScaleAndSizeExtractor>& scaleAndSizeExtractor,
+            const std::shared_ptr<InputRoiTracker>& inputRoiTracker = nullptr,
+            const std::shared_ptr<NetResolutionController>& netResolutionController = nullptr);
 
         void initializationOnThread();
 
@@ -19,6 +30,8 @@ namespace op
 
     private:
         const std::shared_ptr<ScaleAndSizeExtractor> spScaleAndSizeExtractor;
+        const std::shared_ptr<InputRoiTracker> spInputRoiTracker;
+        const std::shared_ptr<NetResolutionController> spNetResolutionController;
 
         DELETE_COPY(WScaleAndSizeExtractor);
     };
@@ -33,8 +46,13 @@ namespace op
 namespace op
 {
     template<typename TDatums>
-    WScaleAndSizeExtractor<TDatums>::WScaleAndSizeExtractor(const std::shared_ptr<ScaleAndSizeExtractor>& scaleAndSizeExtractor) :
-        spScaleAndSizeExtractor{scaleAndSizeExtractor}
+    WScaleAndSizeExtractor<TDatums>::WScaleAndSizeExtractor(
+        const std::shared_ptr<ScaleAndSizeExtractor>& scaleAndSizeExtractor,
+        const std::shared_ptr<InputRoiTracker>& inputRoiTracker,
+        const std::shared_ptr<NetResolutionController>& netResolutionController) :
+        spScaleAndSizeExtractor{scaleAndSizeExtractor},
+        spInputRoiTracker{inputRoiTracker},
+        spNetResolutionController{netResolutionController}
     {
     }
 
@@ -58,8 +76,30 @@ namespace op
                 for (auto& tDatum : *tDatums)
                 {
                     const Point<int> inputSize{tDatum.cvInputData.cols, tDatum.cvInputData.rows};
-                    std::tie(tDatum.scaleInputToNetInputs, tDatum.netInputSizes, tDatum.scaleInputToOutput,
-                        tDatum.netOutputSize) = spScaleAndSizeExtractor->extract(inputSize);
+                    // Adaptive net resolution
+                    if (spNetResolutionController != nullptr)
+                    {
+                        tDatum.netInputResolution = spNetResolutionController->getNetInputResolution();
+                        std::tie(tDatum.scaleInputToNetInputs, tDatum.netInputSizes, tDatum.scaleInputToOutput,
+                            tDatum.netOutputSize) = spScaleAndSizeExtractor->extract(inputSize,
+                                                                                     tDatum.netInputResolution);
+                    }
+                    else
+                        std::tie(tDatum.scaleInputToNetInputs, tDatum.netInputSizes, tDatum.scaleInputToOutput,
+                            tDatum.netOutputSize) = spScaleAndSizeExtractor->extract(inputSize);
+                    // ROI-cropped inference: net input scales and sizes relative to the ROI
+                    tDatum.netInputRoi = (spInputRoiTracker != nullptr
+                                          ? spInputRoiTracker->getRoi(inputSize) : Rectangle<int>{});
+                    if (tDatum.netInputRoi.area() > 0)
+                    {
+                        const Point<int> roiSize{tDatum.netInputRoi.width, tDatum.netInputRoi.height};
+                        if (spNetResolutionController != nullptr)
+                            std::tie(tDatum.scaleInputToNetInputs, tDatum.netInputSizes, std::ignore, std::ignore)
+                                = spScaleAndSizeExtractor->extract(roiSize, tDatum.netInputResolution);
+                        else
+                            std::tie(tDatum.scaleInputToNetInputs, tDatum.netInputSizes, std::ignore, std::ignore)
+                                = spScaleAndSizeExtractor->extract(roiSize);
+                    }
                 }
                 // Profiling speed
                 Profiler::timerEnd(profilerKey);
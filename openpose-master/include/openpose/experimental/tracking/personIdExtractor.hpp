@@ -5,17 +5,53 @@
 
 namespace op
 {
+    /**
+     * Multi-person tracker: it assigns the same id to the same person across consecutive frames.
+     * The detections of each frame are associated with the current tracks by minimizing (Hungarian algorithm) the
+     * cost 1 - similarity, where the similarity is the average of the keypoint-weighted IoU of their bounding boxes
+     * and their OKS (object keypoint similarity). Unmatched detections start new tracks, and tracks not matched
+     * during more than maxFramesLost consecutive frames are removed.
+     * The frames must be given in order (e.g., after WQueueOrderer).
+     */
     class OP_API PersonIdExtractor
     {
     public:
-        PersonIdExtractor();
+        /**
+         * @param minSimilarity Minimum similarity ([0, 1]) between a track and a detection to associate them.
+         * @param maxFramesLost Number of consecutive frames a track is kept without being matched, so a person
+         * briefly occluded or missed by the network keeps its id.
+         * @param keypointThreshold Minimum score of a keypoint to be considered visible.
+         */
+        PersonIdExtractor(const float minSimilarity = 0.3f, const int maxFramesLost = 15,
+                          const float keypointThreshold = 0.05f);
 
         virtual ~PersonIdExtractor();
 
+        /**
+         * It returns the track id of each person of poseKeypoints (size #people), or an empty Array if there are no
+         * people.
+         */
         Array<long long> extractIds(const Array<float>& poseKeypoints);
 
     private:
-    	long long mNextPersonId;
+        const float mMinSimilarity;
+        const int mMaxFramesLost;
+        const float mKeypointThreshold;
+        long long mNextPersonId;
+        // Tracks: id, last visible keypoints (#tracks x #parts x 3) and consecutive frames not matched
+        int mNumberParts;
+        std::vector<long long> mTrackIds;
+        std::vector<float> mTrackKeypoints;
+        std::vector<int> mTrackFramesLost;
+        // Buffers reused across frames
+        std::vector<float> mSimilarities;
+        std::vector<float> mCosts;
+        std::vector<int> mAssignment;
+        std::vector<float> mHungarianBuffer;
+        std::vector<int> mHungarianIndexes;
+        std::vector<Rectangle<float>> mRectangles;
+        std::vector<int> mTrackOfPerson;
+        std::vector<bool> mTrackMatched;
 
         DELETE_COPY(PersonIdExtractor);
     };
@@ -1,6 +1,8 @@
 #ifndef OPENPOSE_FACE_FACE_DETECTOR_HPP
 #define OPENPOSE_FACE_FACE_DETECTOR_HPP
 
+#include <map>
+#include <mutex>
 #include <openpose/core/common.hpp>
 #include <openpose/pose/enumClasses.hpp>
 
@@ -13,6 +15,15 @@ namespace op
 
         std::vector<Rectangle<float>> detectFaces(const Array<float>& poseKeypoints, const double scaleInputToOutput) const;
 
+        /**
+         * Similar to detectFaces, but each face rectangle is refined with the one of the same person id (poseIds, e.g.,
+         * from PersonIdExtractor) in the previous frames, or reused if the head keypoints are missed. The
+         * low-confidence people are skipped. If poseIds is empty, it is equivalent to detectFaces.
+         * Thread-safe, id is the frame id (frames given in order).
+         */
+        std::vector<Rectangle<float>> trackFaces(const Array<float>& poseKeypoints, const double scaleInputToOutput,
+                                                 const Array<long long>& poseIds, const unsigned long long id);
+
     private:
         const unsigned int mNeck;
         const unsigned int mNose;
@@ -20,6 +31,9 @@ namespace op
         const unsigned int mREar;
         const unsigned int mLEye;
         const unsigned int mREye;
+        // Face rectangle of each person id and id of the frame where it was found
+        std::map<long long, std::pair<Rectangle<float>, unsigned long long>> mFacesPreviousById;
+        std::mutex mMutex;
 
         DELETE_COPY(FaceDetector);
     };
@@ -10,13 +10,28 @@ namespace op
     class OP_API FaceDetectorOpenCV
     {
     public:
-        explicit FaceDetectorOpenCV(const std::string& modelFolder);
+        /**
+         * @param fullScanInterval If > 1, detectFaces(cvInputData) only scans the whole frame every fullScanInterval
+         * frames (or if no faces were found in the previous frame). Otherwise, it only scans around the faces of the
+         * previous frame. 1 (default) scans the whole frame every time.
+         */
+        explicit FaceDetectorOpenCV(const std::string& modelFolder, const int fullScanInterval = 1);
 
         // No thread-save
         std::vector<Rectangle<float>> detectFaces(const cv::Mat& cvInputData);
 
+        /**
+         * Similar to detectFaces(cvInputData), but the face detector only scans inside regionsOfInterest (e.g., head
+         * regions given by the body keypoints or the previous faces). No thread-save.
+         */
+        std::vector<Rectangle<float>> detectFaces(const cv::Mat& cvInputData,
+                                                  const std::vector<Rectangle<float>>& regionsOfInterest);
+
     private:
+        const int mFullScanInterval;
         cv::CascadeClassifier mFaceCascade;
+        std::vector<Rectangle<float>> mPreviousFaces;
+        int mFramesSinceFullScan;
 
         DELETE_COPY(FaceDetectorOpenCV);
     };
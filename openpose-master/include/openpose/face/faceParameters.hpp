@@ -20,6 +20,8 @@ namespace op
     const auto FACE_CCN_DECREASE_FACTOR = 8.f;
     const std::string FACE_PROTOTXT{"face/pose_deploy.prototxt"};
     const std::string FACE_TRAINED_MODEL{"face/pose_iter_116000.caffemodel"};
+    // OpenCV face detector with tracking: frames between full frame scans
+    const auto FACE_OPENCV_FULL_SCAN_INTERVAL = 10;
 
     // Rendering parameters
     const auto FACE_DEFAULT_ALPHA_KEYPOINT = POSE_DEFAULT_ALPHA_KEYPOINT;
@@ -11,7 +11,10 @@ namespace op
     class WFaceDetector : public Worker<TDatums>
     {
     public:
-        explicit WFaceDetector(const std::shared_ptr<FaceDetector>& faceDetector);
+        /**
+         * @param tracking If true, FaceDetector::trackFaces is used with the person ids (Datum::poseIds).
+         */
+        explicit WFaceDetector(const std::shared_ptr<FaceDetector>& faceDetector, const bool tracking = false);
 
         void initializationOnThread();
 
@@ -19,6 +22,7 @@ namespace op
 
     private:
         std::shared_ptr<FaceDetector> spFaceDetector;
+        const bool mTracking;
 
         DELETE_COPY(WFaceDetector);
     };
@@ -33,8 +37,9 @@ namespace op
 namespace op
 {
     template<typename TDatums>
-    WFaceDetector<TDatums>::WFaceDetector(const std::shared_ptr<FaceDetector>& faceDetector) :
-        spFaceDetector{faceDetector}
+    WFaceDetector<TDatums>::WFaceDetector(const std::shared_ptr<FaceDetector>& faceDetector, const bool tracking) :
+        spFaceDetector{faceDetector},
+        mTracking{tracking}
     {
     }
 
@@ -56,7 +61,15 @@ namespace op
                 const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
                 // Detect people face
                 for (auto& tDatum : *tDatums)
-                    tDatum.faceRectangles = spFaceDetector->detectFaces(tDatum.poseKeypoints, tDatum.scaleInputToOutput);
+                {
+                    if (mTracking)
+                        tDatum.faceRectangles = spFaceDetector->trackFaces(tDatum.poseKeypoints,
+                                                                           tDatum.scaleInputToOutput, tDatum.poseIds,
+                                                                           tDatum.id);
+                    else
+                        tDatum.faceRectangles = spFaceDetector->detectFaces(tDatum.poseKeypoints,
+                                                                            tDatum.scaleInputToOutput);
+                }
                 // Profiling speed
                 Profiler::timerEnd(profilerKey);
                 Profiler::printAveragedTimeMsOnIterationX(profilerKey, __LINE__, __FUNCTION__, __FILE__);
@@ -0,0 +1,108 @@
+#ifndef OPENPOSE_FILESTREAM_DATUM_RECORDING_HPP
+#define OPENPOSE_FILESTREAM_DATUM_RECORDING_HPP
+
+#include <opencv2/core/core.hpp> // cv::Mat
+#include <openpose/core/common.hpp>
+#include <openpose/core/datum.hpp>
+
+namespace op
+{
+    /**
+     * One frame of a DatumRecording: the per-frame inputs of the pipeline (input image, scales and sizes) plus the
+     * results recorded with it (pose keypoints and scores and, optionally, heat maps).
+     */
+    struct OP_API RecordedFrame
+    {
+        unsigned long long id;
+
+        std::string name;
+
+        /**
+         * Time in nanoseconds since the first recorded frame. Used to replay the frames at the recorded pacing.
+         */
+        long long timestampNs;
+
+        /**
+         * It points to the memory-mapped recording (no copy), so it is only valid while the DatumRecording exists.
+         * The mapping is private (copy-on-write), so writing into it never modifies the recording file.
+         */
+        cv::Mat cvInputData;
+
+        std::vector<double> scaleInputToNetInputs;
+
+        std::vector<Point<int>> netInputSizes;
+
+        double scaleInputToOutput;
+
+        Point<int> netOutputSize;
+
+        double scaleNetToOutput;
+
+        Array<float> poseKeypoints;
+
+        Array<float> poseScores;
+
+        /**
+         * Empty if the recording was made without heat maps.
+         */
+        Array<float> poseHeatMaps;
+    };
+
+    /**
+     * DatumRecorder serializes the Datum fields of RecordedFrame into a single binary file that DatumRecording can
+     * memory-map. Every field is 8-byte aligned, so the images can be used directly from the mapped memory.
+     * The frame index is written when the recorder is destroyed (or close() is called), so an interrupted recording
+     * cannot be replayed.
+     */
+    class OP_API DatumRecorder
+    {
+    public:
+        DatumRecorder(const std::string& filePath, const bool recordHeatMaps = false);
+
+        ~DatumRecorder();
+
+        void record(const Datum& datum);
+
+        void close();
+
+    private:
+        // PIMPL idiom
+        // http://www.cppsamples.com/common-tasks/pimpl.html
+        struct ImplDatumRecorder;
+        std::unique_ptr<ImplDatumRecorder> upImpl;
+
+        DELETE_COPY(DatumRecorder);
+    };
+
+    /**
+     * DatumRecording memory-maps (read-only for the file, private copy-on-write for the process) a file written by
+     * DatumRecorder and gives random access to its frames.
+     */
+    class OP_API DatumRecording
+    {
+    public:
+        explicit DatumRecording(const std::string& filePath);
+
+        ~DatumRecording();
+
+        unsigned long long getNumberFrames() const;
+
+        bool hasHeatMaps() const;
+
+        /**
+         * It fills recordedFrame with the frame at frameIndex. Only the cvInputData header is created, the image
+         * pixels are not copied.
+         */
+        void getFrame(RecordedFrame& recordedFrame, const unsigned long long frameIndex) const;
+
+    private:
+        // PIMPL idiom
+        // http://www.cppsamples.com/common-tasks/pimpl.html
+        struct ImplDatumRecording;
+        std::unique_ptr<ImplDatumRecording> upImpl;
+
+        DELETE_COPY(DatumRecording);
+    };
+}
+
+#endif // OPENPOSE_FILESTREAM_DATUM_RECORDING_HPP
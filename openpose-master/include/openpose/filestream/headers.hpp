@@ -3,6 +3,7 @@
 
 // fileStream module
 #include <openpose/filestream/cocoJsonSaver.hpp>
+#include <openpose/filestream/datumRecording.hpp>
 #include <openpose/filestream/enumClasses.hpp>
 #include <openpose/filestream/fileSaver.hpp>
 #include <openpose/filestream/fileStream.hpp>
@@ -13,6 +14,7 @@
 #include <openpose/filestream/keypointSaver.hpp>
 #include <openpose/filestream/videoSaver.hpp>
 #include <openpose/filestream/wCocoJsonSaver.hpp>
+#include <openpose/filestream/wDatumRecorder.hpp>
 #include <openpose/filestream/wFaceSaver.hpp>
 #include <openpose/filestream/wHandSaver.hpp>
 #include <openpose/filestream/wImageSaver.hpp>
@@ -0,0 +1,77 @@
+#ifndef OPENPOSE_FILESTREAM_W_DATUM_RECORDER_HPP
+#define OPENPOSE_FILESTREAM_W_DATUM_RECORDER_HPP
+
+#include <openpose/core/common.hpp>
+#include <openpose/filestream/datumRecording.hpp>
+#include <openpose/thread/workerConsumer.hpp>
+
+namespace op
+{
+    template<typename TDatums>
+    class WDatumRecorder : public WorkerConsumer<TDatums>
+    {
+    public:
+        explicit WDatumRecorder(const std::shared_ptr<DatumRecorder>& datumRecorder);
+
+        void initializationOnThread();
+
+        void workConsumer(const TDatums& tDatums);
+
+    private:
+        const std::shared_ptr<DatumRecorder> spDatumRecorder;
+
+        DELETE_COPY(WDatumRecorder);
+    };
+}
+
+
+
+
+
+// Implementation
+#include <openpose/utilities/pointerContainer.hpp>
+namespace op
+{
+    template<typename TDatums>
+    WDatumRecorder<TDatums>::WDatumRecorder(const std::shared_ptr<DatumRecorder>& datumRecorder) :
+        spDatumRecorder{datumRecorder}
+    {
+    }
+
+    template<typename TDatums>
+    void WDatumRecorder<TDatums>::initializationOnThread()
+    {
+    }
+
+    template<typename TDatums>
+    void WDatumRecorder<TDatums>::workConsumer(const TDatums& tDatums)
+    {
+        try
+        {
+            if (checkNoNullNorEmpty(tDatums))
+            {
+                // Debugging log
+                dLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+                // Profiling speed
+                const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
+                // Record Datums
+                for (const auto& tDatum : *tDatums)
+                    spDatumRecorder->record(tDatum);
+                // Profiling speed
+                Profiler::timerEnd(profilerKey);
+                Profiler::printAveragedTimeMsOnIterationX(profilerKey, __LINE__, __FUNCTION__, __FILE__);
+                // Debugging log
+                dLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            this->stop();
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    COMPILE_TEMPLATE_DATUM(WDatumRecorder);
+}
+
+#endif // OPENPOSE_FILESTREAM_W_DATUM_RECORDER_HPP
@@ -1,6 +1,7 @@
 #ifndef OPENPOSE_HAND_HAND_DETECTOR_HPP
 #define OPENPOSE_HAND_HAND_DETECTOR_HPP
 
+#include <map>
 #include <mutex>
 #include <openpose/core/common.hpp>
 #include <openpose/pose/enumClasses.hpp>
@@ -16,9 +17,20 @@ namespace op
 
         std::vector<std::array<Rectangle<float>, 2>> detectHands(const Array<float>& poseKeypoints, const double scaleInputToOutput) const;
 
-        std::vector<std::array<Rectangle<float>, 2>> trackHands(const Array<float>& poseKeypoints, const double scaleInputToOutput);
-
-        void updateTracker(const std::array<Array<float>, 2>& handKeypoints, const unsigned long long id);
+        /**
+         * If poseIds (person ids, e.g., from PersonIdExtractor) is not empty, each person only reuses and refines the
+         * hand rectangles of the same person id in the previous frames (e.g., when an arm keypoint is missed), and
+         * the low-confidence people are skipped. Otherwise, each hand is matched with the closest previous hand.
+         * @param id Frame id (Datum::id). With poseIds, a hand rectangle is only reused during the 3 frames that
+         * follow the last frame where that hand was found (counted from the last updateTracker() frame if id is
+         * older).
+         */
+        std::vector<std::array<Rectangle<float>, 2>> trackHands(const Array<float>& poseKeypoints, const double scaleInputToOutput,
+                                                                const Array<long long>& poseIds = Array<long long>{},
+                                                                const unsigned long long id = 0ull);
+
+        void updateTracker(const std::array<Array<float>, 2>& handKeypoints, const unsigned long long id,
+                           const Array<long long>& poseIds = Array<long long>{});
 
     private:
         enum class PosePart : unsigned int
@@ -36,6 +48,8 @@ namespace op
         std::vector<std::array<Point<float>, (int)PosePart::Size>> mPoseTrack;
         std::vector<Rectangle<float>> mHandLeftPrevious;
         std::vector<Rectangle<float>> mHandRightPrevious;
+        // Left and right hand rectangles of each person id, each one with the id of the last frame where it was found
+        std::map<long long, std::array<std::pair<Rectangle<float>, unsigned long long>, 2>> mHandsPreviousById;
         unsigned long long mCurrentId;
         std::mutex mMutex;
 
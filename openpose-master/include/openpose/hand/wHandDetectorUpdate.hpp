@@ -56,7 +56,7 @@ namespace op
                 const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
                 // Detect people hand
                 for (auto& tDatum : *tDatums)
-                    spHandDetector->updateTracker(tDatum.handKeypoints, tDatum.id);
+                    spHandDetector->updateTracker(tDatum.handKeypoints, tDatum.id, tDatum.poseIds);
                 // Profiling speed
                 Profiler::timerEnd(profilerKey);
                 Profiler::printAveragedTimeMsOnIterationX(profilerKey, __LINE__, __FUNCTION__, __FILE__);
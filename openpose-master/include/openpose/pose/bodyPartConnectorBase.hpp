@@ -6,11 +6,16 @@
 
 namespace op
 {
+    /**
+     * @param peakOwnersPtr If not nullptr (local peak search, see nmsWindowsCpu), the PAFs are only scored between
+     * candidates of the same owner (i.e., the known limbs of each tracked person).
+     */
     template <typename T>
     OP_API void connectBodyPartsCpu(Array<T>& poseKeypoints, Array<T>& poseScores, const T* const heatMapPtr,
                                     const T* const peaksPtr, const PoseModel poseModel, const Point<int>& heatMapSize,
                                     const int maxPeaks, const T interMinAboveThreshold, const T interThreshold,
-                                    const int minSubsetCnt, const T minSubsetScore, const T scaleFactor = 1.f);
+                                    const int minSubsetCnt, const T minSubsetScore, const T scaleFactor = 1.f,
+                                    const int* const peakOwnersPtr = nullptr);
 
     template <typename T>
     OP_API void connectBodyPartsGpu(Array<T>& poseKeypoints, Array<T>& poseScores, const T* const heatMapPtr,
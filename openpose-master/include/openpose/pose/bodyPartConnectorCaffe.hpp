@@ -40,6 +40,12 @@ namespace op
 
         void setScaleNetToOutput(const T scaleNetToOutput);
 
+        /**
+         * Owner of each peak of the local peak search (see nmsWindowsCpu), or nullptr (default) to connect all the
+         * peaks. The pointer must remain valid until Forward_cpu().
+         */
+        void setPeakOwners(const int* const peakOwnersPtr);
+
         virtual void Forward_cpu(const std::vector<caffe::Blob<T>*>& bottom, Array<T>& poseKeypoints,
                                  Array<T>& poseScores);
 
@@ -59,6 +65,7 @@ namespace op
         int mMinSubsetCnt;
         T mMinSubsetScore;
         T mScaleNetToOutput;
+        const int* mPeakOwnersPtr;
         std::array<int, 4> mHeatMapsSize;
         std::array<int, 4> mPeaksSize;
         std::array<int, 4> mTopSize;
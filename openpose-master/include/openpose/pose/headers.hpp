@@ -9,6 +9,7 @@
 #include <openpose/pose/poseExtractor.hpp>
 #include <openpose/pose/poseExtractorCaffe.hpp>
 #include <openpose/pose/poseGpuRenderer.hpp>
+#include <openpose/pose/poseKeypointPropagator.hpp>
 #include <openpose/pose/poseParameters.hpp>
 #include <openpose/pose/poseParametersRender.hpp>
 #include <openpose/pose/poseRenderer.hpp>
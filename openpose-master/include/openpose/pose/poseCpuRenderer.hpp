@@ -1,6 +1,7 @@
 #ifndef OPENPOSE_POSE_POSE_CPU_RENDERER_HPP
 #define OPENPOSE_POSE_POSE_CPU_RENDERER_HPP
 
+#include <array>
 #include <openpose/core/common.hpp>
 #include <openpose/core/renderer.hpp>
 #include <openpose/pose/enumClasses.hpp>
@@ -19,9 +20,13 @@ namespace op
 
         std::pair<int, std::string> renderPose(Array<float>& outputData, const Array<float>& poseKeypoints,
                                                const float scaleInputToOutput,
-                                               const float scaleNetToOutput = -1.f);
+                                               const float scaleNetToOutput = -1.f,
+                                               const Array<long long>& poseIds = Array<long long>{});
 
     private:
+        // Ids of the upper and lower trainees, kept across frames (-1 if none)
+        std::array<long long, 2> mTrainPersonIds;
+
         DELETE_COPY(PoseCpuRenderer);
     };
 }
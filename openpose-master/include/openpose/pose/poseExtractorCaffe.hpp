@@ -10,10 +10,23 @@ namespace op
     class OP_API PoseExtractorCaffe : public PoseExtractor
     {
     public:
+        /**
+         * @param localPeakSearchInterval If > 0, the peaks are only searched around the people of the previous
+         * frame (and the PAFs only scored between peaks of the same person), with a whole heat map search every
+         * localPeakSearchInterval frames or whenever a person is lost. The frames must be given in order.
+         * @param tileSize If > 0 (multiple of 16), net inputs larger than tileSize x tileSize are processed by
+         * overlapping tiles of at most that size, whose outputs are blended before resizing and merging them (so
+         * the net memory only depends on tileSize).
+         * @param tileOverlap Overlap between consecutive tiles (multiple of 16), in net input pixels.
+         */
         PoseExtractorCaffe(const PoseModel poseModel, const std::string& modelFolder, const int gpuId,
                            const std::vector<HeatMapType>& heatMapTypes = {},
                            const ScaleMode heatMapScale = ScaleMode::ZeroToOne,
-                           const bool enableGoogleLogging = true);
+                           const bool enableGoogleLogging = true, const int intraOpThreads = 0,
+                           const bool int8Inference = false, const int earlyExitStage = 0,
+                           const float earlyExitThreshold = 0.f, const int interOpThreads = 1,
+                           const int localPeakSearchInterval = 0, const int tileSize = 0,
+                           const int tileOverlap = 64);
 
         virtual ~PoseExtractorCaffe();
 
@@ -0,0 +1,81 @@
+#ifndef OPENPOSE_POSE_POSE_KEYPOINT_PROPAGATOR_HPP
+#define OPENPOSE_POSE_POSE_KEYPOINT_PROPAGATOR_HPP
+
+#include <opencv2/core/core.hpp> // cv::Mat
+#include <openpose/core/common.hpp>
+
+namespace op
+{
+    /**
+     * Keyframe mode of the pose estimation: the pose network is only run on the keyframes, and the keypoints of the
+     * frames in between are propagated from the previous frame with sparse pyramidal Lucas-Kanade optical flow.
+     * A frame is a keyframe when keyframeInterval frames have passed since the last one, when the frame differs too
+     * much from the last keyframe (motionThreshold) or when the optical flow loses too many keypoints
+     * (minTrackedRatio).
+     * The propagated keypoints keep the score of their keyframe multiplied by propagatedScoreRatio, so they can be
+     * told apart from the network ones. The keypoints lost by the optical flow are set to 0 until the next
+     * keyframe.
+     * The frames must be given in order.
+     */
+    class OP_API PoseKeypointPropagator
+    {
+    public:
+        /**
+         * @param keyframeInterval The pose network is run at least once every keyframeInterval frames. 1 runs it
+         * on every frame.
+         * @param motionThreshold If > 0, the network is also run when the mean absolute difference ([0, 255])
+         * between the (downsampled, gray) frame and the last keyframe is higher than this threshold.
+         * @param minTrackedRatio The network is also run when the optical flow tracks less than this ratio of the
+         * keyframe visible keypoints.
+         * @param propagatedScoreRatio Score of the propagated keypoints relative to their keyframe score.
+         */
+        PoseKeypointPropagator(const int keyframeInterval, const float motionThreshold = 0.f,
+                               const float minTrackedRatio = 0.5f, const float propagatedScoreRatio = 0.5f);
+
+        /**
+         * It must be called for every frame but the ones given to setReusedFrame(). If it returns true,
+         * poseKeypoints are the keypoints of the previous frame propagated to cvInputData. If it returns false,
+         * cvInputData is a keyframe: the pose network must be run and its keypoints given to setKeyframe().
+         */
+        bool propagate(Array<float>& poseKeypoints, const cv::Mat& cvInputData);
+
+        /**
+         * It must be called instead of propagate() for the frames that reuse the keypoints of the previous frame
+         * (e.g., motion gating), so the next optical flow starts from cvInputData.
+         */
+        void setReusedFrame(const cv::Mat& cvInputData);
+
+        /**
+         * Keypoints given by the pose network for the last frame given to propagate().
+         */
+        void setKeyframe(const Array<float>& poseKeypoints);
+
+    private:
+        const int mKeyframeInterval;
+        const float mMotionThreshold;
+        const float mMinTrackedRatio;
+        const float mPropagatedScoreRatio;
+        int mFramesSinceKeyframe;
+        // Gray frames
+        cv::Mat mGray;
+        cv::Mat mPreviousGray;
+        cv::Mat mKeyframeThumbnail;
+        // Keypoints of the previous frame (with the keyframe scores, 0 for the lost ones)
+        Array<float> mPreviousKeypoints;
+        int mKeyframeVisible;
+        // Buffers reused across frames
+        std::vector<cv::Point2f> mPreviousPoints;
+        std::vector<cv::Point2f> mPoints;
+        std::vector<int> mPointIndexes;
+        std::vector<unsigned char> mStatus;
+        std::vector<float> mErrors;
+
+        void updateGray(const cv::Mat& cvInputData);
+
+        cv::Mat getThumbnail(const cv::Mat& gray) const;
+
+        DELETE_COPY(PoseKeypointPropagator);
+    };
+}
+
+#endif // OPENPOSE_POSE_POSE_KEYPOINT_PROPAGATOR_HPP
@@ -21,6 +21,10 @@ namespace op
     OP_API const std::vector<unsigned int>& getPoseMapIndex(const PoseModel poseModel);
     OP_API unsigned int getPoseMaxPeaks(const PoseModel poseModel);
     OP_API float getPoseNetDecreaseFactor(const PoseModel poseModel);
+    // Number of refinement stages of the network (0 if unknown)
+    OP_API unsigned int getPoseNumberStages(const PoseModel poseModel);
+    // Heat map and PAF blobs of a stage (1-based), in the same channel order than the network output
+    OP_API std::vector<std::string> getPoseStageOutputBlobs(const PoseModel poseModel, const unsigned int stage);
     OP_API unsigned int poseBodyPartMapStringToKey(const PoseModel poseModel, const std::string& string);
     OP_API unsigned int poseBodyPartMapStringToKey(const PoseModel poseModel, const std::vector<std::string>& strings);
 
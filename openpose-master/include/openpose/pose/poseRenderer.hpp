@@ -15,7 +15,8 @@ namespace op
 
         virtual std::pair<int, std::string> renderPose(Array<float>& outputData, const Array<float>& poseKeypoints,
                                                        const float scaleInputToOutput,
-                                                       const float scaleNetToOutput = -1.f) = 0;
+                                                       const float scaleNetToOutput = -1.f,
+                                                       const Array<long long>& poseIds = Array<long long>{}) = 0;
 
     protected:
         const PoseModel mPoseModel;
@@ -1,6 +1,7 @@
 #ifndef OPENPOSE_POSE_RENDER_POSE_HPP
 #define OPENPOSE_POSE_RENDER_POSE_HPP
 
+#include <array>
 #include <opencv2/core/core.hpp> // cv::Mat
 #include <openpose/core/common.hpp>
 #include <openpose/pose/enumClasses.hpp>
@@ -10,7 +11,9 @@ namespace op
 {
     OP_API void renderPoseKeypointsCpu(Array<float>& frameArray, const Array<float>& poseKeypoints,
                                        const PoseModel poseModel, const float renderThreshold,
-                                       const bool blendOriginalFrame = true);
+                                       const bool blendOriginalFrame = true,
+                                       const Array<long long>& poseIds = Array<long long>{},
+                                       std::array<long long, 2>* trainPersonIds = nullptr);
 
     OP_API void renderPoseKeypointsGpu(float* framePtr, const PoseModel poseModel, const int numberPeople,
                                        const Point<int>& frameSize, const float* const posePtr,
@@ -1,8 +1,12 @@
 #ifndef OPENPOSE_POSE_W_POSE_EXTRACTOR_HPP
 #define OPENPOSE_POSE_W_POSE_EXTRACTOR_HPP
 
+#include <chrono>
 #include <openpose/core/common.hpp>
+#include <openpose/core/inputRoiTracker.hpp>
+#include <openpose/core/netResolutionController.hpp>
 #include <openpose/pose/poseExtractor.hpp>
+#include <openpose/pose/poseKeypointPropagator.hpp>
 #include <openpose/thread/worker.hpp>
 
 namespace op
@@ -11,7 +15,20 @@ namespace op
     class WPoseExtractor : public Worker<TDatums>
     {
     public:
-        explicit WPoseExtractor(const std::shared_ptr<PoseExtractor>& poseExtractorSharedPtr);
+        /**
+         * @param poseKeypointPropagator If not nullptr, the pose network only runs on the keyframes and the
+         * keypoints of the other frames are propagated with optical flow (see PoseKeypointPropagator).
+         * @param inputRoiTracker If not nullptr, it is updated with the keypoints of each frame (ROI-cropped
+         * inference, see InputRoiTracker).
+         * @param netResolutionController If not nullptr, it is given the pose network latency of each frame
+         * (adaptive net resolution, see NetResolutionController).
+         * The frames marked with Datum::poseReused (motion gating, see MotionGate) get the keypoints of the previous
+         * frame and no heat maps.
+         */
+        explicit WPoseExtractor(const std::shared_ptr<PoseExtractor>& poseExtractorSharedPtr,
+                                const std::shared_ptr<PoseKeypointPropagator>& poseKeypointPropagator = nullptr,
+                                const std::shared_ptr<InputRoiTracker>& inputRoiTracker = nullptr,
+                                const std::shared_ptr<NetResolutionController>& netResolutionController = nullptr);
 
         void initializationOnThread();
 
@@ -19,6 +36,10 @@ namespace op
 
     private:
         std::shared_ptr<PoseExtractor> spPoseExtractor;
+        std::shared_ptr<PoseKeypointPropagator> spPoseKeypointPropagator;
+        std::shared_ptr<InputRoiTracker> spInputRoiTracker;
+        std::shared_ptr<NetResolutionController> spNetResolutionController;
+        Array<float> mPreviousPoseKeypoints;
 
         DELETE_COPY(WPoseExtractor);
     };
@@ -33,8 +54,14 @@ namespace op
 namespace op
 {
     template<typename TDatums>
-    WPoseExtractor<TDatums>::WPoseExtractor(const std::shared_ptr<PoseExtractor>& poseExtractorSharedPtr) :
-        spPoseExtractor{poseExtractorSharedPtr}
+    WPoseExtractor<TDatums>::WPoseExtractor(const std::shared_ptr<PoseExtractor>& poseExtractorSharedPtr,
+                                            const std::shared_ptr<PoseKeypointPropagator>& poseKeypointPropagator,
+                                            const std::shared_ptr<InputRoiTracker>& inputRoiTracker,
+                                            const std::shared_ptr<NetResolutionController>& netResolutionController) :
+        spPoseExtractor{poseExtractorSharedPtr},
+        spPoseKeypointPropagator{poseKeypointPropagator},
+        spInputRoiTracker{inputRoiTracker},
+        spNetResolutionController{netResolutionController}
     {
     }
 
@@ -58,13 +85,63 @@ namespace op
                 // Extract people pose
                 for (auto& tDatum : *tDatums)
                 {
-                    spPoseExtractor->forwardPass(tDatum.inputNetData,
-                                                 Point<int>{tDatum.cvInputData.cols, tDatum.cvInputData.rows},
-                                                 tDatum.scaleInputToNetInputs);
-                    tDatum.poseHeatMaps = spPoseExtractor->getHeatMaps().clone();
-                    tDatum.poseKeypoints = spPoseExtractor->getPoseKeypoints().clone();
-                    tDatum.poseScores = spPoseExtractor->getPoseScores().clone();
-                    tDatum.scaleNetToOutput = spPoseExtractor->getScaleNetToOutput();
+                    // Motion gating: keypoints of the previous frame (no heat maps)
+                    if (tDatum.poseReused)
+                    {
+                        tDatum.poseKeypoints = mPreviousPoseKeypoints.clone();
+                        tDatum.poseHeatMaps.reset();
+                        tDatum.poseScores = spPoseExtractor->getPoseScores().clone();
+                        tDatum.scaleNetToOutput = spPoseExtractor->getScaleNetToOutput();
+                        if (spPoseKeypointPropagator != nullptr)
+                            spPoseKeypointPropagator->setReusedFrame(tDatum.cvInputData);
+                    }
+                    // Keyframe mode: keypoints propagated from the previous frame (no heat maps), and the scores
+                    // of the last keyframe
+                    else if (spPoseKeypointPropagator != nullptr
+                             && spPoseKeypointPropagator->propagate(tDatum.poseKeypoints, tDatum.cvInputData))
+                    {
+                        tDatum.poseHeatMaps.reset();
+                        tDatum.poseScores = spPoseExtractor->getPoseScores().clone();
+                        tDatum.scaleNetToOutput = spPoseExtractor->getScaleNetToOutput();
+                    }
+                    else
+                    {
+                        // ROI-cropped inference: the net input is the ROI, the keypoints are moved back to the
+                        // full frame (the heat maps cover the ROI)
+                        const auto& roi = tDatum.netInputRoi;
+                        const auto inputSize = (roi.area() > 0 ? Point<int>{roi.width, roi.height}
+                                                : Point<int>{tDatum.cvInputData.cols, tDatum.cvInputData.rows});
+                        const auto start = std::chrono::high_resolution_clock::now();
+                        spPoseExtractor->forwardPass(tDatum.inputNetData, inputSize, tDatum.scaleInputToNetInputs);
+                        // Adaptive net resolution: pose network latency
+                        if (spNetResolutionController != nullptr)
+                            spNetResolutionController->reportLatency(
+                                tDatum.netInputResolution,
+                                std::chrono::duration<double, std::milli>{
+                                    std::chrono::high_resolution_clock::now() - start}.count());
+                        tDatum.poseHeatMaps = spPoseExtractor->getHeatMaps().clone();
+                        tDatum.poseKeypoints = spPoseExtractor->getPoseKeypoints().clone();
+                        tDatum.poseScores = spPoseExtractor->getPoseScores().clone();
+                        tDatum.scaleNetToOutput = spPoseExtractor->getScaleNetToOutput();
+                        if (roi.area() > 0)
+                        {
+                            auto& poseKeypoints = tDatum.poseKeypoints;
+                            for (auto keypoint = 0 ; keypoint < (int)poseKeypoints.getVolume() / 3 ; keypoint++)
+                            {
+                                if (poseKeypoints[3*keypoint+2] > 0.f)
+                                {
+                                    poseKeypoints[3*keypoint] += roi.x;
+                                    poseKeypoints[3*keypoint+1] += roi.y;
+                                }
+                            }
+                        }
+                        if (spPoseKeypointPropagator != nullptr)
+                            spPoseKeypointPropagator->setKeyframe(tDatum.poseKeypoints);
+                    }
+                    if (spInputRoiTracker != nullptr)
+                        spInputRoiTracker->update(tDatum.poseKeypoints, tDatum.netInputRoi);
+                    // Later workers modify tDatum.poseKeypoints in place (e.g., keypoint scaling)
+                    mPreviousPoseKeypoints = tDatum.poseKeypoints.clone();
                 }
                 // Profiling speed
                 Profiler::timerEnd(profilerKey);
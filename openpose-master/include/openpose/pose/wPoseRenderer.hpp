@@ -59,7 +59,8 @@ namespace op
                 for (auto& tDatum : *tDatums)
                     tDatum.elementRendered = spPoseRenderer->renderPose(tDatum.outputData, tDatum.poseKeypoints,
                                                                         (float)tDatum.scaleInputToOutput,
-                                                                        (float)tDatum.scaleNetToOutput);
+                                                                        (float)tDatum.scaleNetToOutput,
+                                                                        tDatum.poseIds);
                 // Profiling speed
                 Profiler::timerEnd(profilerKey);
                 Profiler::printAveragedTimeMsOnIterationX(profilerKey, __LINE__, __FUNCTION__, __FILE__);
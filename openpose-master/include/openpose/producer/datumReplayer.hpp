@@ -0,0 +1,79 @@
+#ifndef OPENPOSE_PRODUCER_DATUM_REPLAYER_HPP
+#define OPENPOSE_PRODUCER_DATUM_REPLAYER_HPP
+
+#include <openpose/core/common.hpp>
+#include <openpose/filestream/datumRecording.hpp>
+
+namespace op
+{
+    /**
+     * Summary of a replay: throughput, producer-to-checker latency and keypoint differences with the recording.
+     */
+    struct OP_API ReplayReport
+    {
+        unsigned long long numberFrames;
+        unsigned long long numberCheckedFrames;
+        unsigned long long numberMismatchedFrames;
+        float maxKeypointError;
+        double fps;
+        double latencyAverageMs;
+        double latencyMedianMs;
+        double latency99Ms;
+        double latencyMaxMs;
+    };
+
+    /**
+     * DatumReplayer feeds back the frames of a DatumRecording (see WDatumReplayer) and checks the resulting pose
+     * keypoints against the recorded ones (see WDatumReplayChecker), so throughput and latency can be measured on
+     * exactly the same input for any subset of the pipeline, without a camera or video decoding.
+     * Frames are matched by Datum::id, which WIdGenerator assigns consecutively from 0 in replay order (i.e. the
+     * replayed id is the frame index in the recording).
+     */
+    class OP_API DatumReplayer
+    {
+    public:
+        /**
+         * @param keepRecordedPacing If true, each frame is released at its recorded time (relative to the first one).
+         * Otherwise, frames are produced as fast as the pipeline consumes them.
+         * @param keypointTolerance Maximum x-y difference (in keypoint units) between a replayed and a recorded
+         * keypoint. Negative values disable the keypoint checking.
+         */
+        explicit DatumReplayer(const std::string& recordingPath, const bool keepRecordedPacing = false,
+                               const float keypointTolerance = 1.f);
+
+        ~DatumReplayer();
+
+        unsigned long long getNumberFrames() const;
+
+        /**
+         * Size of the first recorded frame, or {-1,-1} if the recording is empty.
+         */
+        Point<int> getFrameSize() const;
+
+        /**
+         * It fills recordedFrame with the next frame, sleeping first if the recorded pacing is kept.
+         * @return false if all the frames have already been replayed.
+         */
+        bool getNextFrame(RecordedFrame& recordedFrame);
+
+        /**
+         * It compares the keypoints of the replayed frame id with the recorded ones and records its latency. Once all
+         * the frames have been checked, the report is printed.
+         */
+        void checkFrame(const unsigned long long id, const Array<float>& poseKeypoints);
+
+        ReplayReport getReport() const;
+
+        void printReport(const Priority priority = Priority::High) const;
+
+    private:
+        // PIMPL idiom
+        // http://www.cppsamples.com/common-tasks/pimpl.html
+        struct ImplDatumReplayer;
+        std::unique_ptr<ImplDatumReplayer> upImpl;
+
+        DELETE_COPY(DatumReplayer);
+    };
+}
+
+#endif // OPENPOSE_PRODUCER_DATUM_REPLAYER_HPP
@@ -3,6 +3,7 @@
 
 // producer module
 #include <openpose/producer/datumProducer.hpp>
+#include <openpose/producer/datumReplayer.hpp>
 #include <openpose/producer/enumClasses.hpp>
 #include <openpose/producer/imageDirectoryReader.hpp>
 #include <openpose/producer/ipCameraReader.hpp>
@@ -11,5 +12,7 @@
 #include <openpose/producer/videoReader.hpp>
 #include <openpose/producer/webcamReader.hpp>
 #include <openpose/producer/wDatumProducer.hpp>
+#include <openpose/producer/wDatumReplayChecker.hpp>
+#include <openpose/producer/wDatumReplayer.hpp>
 
 #endif // OPENPOSE_PRODUCER_HEADERS_HPP
@@ -0,0 +1,81 @@
+#ifndef OPENPOSE_PRODUCER_W_DATUM_REPLAY_CHECKER_HPP
+#define OPENPOSE_PRODUCER_W_DATUM_REPLAY_CHECKER_HPP
+
+#include <openpose/core/common.hpp>
+#include <openpose/producer/datumReplayer.hpp>
+#include <openpose/thread/workerConsumer.hpp>
+
+namespace op
+{
+    /**
+     * Consumer Worker that checks the pose keypoints of each Datum replayed by WDatumReplayer against the recording
+     * and measures its latency. It should be the first output Worker, so the latency does not include the savers or
+     * the GUI.
+     */
+    template<typename TDatums>
+    class WDatumReplayChecker : public WorkerConsumer<TDatums>
+    {
+    public:
+        explicit WDatumReplayChecker(const std::shared_ptr<DatumReplayer>& datumReplayer);
+
+        void initializationOnThread();
+
+        void workConsumer(const TDatums& tDatums);
+
+    private:
+        const std::shared_ptr<DatumReplayer> spDatumReplayer;
+
+        DELETE_COPY(WDatumReplayChecker);
+    };
+}
+
+
+
+
+
+// Implementation
+#include <openpose/utilities/pointerContainer.hpp>
+namespace op
+{
+    template<typename TDatums>
+    WDatumReplayChecker<TDatums>::WDatumReplayChecker(const std::shared_ptr<DatumReplayer>& datumReplayer) :
+        spDatumReplayer{datumReplayer}
+    {
+    }
+
+    template<typename TDatums>
+    void WDatumReplayChecker<TDatums>::initializationOnThread()
+    {
+    }
+
+    template<typename TDatums>
+    void WDatumReplayChecker<TDatums>::workConsumer(const TDatums& tDatums)
+    {
+        try
+        {
+            if (checkNoNullNorEmpty(tDatums))
+            {
+                // Debugging log
+                dLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+                // Profiling speed
+                const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
+                // Check Datums (all the Datums of TDatums share the same id)
+                spDatumReplayer->checkFrame((*tDatums)[0].id, (*tDatums)[0].poseKeypoints);
+                // Profiling speed
+                Profiler::timerEnd(profilerKey);
+                Profiler::printAveragedTimeMsOnIterationX(profilerKey, __LINE__, __FUNCTION__, __FILE__);
+                // Debugging log
+                dLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            this->stop();
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    COMPILE_TEMPLATE_DATUM(WDatumReplayChecker);
+}
+
+#endif // OPENPOSE_PRODUCER_W_DATUM_REPLAY_CHECKER_HPP
@@ -0,0 +1,103 @@
+#ifndef OPENPOSE_PRODUCER_W_DATUM_REPLAYER_HPP
+#define OPENPOSE_PRODUCER_W_DATUM_REPLAYER_HPP
+
+#include <openpose/core/common.hpp>
+#include <openpose/producer/datumReplayer.hpp>
+#include <openpose/thread/workerProducer.hpp>
+
+namespace op
+{
+    /**
+     * Producer Worker of the recorded frames of a DatumReplayer. It replaces WDatumProducer (and therefore the camera,
+     * video or image directory Producer) in the pipeline. Besides the input image, name, scales and sizes, it also
+     * fills the recorded keypoints, scores and heat maps, so pipelines without pose extraction (e.g. only rendering
+     * and saving) can also be replayed. The pose extraction Workers overwrite them otherwise.
+     */
+    template<typename TDatums, typename TDatumsNoPtr>
+    class WDatumReplayer : public WorkerProducer<TDatums>
+    {
+    public:
+        explicit WDatumReplayer(const std::shared_ptr<DatumReplayer>& datumReplayer);
+
+        void initializationOnThread();
+
+        TDatums workProducer();
+
+    private:
+        std::shared_ptr<DatumReplayer> spDatumReplayer;
+
+        DELETE_COPY(WDatumReplayer);
+    };
+}
+
+
+
+
+
+// Implementation
+#include <openpose/core/datum.hpp>
+namespace op
+{
+    template<typename TDatums, typename TDatumsNoPtr>
+    WDatumReplayer<TDatums, TDatumsNoPtr>::WDatumReplayer(const std::shared_ptr<DatumReplayer>& datumReplayer) :
+        spDatumReplayer{datumReplayer}
+    {
+    }
+
+    template<typename TDatums, typename TDatumsNoPtr>
+    void WDatumReplayer<TDatums, TDatumsNoPtr>::initializationOnThread()
+    {
+    }
+
+    template<typename TDatums, typename TDatumsNoPtr>
+    TDatums WDatumReplayer<TDatums, TDatumsNoPtr>::workProducer()
+    {
+        try
+        {
+            // Debugging log
+            dLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            // Profiling speed
+            const auto profilerKey = Profiler::timerInit(__LINE__, __FUNCTION__, __FILE__);
+            // Get next recorded frame
+            RecordedFrame recordedFrame;
+            TDatums tDatums;
+            if (spDatumReplayer->getNextFrame(recordedFrame))
+            {
+                // Create and fill TDatums (the id is assigned later by WIdGenerator)
+                tDatums = std::make_shared<TDatumsNoPtr>(1);
+                auto& datum = (*tDatums)[0];
+                datum.name = recordedFrame.name;
+                datum.cvInputData = recordedFrame.cvInputData;
+                datum.cvOutputData = datum.cvInputData;
+                datum.scaleInputToNetInputs = recordedFrame.scaleInputToNetInputs;
+                datum.netInputSizes = recordedFrame.netInputSizes;
+                datum.scaleInputToOutput = recordedFrame.scaleInputToOutput;
+                datum.netOutputSize = recordedFrame.netOutputSize;
+                datum.scaleNetToOutput = recordedFrame.scaleNetToOutput;
+                datum.poseKeypoints = recordedFrame.poseKeypoints;
+                datum.poseScores = recordedFrame.poseScores;
+                datum.poseHeatMaps = recordedFrame.poseHeatMaps;
+            }
+            // Stop Worker if all the frames were replayed
+            else
+                this->stop();
+            // Profiling speed
+            Profiler::timerEnd(profilerKey);
+            Profiler::printAveragedTimeMsOnIterationX(profilerKey, __LINE__, __FUNCTION__, __FILE__);
+            // Debugging log
+            dLog("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            // Return TDatums
+            return tDatums;
+        }
+        catch (const std::exception& e)
+        {
+            this->stop();
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return TDatums{};
+        }
+    }
+
+    extern template class WDatumReplayer<DATUM_BASE, DATUM_BASE_NO_PTR>;
+}
+
+#endif // OPENPOSE_PRODUCER_W_DATUM_REPLAYER_HPP
@@ -11,6 +11,7 @@
 #include <openpose/thread/subThreadQueueIn.hpp>
 #include <openpose/thread/subThreadQueueInOut.hpp>
 #include <openpose/thread/subThreadQueueOut.hpp>
+#include <openpose/thread/taskPool.hpp>
 #include <openpose/thread/thread.hpp>
 #include <openpose/thread/threadManager.hpp>
 #include <openpose/thread/worker.hpp>
@@ -1,6 +1,8 @@
 #ifndef OPENPOSE_THREAD_SUB_THREAD_HPP
 #define OPENPOSE_THREAD_SUB_THREAD_HPP
 
+#include <atomic>
+#include <chrono>
 #include <openpose/core/common.hpp>
 #include <openpose/thread/worker.hpp>
 
@@ -19,6 +21,18 @@ namespace op
 
         virtual bool work() = 0;
 
+        // Service time statistics (only frames that went through the TWorkers are counted). Thread-safe.
+        inline unsigned long long getNumberServedFrames() const
+        {
+            return mServedFrames;
+        }
+
+        inline double getAverageServiceTimeMs() const
+        {
+            const unsigned long long servedFrames = mServedFrames;
+            return (servedFrames > 0 ? mServiceTimeNs / (1e6 * servedFrames) : 0.);
+        }
+
     protected:
         inline size_t getTWorkersSize() const
         {
@@ -29,6 +43,10 @@ namespace op
 
     private:
         std::vector<TWorker> mTWorkers;
+        std::atomic<unsigned long long> mServedFrames;
+        std::atomic<unsigned long long> mServiceTimeNs;
+
+        bool runTWorkers(TDatums& tDatums, const bool inputIsRunning);
 
         DELETE_COPY(SubThread);
     };
@@ -43,7 +61,9 @@ namespace op
 {
     template<typename TDatums, typename TWorker>
     SubThread<TDatums, TWorker>::SubThread(const std::vector<TWorker>& tWorkers) :
-        mTWorkers{tWorkers}
+        mTWorkers{tWorkers},
+        mServedFrames{0ull},
+        mServiceTimeNs{0ull}
     {
     }
 
@@ -54,6 +74,30 @@ namespace op
 
     template<typename TDatums, typename TWorker>
     bool SubThread<TDatums, TWorker>::workTWorkers(TDatums& tDatums, const bool inputIsRunning)
+    {
+        try
+        {
+            const auto beginTime = std::chrono::high_resolution_clock::now();
+            const auto workersAreRunning = runTWorkers(tDatums, inputIsRunning);
+            // Empty iterations (e.g. empty input queue) do not count as served frames
+            if (tDatums != nullptr)
+            {
+                mServiceTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::high_resolution_clock::now() - beginTime
+                ).count();
+                mServedFrames++;
+            }
+            return workersAreRunning;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    template<typename TDatums, typename TWorker>
+    bool SubThread<TDatums, TWorker>::runTWorkers(TDatums& tDatums, const bool inputIsRunning)
     {
         try
         {
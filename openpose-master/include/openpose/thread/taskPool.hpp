@@ -0,0 +1,84 @@
+#ifndef OPENPOSE_THREAD_TASK_POOL_HPP
+#define OPENPOSE_THREAD_TASK_POOL_HPP
+
+#include <functional>
+#include <openpose/core/common.hpp>
+#include <openpose/utilities/enumClasses.hpp>
+
+namespace op
+{
+    /**
+     * Accumulated statistics of all the TaskPool::parallelFor calls sharing the same task name.
+     */
+    struct OP_API TaskStatistics
+    {
+        std::string name;
+        unsigned long long calls;
+        unsigned long long tasks;
+        unsigned long long stolenTasks;
+        double totalMs;
+        double maxMs;
+    };
+
+    /**
+     * TaskPool: process-wide work-stealing task scheduler for intra-stage data parallelism.
+     * The ThreadManager threads parallelize the pipeline across frames, while TaskPool parallelizes the work of a
+     * single Worker (NMS, resize and merge, body part connection, rendering, etc.) across cores.
+     * Each pool thread owns a deque: it pops its own tasks from the back and steals from the front of the others.
+     * The thread calling parallelFor also executes tasks until its loop is done, so nested calls do not deadlock.
+     * In order to not oversubscribe the CPU, the number of pool threads should be set with
+     * setNumberPipelineThreads() (the Wrapper does it automatically in its configure() functions).
+     */
+    class OP_API TaskPool
+    {
+    public:
+        static TaskPool& getInstance();
+
+        ~TaskPool();
+
+        /**
+         * It resizes the pool to (#logical cores - numberPipelineThreads) threads, given that each pipeline thread
+         * also takes part in its own parallelFor calls.
+         * It must not be called while any parallelFor is running.
+         */
+        void setNumberPipelineThreads(const int numberPipelineThreads);
+
+        /**
+         * It sets the number of pool threads (not counting the caller of parallelFor). 0 makes parallelFor
+         * sequential.
+         * It must not be called while any parallelFor is running.
+         */
+        void setNumberThreads(const int numberThreads);
+
+        int getNumberThreads() const;
+
+        /**
+         * It splits [begin, end) into chunks of grainSize elements and calls function(chunkBegin, chunkEnd) for each
+         * of them, returning once all the chunks have been processed. Exceptions thrown inside function are
+         * re-thrown on the calling thread.
+         * @param taskName Key under which the statistics of this call are accumulated.
+         * @param grainSize Number of elements per chunk. If <= 0, it is automatically chosen to give a few chunks
+         * per thread.
+         */
+        void parallelFor(const std::string& taskName, const int begin, const int end,
+                         const std::function<void(const int, const int)>& function, const int grainSize = -1);
+
+        std::vector<TaskStatistics> getStatistics() const;
+
+        void printStatistics(const Priority priority = Priority::High) const;
+
+        void resetStatistics();
+
+    private:
+        // PIMPL idiom
+        // http://www.cppsamples.com/common-tasks/pimpl.html
+        struct ImplTaskPool;
+        std::unique_ptr<ImplTaskPool> upImpl;
+
+        TaskPool();
+
+        DELETE_COPY(TaskPool);
+    };
+}
+
+#endif // OPENPOSE_THREAD_TASK_POOL_HPP
@@ -2,8 +2,10 @@
 #define OPENPOSE_THREAD_THREAD_HPP
 
 #include <atomic>
+#include <mutex>
 #include <thread>
 #include <openpose/core/common.hpp>
+#include <openpose/utilities/fastMath.hpp>
 #include <openpose/thread/subThread.hpp>
 #include <openpose/thread/worker.hpp>
 
@@ -39,10 +41,37 @@ namespace op
             return *spIsRunning;
         }
 
+        /**
+         * Stage fusion: once all its sub-threads have served warmUpFrames frames, if the average service time of
+         * this thread plus the one of upstreamThread (or of the thread currently hosting it) is not higher than
+         * maxServiceTimeMs, this thread moves its sub-threads to the front of that thread and finishes, removing one
+         * queue hop (and its context switch) per frame.
+         * fusionMutex must be shared by all the Thread objects of the same pipeline.
+         */
+        void setStageFusion(const unsigned long long threadId, Thread* const upstreamThread,
+                            const std::shared_ptr<std::mutex>& fusionMutex, const unsigned long long warmUpFrames,
+                            const double maxServiceTimeMs);
+
+        // Sum of the average service time of its sub-threads
+        double getAverageServiceTimeMs();
+
+        // Minimum number of frames served among its sub-threads
+        unsigned long long getNumberServedFrames();
+
     private:
         std::shared_ptr<std::atomic<bool>> spIsRunning;
         std::vector<std::shared_ptr<SubThread<TDatums, TWorker>>> mSubThreads;
+        std::mutex mSubThreadsMutex;
+        std::atomic<bool> mSubThreadsChanged;
         std::thread mThread;
+        // Stage fusion
+        unsigned long long mThreadId;
+        Thread* pUpstreamThread;
+        Thread* pHostThread;
+        std::shared_ptr<std::mutex> spFusionMutex;
+        unsigned long long mFusionWarmUpFrames;
+        double mFusionMaxServiceTimeMs;
+        bool mFusionPending;
 
         void initializationOnThread();
 
@@ -52,6 +81,10 @@ namespace op
 
         void join();
 
+        void addFront(const std::vector<std::shared_ptr<SubThread<TDatums, TWorker>>>& subThreads);
+
+        bool tryFuseIntoUpstream();
+
         DELETE_COPY(Thread);
     };
 }
@@ -65,13 +98,28 @@ namespace op
 {
     template<typename TDatums, typename TWorker>
     Thread<TDatums, TWorker>::Thread(const std::shared_ptr<std::atomic<bool>>& isRunningSharedPtr) :
-        spIsRunning{(isRunningSharedPtr != nullptr ? isRunningSharedPtr : std::make_shared<std::atomic<bool>>(false))}
+        spIsRunning{(isRunningSharedPtr != nullptr ? isRunningSharedPtr : std::make_shared<std::atomic<bool>>(false))},
+        mSubThreadsChanged{true},
+        mThreadId{0ull},
+        pUpstreamThread{nullptr},
+        pHostThread{this},
+        mFusionWarmUpFrames{0ull},
+        mFusionMaxServiceTimeMs{0.},
+        mFusionPending{false}
     {
     }
 
     template<typename TDatums, typename TWorker>
     Thread<TDatums, TWorker>::Thread(Thread<TDatums, TWorker>&& t) :
-        spIsRunning{std::make_shared<std::atomic<bool>>(t.spIsRunning->load())}
+        spIsRunning{std::make_shared<std::atomic<bool>>(t.spIsRunning->load())},
+        mSubThreadsChanged{true},
+        mThreadId{t.mThreadId},
+        pUpstreamThread{t.pUpstreamThread},
+        pHostThread{this},
+        spFusionMutex{t.spFusionMutex},
+        mFusionWarmUpFrames{t.mFusionWarmUpFrames},
+        mFusionMaxServiceTimeMs{t.mFusionMaxServiceTimeMs},
+        mFusionPending{t.mFusionPending}
     {
         std::swap(mSubThreads, t.mSubThreads);
         std::swap(mThread, t.mThread);
@@ -83,6 +131,14 @@ namespace op
         std::swap(mSubThreads, t.mSubThreads);
         std::swap(mThread, t.mThread);
         spIsRunning = {std::make_shared<std::atomic<bool>>(t.spIsRunning->load())};
+        mSubThreadsChanged = {true};
+        mThreadId = {t.mThreadId};
+        pUpstreamThread = {t.pUpstreamThread};
+        pHostThread = {this};
+        spFusionMutex = {t.spFusionMutex};
+        mFusionWarmUpFrames = {t.mFusionWarmUpFrames};
+        mFusionMaxServiceTimeMs = {t.mFusionMaxServiceTimeMs};
+        mFusionPending = {t.mFusionPending};
         return *this;
     }
 
@@ -104,8 +160,10 @@ namespace op
     template<typename TDatums, typename TWorker>
     void Thread<TDatums, TWorker>::add(const std::vector<std::shared_ptr<SubThread<TDatums, TWorker>>>& subThreads)
     {
+        const std::lock_guard<std::mutex> lock{mSubThreadsMutex};
         for (const auto& subThread : subThreads)
             mSubThreads.emplace_back(subThread);
+        mSubThreadsChanged = true;
     }
 
     template<typename TDatums, typename TWorker>
@@ -160,11 +218,73 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TWorker>
+    void Thread<TDatums, TWorker>::setStageFusion(const unsigned long long threadId, Thread* const upstreamThread,
+                                                  const std::shared_ptr<std::mutex>& fusionMutex,
+                                                  const unsigned long long warmUpFrames,
+                                                  const double maxServiceTimeMs)
+    {
+        try
+        {
+            if (upstreamThread == nullptr || upstreamThread == this || fusionMutex == nullptr)
+                error("Invalid upstream thread or fusion mutex.", __LINE__, __FUNCTION__, __FILE__);
+            mThreadId = {threadId};
+            pUpstreamThread = {upstreamThread};
+            spFusionMutex = {fusionMutex};
+            mFusionWarmUpFrames = {warmUpFrames};
+            mFusionMaxServiceTimeMs = {maxServiceTimeMs};
+            mFusionPending = {true};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TWorker>
+    double Thread<TDatums, TWorker>::getAverageServiceTimeMs()
+    {
+        try
+        {
+            const std::lock_guard<std::mutex> lock{mSubThreadsMutex};
+            auto averageServiceTimeMs = 0.;
+            for (const auto& subThread : mSubThreads)
+                averageServiceTimeMs += subThread->getAverageServiceTimeMs();
+            return averageServiceTimeMs;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 0.;
+        }
+    }
+
+    template<typename TDatums, typename TWorker>
+    unsigned long long Thread<TDatums, TWorker>::getNumberServedFrames()
+    {
+        try
+        {
+            const std::lock_guard<std::mutex> lock{mSubThreadsMutex};
+            if (mSubThreads.empty())
+                return 0ull;
+            auto numberServedFrames = mSubThreads[0]->getNumberServedFrames();
+            for (const auto& subThread : mSubThreads)
+                numberServedFrames = fastMin(numberServedFrames, subThread->getNumberServedFrames());
+            return numberServedFrames;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 0ull;
+        }
+    }
+
     template<typename TDatums, typename TWorker>
     void Thread<TDatums, TWorker>::initializationOnThread()
     {
         try
         {
+            const std::lock_guard<std::mutex> lock{mSubThreadsMutex};
             for (auto& subThread : mSubThreads)
                 subThread->initializationOnThread();
         }
@@ -183,18 +303,37 @@ namespace op
             initializationOnThread();
 
             log("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            std::vector<std::shared_ptr<SubThread<TDatums, TWorker>>> subThreads;
             while (isRunning())
             {
+                // Sub-threads added by a downstream thread (stage fusion) -> update local copy
+                if (mSubThreadsChanged)
+                {
+                    const std::lock_guard<std::mutex> lock{mSubThreadsMutex};
+                    subThreads = mSubThreads;
+                    mSubThreadsChanged = false;
+                }
+
                 bool allSubThreadsClosed = true;
-                for (auto& subThread : mSubThreads)
+                for (auto& subThread : subThreads)
                     allSubThreadsClosed &= !subThread->work();
 
                 if (allSubThreadsClosed)
                 {
-                    log("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
-                    stop();
-                    break;
+                    // Do not finish if a downstream thread has just been fused into this one
+                    std::unique_lock<std::mutex> fusionLock;
+                    if (spFusionMutex != nullptr)
+                        fusionLock = std::unique_lock<std::mutex>{*spFusionMutex};
+                    if (!mSubThreadsChanged)
+                    {
+                        log("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+                        stop();
+                        break;
+                    }
                 }
+                // Stage fusion
+                else if (mFusionPending && tryFuseIntoUpstream())
+                    break;
             }
             log("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
         }
@@ -217,6 +356,71 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TWorker>
+    void Thread<TDatums, TWorker>::addFront(const std::vector<std::shared_ptr<SubThread<TDatums, TWorker>>>& subThreads)
+    {
+        try
+        {
+            // Added at the front: downstream sub-threads first pop from the intermediate queue, so the upstream ones
+            // never block on it when it is full
+            const std::lock_guard<std::mutex> lock{mSubThreadsMutex};
+            mSubThreads.insert(mSubThreads.begin(), subThreads.begin(), subThreads.end());
+            mSubThreadsChanged = true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template<typename TDatums, typename TWorker>
+    bool Thread<TDatums, TWorker>::tryFuseIntoUpstream()
+    {
+        try
+        {
+            // Warm-up
+            if (getNumberServedFrames() < mFusionWarmUpFrames)
+                return false;
+            const std::lock_guard<std::mutex> fusionLock{*spFusionMutex};
+            // Upstream thread already fused into another one -> use the final host
+            auto* hostThread = pUpstreamThread;
+            while (hostThread->pHostThread != hostThread)
+                hostThread = hostThread->pHostThread;
+            if (!hostThread->isRunning())
+            {
+                mFusionPending = false;
+                return false;
+            }
+            if (hostThread->getNumberServedFrames() < mFusionWarmUpFrames)
+                return false;
+            // Fusion plan (decided only once)
+            mFusionPending = false;
+            const auto serviceTimeMs = getAverageServiceTimeMs();
+            const auto hostServiceTimeMs = hostThread->getAverageServiceTimeMs();
+            const auto fuse = (serviceTimeMs + hostServiceTimeMs <= mFusionMaxServiceTimeMs);
+            log("Stage fusion: thread " + std::to_string(mThreadId) + " (" + std::to_string(serviceTimeMs)
+                + " ms/frame) " + (fuse ? "fused into" : "kept apart from") + " thread "
+                + std::to_string(hostThread->mThreadId) + " (" + std::to_string(hostServiceTimeMs) + " ms/frame).",
+                Priority::High);
+            if (!fuse)
+                return false;
+            // Move sub-threads to the host thread
+            std::vector<std::shared_ptr<SubThread<TDatums, TWorker>>> subThreads;
+            {
+                const std::lock_guard<std::mutex> lock{mSubThreadsMutex};
+                std::swap(subThreads, mSubThreads);
+            }
+            hostThread->addFront(subThreads);
+            pHostThread = hostThread;
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
     template<typename TDatums, typename TWorker>
     void Thread<TDatums, TWorker>::join()
     {
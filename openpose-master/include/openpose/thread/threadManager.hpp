@@ -2,6 +2,7 @@
 #define OPENPOSE_THREAD_THREAD_MANAGER_HPP
 
 #include <atomic>
+#include <mutex>
 #include <set> // std::multiset
 #include <tuple>
 #include <openpose/core/common.hpp>
@@ -21,6 +22,16 @@ namespace op
 
         void setDefaultMaxSizeQueues(const long long defaultMaxSizeQueues = -1);
 
+        /**
+         * Stage fusion: after warmUpFrames frames, each thread that is the only consumer of a queue with a single
+         * producer thread will be moved into that producer thread if the sum of both average service times is not
+         * higher than maxServiceTimeMs. Heavy stages keep their own thread. The resulting plan is logged.
+         * The last thread (i.e. the one run by exec(), usually the GUI) is never moved.
+         * It must be called before start() or exec().
+         */
+        void setStageFusion(const bool enabled, const unsigned long long warmUpFrames = 30ull,
+                            const double maxServiceTimeMs = 1.);
+
         void add(const unsigned long long threadId, const std::vector<TWorker>& tWorkers, const unsigned long long queueInId, const unsigned long long queueOutId);
 
         void add(const unsigned long long threadId, const TWorker& tWorker, const unsigned long long queueInId, const unsigned long long queueOutId);
@@ -59,6 +70,9 @@ namespace op
         const ThreadManagerMode mThreadManagerMode;
         std::shared_ptr<std::atomic<bool>> spIsRunning;
         long long mDefaultMaxSizeQueues;
+        bool mStageFusion;
+        unsigned long long mFusionWarmUpFrames;
+        double mFusionMaxServiceTimeMs;
         std::multiset<std::tuple<unsigned long long, std::vector<TWorker>, unsigned long long, unsigned long long>> mThreadWorkerQueues;
         std::vector<std::shared_ptr<Thread<TDatums, TWorker>>> mThreads;
         std::vector<std::shared_ptr<TQueue>> mTQueues;
@@ -73,6 +87,8 @@ namespace op
 
         void checkAndCreateQueues();
 
+        void configureStageFusion();
+
         DELETE_COPY(ThreadManager);
     };
 }
@@ -95,7 +111,10 @@ namespace op
     ThreadManager<TDatums, TWorker, TQueue>::ThreadManager(const ThreadManagerMode threadManagerMode) :
         mThreadManagerMode{threadManagerMode},
         spIsRunning{std::make_shared<std::atomic<bool>>(false)},
-        mDefaultMaxSizeQueues{-1ll}
+        mDefaultMaxSizeQueues{-1ll},
+        mStageFusion{false},
+        mFusionWarmUpFrames{30ull},
+        mFusionMaxServiceTimeMs{1.}
     {
     }
 
@@ -112,6 +131,23 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TWorker, typename TQueue>
+    void ThreadManager<TDatums, TWorker, TQueue>::setStageFusion(const bool enabled,
+                                                                 const unsigned long long warmUpFrames,
+                                                                 const double maxServiceTimeMs)
+    {
+        try
+        {
+            mStageFusion = {enabled};
+            mFusionWarmUpFrames = {warmUpFrames};
+            mFusionMaxServiceTimeMs = {maxServiceTimeMs};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     template<typename TDatums, typename TWorker, typename TQueue>
     void ThreadManager<TDatums, TWorker, TQueue>::add(const unsigned long long threadId, const std::vector<TWorker>& tWorkers, const unsigned long long queueInId,
                                                       const unsigned long long queueOutId)
@@ -409,6 +445,9 @@ namespace op
                         subThread = {std::make_shared<SubThreadNoQueue<TDatums, TWorker>>(tWorkers)};
                     thread->add(subThread);
                 }
+
+                // Stage fusion
+                configureStageFusion();
             }
             else
                 error("Empty, no TWorker(s) added.", __LINE__);
@@ -499,6 +538,53 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TWorker, typename TQueue>
+    void ThreadManager<TDatums, TWorker, TQueue>::configureStageFusion()
+    {
+        try
+        {
+            if (mStageFusion && mThreads.size() > 1)
+            {
+                // Threads reading from and writing to each queue id
+                auto maxQueueId = 0ull;
+                for (const auto& threadWorkerQueue : mThreadWorkerQueues)
+                    maxQueueId = fastMax(maxQueueId, fastMax(std::get<2>(threadWorkerQueue),
+                                                             std::get<3>(threadWorkerQueue)));
+                std::vector<std::set<unsigned long long>> queueReaders(maxQueueId+1);
+                std::vector<std::set<unsigned long long>> queueWriters(maxQueueId+1);
+                std::vector<unsigned long long> threadQueueIns(mThreads.size(), maxQueueId+1);
+                for (const auto& threadWorkerQueue : mThreadWorkerQueues)
+                {
+                    const auto threadId = std::get<0>(threadWorkerQueue);
+                    const auto queueIn = std::get<2>(threadWorkerQueue);
+                    queueReaders[queueIn].insert(threadId);
+                    queueWriters[std::get<3>(threadWorkerQueue)].insert(threadId);
+                    threadQueueIns[threadId] = fastMin(threadQueueIns[threadId], queueIn);
+                }
+                // Fusion candidates: single reader & single (different) writer. Last thread never moved
+                const auto fusionMutex = std::make_shared<std::mutex>();
+                for (auto threadId = 0ull ; threadId < mThreads.size() - 1 ; threadId++)
+                {
+                    const auto queueIn = threadQueueIns[threadId];
+                    if (queueIn <= maxQueueId && queueReaders[queueIn].size() == 1
+                        && queueWriters[queueIn].size() == 1 && *queueWriters[queueIn].begin() != threadId)
+                    {
+                        const auto upstreamThreadId = *queueWriters[queueIn].begin();
+                        mThreads[threadId]->setStageFusion(threadId, mThreads[upstreamThreadId].get(), fusionMutex,
+                                                           mFusionWarmUpFrames, mFusionMaxServiceTimeMs);
+                        log("Stage fusion candidate: thread " + std::to_string(threadId) + " into thread "
+                            + std::to_string(upstreamThreadId) + ".", Priority::Low, __LINE__, __FUNCTION__,
+                            __FILE__);
+                    }
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     COMPILE_TEMPLATE_DATUM(ThreadManager);
 }
 
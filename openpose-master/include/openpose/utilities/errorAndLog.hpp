@@ -2,6 +2,7 @@
 #define OPENPOSE_UTILITIES_ERROR_AND_LOG_HPP
 
 #include <atomic>
+#include <cstdio> // std::snprintf
 #include <mutex>
 #include <sstream> // std::stringstream
 #include <string>
@@ -78,6 +79,45 @@ namespace op
 
         static void setLogModes(const std::vector<LogMode>& loggingModes);
     };
+
+    // Compile-time logging level: OP_LOG messages with a lower priority are removed by the compiler.
+    // E.g. compile with -DOP_LOG_MIN_PRIORITY=3 to only keep the Priority::High and Priority::Max ones.
+    #ifndef OP_LOG_MIN_PRIORITY
+        #define OP_LOG_MIN_PRIORITY 0
+    #endif
+
+    // Asynchronous printf-like logging (no std::string is created) - How to use:
+        // OP_LOG(Priority::Low, "Person %d at (%d, %d)", person, x, y);
+    // The message is only formatted if its priority passes both the compile-time (OP_LOG_MIN_PRIORITY) and the
+    // run-time (ConfigureLog) thresholds. It is then pushed into a lock-free ring buffer that a background thread
+    // writes to std::cout and/or file (according to ConfigureLog::getLogModes()). If the ring is full, the message
+    // is dropped (and counted) instead of blocking the caller.
+    #define OP_LOG(priority, ...) op::logAsync<priority>(__LINE__, __FUNCTION__, __FILE__, __VA_ARGS__)
+
+    const auto LOG_ASYNC_MESSAGE_SIZE = 256u;
+
+    OP_API void logAsyncFormatted(const char* const message, const int line, const char* const function,
+                                  const char* const file);
+
+    template<Priority priority>
+    inline void logAsync(const int line, const char* const function, const char* const file,
+                         const char* const message)
+    {
+        if ((int)priority >= OP_LOG_MIN_PRIORITY && priority >= ConfigureLog::getPriorityThreshold())
+            logAsyncFormatted(message, line, function, file);
+    }
+
+    template<Priority priority, typename... T>
+    inline void logAsync(const int line, const char* const function, const char* const file,
+                         const char* const format, const T&... args)
+    {
+        if ((int)priority >= OP_LOG_MIN_PRIORITY && priority >= ConfigureLog::getPriorityThreshold())
+        {
+            char message[LOG_ASYNC_MESSAGE_SIZE];
+            std::snprintf(message, LOG_ASYNC_MESSAGE_SIZE, format, args...);
+            logAsyncFormatted(message, line, function, file);
+        }
+    }
 }
 
 #endif // OPENPOSE_UTILITIES_ERROR_AND_LOG_HPP
@@ -10,6 +10,7 @@
 #include <openpose/utilities/fileSystem.hpp>
 #include <openpose/utilities/flagsToOpenPose.hpp>
 #include <openpose/utilities/keypoint.hpp>
+#include <openpose/utilities/memoryMappedFile.hpp>
 #include <openpose/utilities/openCv.hpp>
 #include <openpose/utilities/pointerContainer.hpp>
 #include <openpose/utilities/profiler.hpp>
@@ -1,6 +1,7 @@
 #ifndef OPENPOSE_UTILITIES_KEYPOINT_HPP
 #define OPENPOSE_UTILITIES_KEYPOINT_HPP
 
+#include <array>
 #include <openpose/core/common.hpp>
 
 namespace op
@@ -16,10 +17,16 @@ namespace op
     OP_API void scaleKeypoints(Array<float>& keypoints, const float scaleX, const float scaleY, const float offsetX,
                                const float offsetY);
 
+    /**
+     * @param poseIds Person ids (PersonIdExtractor), only used together with trainPersonIds.
+     * @param trainPersonIds If not nullptr, ids of the upper and lower trainees of the previous frames, kept
+     * selected while their ids are tracked (pose rendering only). An empty poseIds keeps them unchanged.
+     */
     OP_API void renderKeypointsCpu(Array<float>& frameArray, const Array<float>& keypoints,
                                    const std::vector<unsigned int>& pairs, const std::vector<float> colors,
                                    const float thicknessCircleRatio, const float thicknessLineRatioWRTCircle,
-                                   const float threshold);
+                                   const float threshold, const Array<long long>& poseIds = Array<long long>{},
+                                   std::array<long long, 2>* trainPersonIds = nullptr);
 
     OP_API Rectangle<float> getKeypointsRectangle(const Array<float>& keypoints, const int person,
                                                   const float threshold);
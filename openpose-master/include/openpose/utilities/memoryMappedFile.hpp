@@ -0,0 +1,39 @@
+#ifndef OPENPOSE_UTILITIES_MEMORY_MAPPED_FILE_HPP
+#define OPENPOSE_UTILITIES_MEMORY_MAPPED_FILE_HPP
+
+#include <openpose/core/common.hpp>
+
+namespace op
+{
+    /**
+     * MemoryMappedFile maps a whole file into memory (mmap), so its content can be used in place without copying it.
+     * The mapping is private: if copyOnWrite is true, the memory can be modified without modifying the file,
+     * otherwise it is read-only. On Windows, the file is read into an 8-byte aligned buffer instead.
+     */
+    class OP_API MemoryMappedFile
+    {
+    public:
+        explicit MemoryMappedFile(const std::string& filePath, const bool copyOnWrite = false);
+
+        ~MemoryMappedFile();
+
+        const char* getConstPtr() const;
+
+        /**
+         * Only valid if copyOnWrite is true.
+         */
+        char* getPtr();
+
+        unsigned long long getSize() const;
+
+    private:
+        // PIMPL idiom
+        // http://www.cppsamples.com/common-tasks/pimpl.html
+        struct ImplMemoryMappedFile;
+        std::unique_ptr<ImplMemoryMappedFile> upImpl;
+
+        DELETE_COPY(MemoryMappedFile);
+    };
+}
+
+#endif // OPENPOSE_UTILITIES_MEMORY_MAPPED_FILE_HPP
@@ -55,6 +55,18 @@ namespace op
          */
         void disableMultiThreading();
 
+        /**
+         * Configure the automatic stage fusion (disabled by default).
+         * During the first warmUpFrames frames, the service time of each thread is measured. Then, adjacent light
+         * threads (whose added service time is not higher than maxServiceTimeMs) are fused into a single thread,
+         * saving a queue hop per frame. Heavy stages (e.g. pose estimation) keep their own thread. The fusion plan is
+         * logged. It must be called before start() or exec().
+         * Note: The fused workers keep the state of the thread where initializationOnThread() was called, so do not
+         * enable it with user workers whose state is bound to their thread (e.g., thread-local GPU contexts).
+         */
+        void setStageFusion(const bool enabled, const unsigned long long warmUpFrames = 30ull,
+                            const double maxServiceTimeMs = 1.);
+
         /**
          * Add an user-defined extra Worker as frames generator.
          * @param worker TWorker to be added.
@@ -268,6 +280,7 @@ namespace op
 #include <openpose/producer/headers.hpp>
 #include <openpose/experimental/tracking/headers.hpp>
 #include <openpose/utilities/cuda.hpp>
+#include <openpose/utilities/fastMath.hpp>
 #include <openpose/utilities/fileSystem.hpp>
 #include <openpose/utilities/standard.hpp>
 namespace op
@@ -319,6 +332,20 @@ namespace op
         }
     }
 
+    template<typename TDatums, typename TWorker, typename TQueue>
+    void Wrapper<TDatums, TWorker, TQueue>::setStageFusion(const bool enabled, const unsigned long long warmUpFrames,
+                                                           const double maxServiceTimeMs)
+    {
+        try
+        {
+            mThreadManager.setStageFusion(enabled, warmUpFrames, maxServiceTimeMs);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     template<typename TDatums, typename TWorker, typename TQueue>
     void Wrapper<TDatums, TWorker, TQueue>::setWorkerInput(const TWorker& worker, const bool workerOnNewThread)
     {
@@ -488,8 +515,9 @@ namespace op
                     !wrapperStructOutput.writeImages.empty() || !wrapperStructOutput.writeVideo.empty()
                         || !wrapperStructOutput.writeKeypoint.empty() || !wrapperStructOutput.writeKeypointJson.empty()
                         || !wrapperStructOutput.writeCocoJson.empty() || !wrapperStructOutput.writeHeatMaps.empty()
+                        || !wrapperStructOutput.writeRecording.empty()
                 );
-                if (!wrapperStructOutput.displayGui && !savingSomething)
+                if (!wrapperStructOutput.displayGui && !savingSomething && wrapperStructInput.replayRecording.empty())
                 {
                     const auto message = "No output is selected (`no_display`) and no results are generated (no"
                                          " `write_X` flags enabled). Thus, no output would be generated."
@@ -520,6 +548,9 @@ namespace op
                     log(message, Priority::High);
                 }
             }
+            if (!wrapperStructInput.replayRecording.empty() && wrapperStructInput.producerSharedPtr != nullptr)
+                error("A recording cannot be replayed (`replay_recording`) while another producer is also used (i.e."
+                      " wrapperStructInput.producerSharedPtr must be a nullptr).", __LINE__, __FUNCTION__, __FILE__);
             if (!wrapperStructOutput.writeVideo.empty() && wrapperStructInput.producerSharedPtr == nullptr)
                 error("Writting video is only available if the OpenPose producer is used (i.e."
                       " wrapperStructInput.producerSharedPtr cannot be a nullptr).", __LINE__, __FUNCTION__, __FILE__);
@@ -550,6 +581,9 @@ namespace op
                     + " GPU(s), using " + std::to_string(gpuNumber) + " of them starting at GPU "
                     + std::to_string(gpuNumberStart) + ".", Priority::High);
             }
+            // Person ids available to the face and hand detectors (frames in order, i.e., a single pose worker)
+            const auto personIdsOnPoseWorker = (wrapperStructPose.enable && wrapperStructPose.identification
+                                                && gpuNumber == 1);
 
             // Proper format
             const auto writeImagesCleaned = formatAsDirectory(wrapperStructOutput.writeImages);
@@ -588,9 +622,26 @@ namespace op
                 );
                 wDatumProducer = std::make_shared<WDatumProducer<TDatumsPtr, TDatums>>(datumProducer);
             }
-            else
+            // Recording replay
+            std::shared_ptr<DatumReplayer> datumReplayer;
+            if (!wrapperStructInput.replayRecording.empty())
+            {
+                datumReplayer = std::make_shared<DatumReplayer>(
+                    wrapperStructInput.replayRecording, wrapperStructInput.realTimeProcessing,
+                    wrapperStructInput.replayTolerance
+                );
+                wDatumProducer = std::make_shared<WDatumReplayer<TDatumsPtr, TDatums>>(datumReplayer);
+                producerSize = datumReplayer->getFrameSize();
+                // Set finalOutputSize to input size if desired
+                if (finalOutputSize.x == -1 || finalOutputSize.y == -1)
+                    finalOutputSize = producerSize;
+            }
+            else if (wrapperStructInput.producerSharedPtr == nullptr)
                 wDatumProducer = nullptr;
 
+            // Per-layer profiling of the Caffe networks (process-wide)
+            NetCaffe::setLayerProfiling(wrapperStructPose.profileLayersFrames, wrapperStructPose.profileLayersFolder);
+
             std::vector<std::shared_ptr<PoseExtractor>> poseExtractors;
             std::vector<std::shared_ptr<PoseGpuRenderer>> poseGpuRenderers;
             std::shared_ptr<PoseCpuRenderer> poseCpuRenderer;
@@ -601,11 +652,37 @@ namespace op
                     wrapperStructPose.netInputSize, finalOutputSize, wrapperStructPose.scalesNumber,
                     wrapperStructPose.scaleGap
                 );
-                spWScaleAndSizeExtractor = std::make_shared<WScaleAndSizeExtractor<TDatumsPtr>>(scaleAndSizeExtractor);
+                // ROI-cropped inference (updated by the pose extractors)
+                const auto inputRoiTracker = (wrapperStructPose.enable && wrapperStructPose.roiFullFrameInterval > 0
+                    ? std::make_shared<InputRoiTracker>(wrapperStructPose.roiFullFrameInterval,
+                                                        wrapperStructPose.roiPadding)
+                    : nullptr);
+                // Adaptive net resolution (given the latency by the pose extractors)
+                const auto netResolutionController = (wrapperStructPose.enable
+                                                      && wrapperStructPose.netResolutionTargetMs > 0.
+                    ? std::make_shared<NetResolutionController>(wrapperStructPose.netInputSize,
+                                                                wrapperStructPose.netResolutionTargetMs,
+                                                                wrapperStructPose.netResolutionMinHeight)
+                    : nullptr);
+                spWScaleAndSizeExtractor = std::make_shared<WScaleAndSizeExtractor<TDatumsPtr>>(
+                    scaleAndSizeExtractor, inputRoiTracker, netResolutionController
+                );
+
+                // Motion gating (the previous keypoints are kept by the pose extractor, i.e., a single one)
+                std::shared_ptr<MotionGate> motionGate;
+                if (wrapperStructPose.enable && wrapperStructPose.motionGateThreshold > 0.f)
+                {
+                    if (gpuNumber == 1)
+                        motionGate = std::make_shared<MotionGate>(wrapperStructPose.motionGateThreshold,
+                                                                  wrapperStructPose.motionGateMaxReusedFrames);
+                    else
+                        log("Motion gating disabled: it requires a single pose worker (gpuNumber = 1).",
+                            Priority::High, __LINE__, __FUNCTION__, __FILE__);
+                }
 
                 // Input cvMat to OpenPose input & output format
                 const auto cvMatToOpInput = std::make_shared<CvMatToOpInput>();
-                spWCvMatToOpInput = std::make_shared<WCvMatToOpInput<TDatumsPtr>>(cvMatToOpInput);
+                spWCvMatToOpInput = std::make_shared<WCvMatToOpInput<TDatumsPtr>>(cvMatToOpInput, motionGate);
                 if (renderOutput)
                 {
                     const auto cvMatToOpOutput = std::make_shared<CvMatToOpOutput>();
@@ -618,12 +695,28 @@ namespace op
                 spWPoses.resize(gpuNumber);
                 if (wrapperStructPose.enable)
                 {
+                    // CPU layer threads per pose worker (all the cores split between the parallel workers)
+                    auto intraOpThreads = wrapperStructPose.intraOpThreads;
+                    if (intraOpThreads < 0)
+                        intraOpThreads = fastMax(1, (int)std::thread::hardware_concurrency() / gpuNumber);
+                    // Local peak search (the previous people are kept by the pose extractor, i.e., a single one, and
+                    // its keypoints are relative to the ROI in ROI-cropped inference)
+                    auto localPeakSearchInterval = wrapperStructPose.localPeakSearchInterval;
+                    if (localPeakSearchInterval > 0 && (gpuNumber != 1 || inputRoiTracker != nullptr))
+                    {
+                        log("Local peak search disabled: it requires a single pose worker (gpuNumber = 1) and no"
+                            " ROI-cropped inference.", Priority::High, __LINE__, __FUNCTION__, __FILE__);
+                        localPeakSearchInterval = 0;
+                    }
                     // Pose estimators
                     for (auto gpuId = 0; gpuId < gpuNumber; gpuId++)
                         poseExtractors.emplace_back(std::make_shared<PoseExtractorCaffe>(
                             wrapperStructPose.poseModel, modelFolder, gpuId + gpuNumberStart,
                             wrapperStructPose.heatMapTypes, wrapperStructPose.heatMapScale,
-                            wrapperStructPose.enableGoogleLogging
+                            wrapperStructPose.enableGoogleLogging, intraOpThreads, wrapperStructPose.int8Inference,
+                            wrapperStructPose.earlyExitStage, wrapperStructPose.earlyExitThreshold,
+                            wrapperStructPose.interOpThreads, localPeakSearchInterval, wrapperStructPose.tileSize,
+                            wrapperStructPose.tileOverlap
                         ));
 
                     // Pose renderers
@@ -658,10 +751,35 @@ namespace op
                     }
                     log("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
 
+                    // Keyframe mode (optical flow needs consecutive frames, i.e., a single pose worker)
+                    std::shared_ptr<PoseKeypointPropagator> poseKeypointPropagator;
+                    if (wrapperStructPose.keyframeInterval > 1)
+                    {
+                        if (poseExtractors.size() == 1u)
+                            poseKeypointPropagator = std::make_shared<PoseKeypointPropagator>(
+                                wrapperStructPose.keyframeInterval, wrapperStructPose.keyframeMotionThreshold,
+                                wrapperStructPose.keyframeMinTrackedRatio
+                            );
+                        else
+                            log("Keyframe mode disabled: it requires a single pose worker (gpuNumber = 1).",
+                                Priority::High, __LINE__, __FUNCTION__, __FILE__);
+                    }
                     // Pose extractor(s)
                     spWPoses.resize(poseExtractors.size());
                     for (auto i = 0u; i < spWPoses.size(); i++)
-                        spWPoses.at(i) = {std::make_shared<WPoseExtractor<TDatumsPtr>>(poseExtractors.at(i))};
+                        spWPoses.at(i) = {std::make_shared<WPoseExtractor<TDatumsPtr>>(poseExtractors.at(i),
+                                                                                        poseKeypointPropagator,
+                                                                                        inputRoiTracker,
+                                                                                        netResolutionController)};
+                    // Person ID identification before the face and hand detectors (so they can track each person),
+                    // only if the frames are in order (i.e., a single pose worker)
+                    if (personIdsOnPoseWorker)
+                    {
+                        const auto personIdExtractor = std::make_shared<PersonIdExtractor>();
+                        spWPoses.at(0).emplace_back(
+                            std::make_shared<WPersonIdExtractor<TDatumsPtr>>(personIdExtractor)
+                        );
+                    }
                 }
 
 
@@ -672,9 +790,14 @@ namespace op
                     // OpenPose face detector
                     if (wrapperStructPose.enable)
                     {
+                        if (wrapperStructFace.tracking && !personIdsOnPoseWorker)
+                            log("Face tracking requires person identification with a single pose worker"
+                                " (gpuNumber = 1).", Priority::High, __LINE__, __FUNCTION__, __FILE__);
                         const auto faceDetector = std::make_shared<FaceDetector>(wrapperStructPose.poseModel);
                         for (auto gpu = 0u; gpu < spWPoses.size(); gpu++)
-                            spWPoses.at(gpu).emplace_back(std::make_shared<WFaceDetector<TDatumsPtr>>(faceDetector));
+                            spWPoses.at(gpu).emplace_back(std::make_shared<WFaceDetector<TDatumsPtr>>(
+                                faceDetector, wrapperStructFace.tracking && personIdsOnPoseWorker
+                            ));
                     }
                     // OpenCV face detector
                     else
@@ -684,7 +807,11 @@ namespace op
                         for (auto gpu = 0u; gpu < spWPoses.size(); gpu++)
                         {
                             // 1 FaceDetectorOpenCV per thread, OpenCV face detector is not thread-safe
-                            const auto faceDetectorOpenCV = std::make_shared<FaceDetectorOpenCV>(modelFolder);
+                            // Tracking: only with frames in order (i.e., a single worker)
+                            const auto faceDetectorOpenCV = std::make_shared<FaceDetectorOpenCV>(
+                                modelFolder, (wrapperStructFace.tracking && spWPoses.size() == 1u
+                                              ? FACE_OPENCV_FULL_SCAN_INTERVAL : 1)
+                            );
                             spWPoses.at(gpu).emplace_back(
                                 std::make_shared<WFaceDetectorOpenCV<TDatumsPtr>>(faceDetectorOpenCV)
                             );
@@ -833,7 +960,7 @@ namespace op
                 if (spWPoses.size() > 1u)
                     mPostProcessingWs.emplace_back(std::make_shared<WQueueOrderer<TDatumsPtr>>());
                 // Person ID identification
-                if (wrapperStructPose.identification)
+                if (wrapperStructPose.identification && !personIdsOnPoseWorker)
                 {
                     const auto personIdExtractor = std::make_shared<PersonIdExtractor>();
                     mPostProcessingWs.emplace_back(
@@ -864,6 +991,9 @@ namespace op
             }
 
             mOutputWs.clear();
+            // Check replayed keypoints against the recording (first, so the latency does not include the outputs)
+            if (datumReplayer != nullptr)
+                mOutputWs.emplace_back(std::make_shared<WDatumReplayChecker<TDatumsPtr>>(datumReplayer));
             // Write people pose data on disk (json for OpenCV >= 3, xml, yml...)
             if (!writeKeypointCleaned.empty())
             {
@@ -917,6 +1047,13 @@ namespace op
                                                                          wrapperStructOutput.writeHeatMapsFormat);
                 mOutputWs.emplace_back(std::make_shared<WHeatMapSaver<TDatumsPtr>>(heatMapSaver));
             }
+            // Write Datum recording on hard disk
+            if (!wrapperStructOutput.writeRecording.empty())
+            {
+                const auto datumRecorder = std::make_shared<DatumRecorder>(wrapperStructOutput.writeRecording,
+                                                                           !wrapperStructPose.heatMapTypes.empty());
+                mOutputWs.emplace_back(std::make_shared<WDatumRecorder<TDatumsPtr>>(datumRecorder));
+            }
             // Add frame information for GUI
             // If this WGuiInfoAdder instance is placed before the WImageSaver or WVideoSaver, then the resulting
             // recorded frames will look exactly as the final displayed image by the GUI
@@ -1299,6 +1436,8 @@ namespace op
                 mThreadManager.add(mThreadId, spWGui, queueIn++, queueOut++);
                 threadIdPP();
             }
+            // Intra-stage parallelism: TaskPool threads + pipeline threads = #logical cores
+            TaskPool::getInstance().setNumberPipelineThreads(mMultiThreadEnabled ? (int)mThreadId : 1);
             log("", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
         }
         catch (const std::exception& e)
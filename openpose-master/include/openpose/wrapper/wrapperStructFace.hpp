@@ -51,6 +51,15 @@ namespace op
          */
         float renderThreshold;
 
+        /**
+         * Whether to reuse the face rectangles of the previous frames. With body keypoints and person ids
+         * (WrapperStructPose::identification and a single GPU/CPU pose worker), each face rectangle is refined with
+         * the one of the same person id (or reused if its head keypoints are missed), and low-confidence people are
+         * skipped. With the OpenCV face detector (body disabled), the whole frame is only scanned every
+         * FACE_OPENCV_FULL_SCAN_INTERVAL frames, and only around the previous faces otherwise.
+         */
+        bool tracking;
+
         /**
          * Constructor of the struct.
          * It has the recommended and default values we recommend for each element of the struct.
@@ -60,7 +69,7 @@ namespace op
                           const RenderMode renderMode = RenderMode::None,
                           const float alphaKeypoint = FACE_DEFAULT_ALPHA_KEYPOINT,
                           const float alphaHeatMap = FACE_DEFAULT_ALPHA_HEAT_MAP,
-                          const float renderThreshold = 0.4f);
+                          const float renderThreshold = 0.4f, const bool tracking = false);
     };
 }
 
@@ -41,8 +41,9 @@ namespace op
 
         /**
          * Whether to add tracking between frames. Adding hand tracking might improve hand keypoints detection for webcam (if the frame rate
-         * is high enough, i.e. >7 FPS per GPU) and video. This is not person ID tracking, it simply looks for hands in positions at which hands
-         * were located in previous frames, but it does not guarantee the same person id among frames.
+         * is high enough, i.e. >7 FPS per GPU) and video. By default, it simply looks for hands in positions at which hands were located in
+         * previous frames, but it does not guarantee the same person id among frames. With person ids (WrapperStructPose::identification
+         * and a single GPU/CPU pose worker), each person only reuses the hands of the same person id, and low-confidence people are skipped.
          */
         bool tracking;
 
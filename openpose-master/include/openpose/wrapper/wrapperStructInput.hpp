@@ -51,6 +51,20 @@ namespace op
          */
         bool framesRepeat;
 
+        /**
+         * Datum recording (see WrapperStructOutput::writeRecording) to replay instead of using producerSharedPtr.
+         * Frames are replayed at the recorded pacing if realTimeProcessing is enabled, or as fast as possible
+         * otherwise, and the resulting keypoints are checked against the recorded ones.
+         * If it is empty (default), it is disabled.
+         */
+        std::string replayRecording;
+
+        /**
+         * Maximum keypoint difference allowed between the replayed and recorded keypoints before a frame is reported
+         * as different. Negative values disable the keypoint checking.
+         */
+        float replayTolerance;
+
         /**
          * Constructor of the struct.
          * It has the recommended and default values we recommend for each element of the struct.
@@ -59,7 +73,8 @@ namespace op
         WrapperStructInput(const std::shared_ptr<Producer> producerSharedPtr = nullptr,
                            const unsigned long long frameFirst = 0, const unsigned long long frameLast = -1,
                            const bool realTimeProcessing = false, const bool frameFlip = false,
-                           const int frameRotate = 0, const bool framesRepeat = false);
+                           const int frameRotate = 0, const bool framesRepeat = false,
+                           const std::string& replayRecording = "", const float replayTolerance = 1.f);
     };
 }
 
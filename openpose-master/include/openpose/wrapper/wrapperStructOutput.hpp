@@ -88,6 +88,13 @@ namespace op
          */
         std::string writeHeatMapsFormat;
 
+        /**
+         * Datum recording file path (input frames, scales, keypoints and, if WrapperStructPose.heatMapTypes is not
+         * empty, heat maps), which can be replayed with WrapperStructInput::replayRecording.
+         * If it is empty (default), it is disabled.
+         */
+        std::string writeRecording;
+
         /**
          * Constructor of the struct.
          * It has the recommended and default values we recommend for each element of the struct.
@@ -96,7 +103,8 @@ namespace op
         WrapperStructOutput(const bool displayGui = false, const bool guiVerbose = false, const bool fullScreen = false, const std::string& writeKeypoint = "",
                             const DataFormat writeKeypointFormat = DataFormat::Xml, const std::string& writeKeypointJson = "", const std::string& writeCocoJson = "",
                             const std::string& writeImages = "", const std::string& writeImagesFormat = "", const std::string& writeVideo = "",
-                            const std::string& writeHeatMaps = "", const std::string& writeHeatMapsFormat = "");
+                            const std::string& writeHeatMaps = "", const std::string& writeHeatMapsFormat = "",
+                            const std::string& writeRecording = "");
     };
 }
 
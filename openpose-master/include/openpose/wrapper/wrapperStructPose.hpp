@@ -155,6 +155,140 @@ namespace op
          */
         bool identification;
 
+        /**
+         * Number of threads of the Caffe CPU layers (im2col, ReLU, pooling, concat, etc.) of each pose worker.
+         * The gpuNumber pose workers run in parallel, so -1 splits all the logical cores equally between them (e.g.,
+         * with one worker per CPU socket, each worker uses all the cores of its socket). 0 keeps the OpenMP default
+         * (OMP_NUM_THREADS or all the cores for each worker).
+         */
+        int intraOpThreads;
+
+        /**
+         * Whether to load the INT8-calibrated weights (`*_int8.caffemodel` next to the float ones, generated with
+         * examples/tests/int8Calibration.cpp) instead of the float ones.
+         * The CPU version then adds the int8 arithmetic (AVX-512 VNNI, AVX-VNNI or AVX2, detected at run time) to the
+         * engines timed by each calibrated convolution, which uses it if it is the fastest one and its output is close
+         * enough to the float one. The GPU version keeps float arithmetic (with the quantized weights).
+         * It is an error if the `_int8` model does not exist.
+         */
+        bool int8Inference;
+
+        /**
+         * Early exit of the pose network: number of refinement stages to run (e.g., 1 to 6 for COCO_18 and MPI_15, 1
+         * to 4 for MPI_15_4). 0 (or the total number of stages) runs the whole network.
+         * The heat maps and PAFs of that stage are used instead of the final ones, trading some accuracy for speed.
+         */
+        int earlyExitStage;
+
+        /**
+         * Only if earlyExitStage > 0. If > 0, the early exit is adaptive: when the mean over the body parts of the
+         * heat map peaks at stage earlyExitStage is below this threshold (i.e., uncertain frame), the remaining stages
+         * are run for that frame. 0 always exits at earlyExitStage.
+         */
+        float earlyExitThreshold;
+
+        /**
+         * CPU version: maximum number of independent network layers (e.g., the PAF and heat map branches of each
+         * refinement stage) run at the same time by each pose worker, splitting its intraOpThreads between them.
+         * It reduces the latency of a single frame on many-core CPUs. 1 runs the layers sequentially.
+         */
+        int interOpThreads;
+
+        /**
+         * Per-layer profiling of all the Caffe networks (body pose, hand and face). If > 0, each network logs every
+         * profileLayersFrames frames a table with the time (average and maximum per frame), percentage of the
+         * total time and output memory of each layer, sorted by time. It runs the layers sequentially and
+         * synchronizes the GPU after each layer, so it slows down the processing. 0 disables it.
+         */
+        unsigned long long profileLayersFrames;
+
+        /**
+         * Only if profileLayersFrames > 0. If not empty, each profiling report is also saved as a JSON file in this
+         * folder (one file per network, input size and instance).
+         */
+        std::string profileLayersFolder;
+
+        /**
+         * Keyframe mode: if > 1, the pose network is run at least once every keyframeInterval frames, and the
+         * keypoints of the frames in between are propagated with Lucas-Kanade optical flow, with their score
+         * reduced (see PoseKeypointPropagator). Heat maps are only available for the keyframes. 1 runs the network
+         * on every frame. Only with a single GPU/CPU pose worker (gpuNumber = 1).
+         */
+        int keyframeInterval;
+
+        /**
+         * Only if keyframeInterval > 1. If > 0, the network also runs when the mean absolute difference ([0, 255])
+         * between the frame and the last keyframe is higher than this threshold.
+         */
+        float keyframeMotionThreshold;
+
+        /**
+         * Only if keyframeInterval > 1. The network also runs when the optical flow tracks less than this ratio of
+         * the keyframe keypoints.
+         */
+        float keyframeMinTrackedRatio;
+
+        /**
+         * ROI-cropped inference: if > 0, the pose network is fed with a padded ROI around the people of the last
+         * frames instead of the full frame (higher effective resolution on the people), and the full frame is
+         * processed at least once every roiFullFrameInterval frames or when people are lost (see InputRoiTracker).
+         * The heat maps cover the ROI. 0 always uses the full frame.
+         */
+        int roiFullFrameInterval;
+
+        /**
+         * Only if roiFullFrameInterval > 0. Padding added to each side of the people bounding box, relative to its
+         * size.
+         */
+        float roiPadding;
+
+        /**
+         * Adaptive net resolution: if > 0, the net input height is stepped (multiples of 16, from netInputSize
+         * down to netResolutionMinHeight) so the pose network latency per frame stays around this target (in
+         * milliseconds), with hysteresis (see NetResolutionController). The resolution used for each frame is
+         * recorded in Datum::netInputResolution. netInputSize.y must be > 0. 0 keeps netInputSize fixed.
+         */
+        double netResolutionTargetMs;
+
+        /**
+         * Only if netResolutionTargetMs > 0. Minimum net input height (multiple of 16).
+         */
+        int netResolutionMinHeight;
+
+        /**
+         * Motion gating: if > 0, the frames whose mean absolute difference ([0, 255]) with the last processed frame
+         * (both downsampled and in gray) is lower or equal than this threshold skip the pose network and reuse the
+         * keypoints of the previous frame (see MotionGate and Datum::poseReused). Only with a single GPU/CPU pose
+         * worker (gpuNumber = 1). 0 processes every frame.
+         */
+        float motionGateThreshold;
+
+        /**
+         * Only if motionGateThreshold > 0. Maximum number of consecutive frames reusing the keypoints.
+         */
+        int motionGateMaxReusedFrames;
+
+        /**
+         * Local peak search: if > 0, the peaks are only searched around the people of the previous frame (and the
+         * PAFs only scored between joints of the same person), with a whole heat map search every
+         * localPeakSearchInterval frames or whenever a person is lost. Only with a single GPU/CPU pose worker
+         * (gpuNumber = 1) and without ROI-cropped inference. 0 searches the whole heat maps in every frame.
+         */
+        int localPeakSearchInterval;
+
+        /**
+         * Tiled inference: if > 0 (multiple of 16), the net inputs larger than tileSize x tileSize (e.g., 4K frames
+         * at a high netInputSize) are processed by overlapping tiles, so the net memory only depends on tileSize.
+         * 0 processes the whole net input at once.
+         */
+        int tileSize;
+
+        /**
+         * Only if tileSize > 0. Overlap between consecutive tiles (multiple of 16), in net input pixels. It should
+         * cover the people parts cut by a tile border.
+         */
+        int tileOverlap;
+
         /**
          * Constructor of the struct.
          * It has the recommended and default values we recommend for each element of the struct.
@@ -172,7 +306,17 @@ namespace op
                           const std::vector<HeatMapType>& heatMapTypes = {},
                           const ScaleMode heatMapScale = ScaleMode::ZeroToOne,
                           const float renderThreshold = 0.05f, const bool enableGoogleLogging = true,
-                          const bool identification = false);
+                          const bool identification = false, const int intraOpThreads = -1,
+                          const bool int8Inference = false, const int earlyExitStage = 0,
+                          const float earlyExitThreshold = 0.f, const int interOpThreads = 1,
+                          const unsigned long long profileLayersFrames = 0ull,
+                          const std::string& profileLayersFolder = "", const int keyframeInterval = 1,
+                          const float keyframeMotionThreshold = 0.f, const float keyframeMinTrackedRatio = 0.5f,
+                          const int roiFullFrameInterval = 0, const float roiPadding = 0.3f,
+                          const double netResolutionTargetMs = 0., const int netResolutionMinHeight = 160,
+                          const float motionGateThreshold = 0.f, const int motionGateMaxReusedFrames = 30,
+                          const int localPeakSearchInterval = 0, const int tileSize = 0,
+                          const int tileOverlap = 64);
     };
 }
 
@@ -6,7 +6,8 @@ namespace op
 {
     std::vector<Array<float>> CvMatToOpInput::createArray(const cv::Mat& cvInputData,
                                                           const std::vector<double>& scaleInputToNetInputs,
-                                                          const std::vector<Point<int>>& netInputSizes) const
+                                                          const std::vector<Point<int>>& netInputSizes,
+                                                          const Rectangle<int>& netInputRoi) const
     {
         try
         {
@@ -17,6 +18,10 @@ namespace op
                 error("Input images must be 3-channel BGR.", __LINE__, __FUNCTION__, __FILE__);
             if (scaleInputToNetInputs.size() != netInputSizes.size())
                 error("scaleInputToNetInputs.size() != netInputSizes.size().", __LINE__, __FUNCTION__, __FILE__);
+            // ROI-cropped inference (no copy)
+            const auto cvInputRoi = (netInputRoi.area() > 0
+                ? cvInputData(cv::Rect{netInputRoi.x, netInputRoi.y, netInputRoi.width, netInputRoi.height})
+                : cvInputData);
             // inputNetData - Reescale keeping aspect ratio and transform to float the input deep net image
             const auto numberScales = (int)scaleInputToNetInputs.size();
             std::vector<Array<float>> inputNetData(numberScales);
@@ -24,7 +29,7 @@ namespace op
             {
                 inputNetData[i].reset({1, 3, netInputSizes.at(i).y, netInputSizes.at(i).x});
                 std::vector<double> scaleRatios(numberScales, 1.f);
-                const cv::Mat frameWithNetSize = resizeFixedAspectRatio(cvInputData, scaleInputToNetInputs[i],
+                const cv::Mat frameWithNetSize = resizeFixedAspectRatio(cvInputRoi, scaleInputToNetInputs[i],
                                                                         netInputSizes[i]);
                 // Fill inputNetData[i]
                 uCharCvMatToFloatPtr(inputNetData[i].getPtr(), frameWithNetSize, true);
@@ -5,7 +5,8 @@ namespace op
 {
     Datum::Datum() :
         id{std::numeric_limits<unsigned long long>::max()},
-        poseIds{-1}
+        poseIds{-1},
+        poseReused{false}
     {
     }
 
@@ -31,6 +32,9 @@ namespace op
         // Other parameters
         scaleInputToNetInputs{datum.scaleInputToNetInputs},
         netInputSizes{datum.netInputSizes},
+        netInputResolution{datum.netInputResolution},
+        netInputRoi{datum.netInputRoi},
+        poseReused{datum.poseReused},
         scaleInputToOutput{datum.scaleInputToOutput},
         scaleNetToOutput{datum.scaleNetToOutput},
         elementRendered{datum.elementRendered}
@@ -62,6 +66,9 @@ namespace op
             // Other parameters
             scaleInputToNetInputs = datum.scaleInputToNetInputs;
             netInputSizes = datum.netInputSizes;
+            netInputResolution = datum.netInputResolution;
+            netInputRoi = datum.netInputRoi;
+            poseReused = datum.poseReused;
             scaleInputToOutput = datum.scaleInputToOutput;
             scaleNetToOutput = datum.scaleNetToOutput;
             elementRendered = datum.elementRendered;
@@ -80,6 +87,7 @@ namespace op
         // ID
         id{datum.id},
         // Other parameters
+        poseReused{datum.poseReused},
         scaleInputToOutput{datum.scaleInputToOutput},
         scaleNetToOutput{datum.scaleNetToOutput}
     {
@@ -104,6 +112,8 @@ namespace op
             // Other parameters
             std::swap(scaleInputToNetInputs, datum.scaleInputToNetInputs);
             std::swap(netInputSizes, datum.netInputSizes);
+            std::swap(netInputResolution, datum.netInputResolution);
+            std::swap(netInputRoi, datum.netInputRoi);
             std::swap(elementRendered, datum.elementRendered);
         }
         catch (const std::exception& e)
@@ -137,6 +147,9 @@ namespace op
             // Other parameters
             std::swap(scaleInputToNetInputs, datum.scaleInputToNetInputs);
             std::swap(netInputSizes, datum.netInputSizes);
+            std::swap(netInputResolution, datum.netInputResolution);
+            std::swap(netInputRoi, datum.netInputRoi);
+            std::swap(poseReused, datum.poseReused);
             std::swap(elementRendered, datum.elementRendered);
             // Return
             return *this;
@@ -181,6 +194,9 @@ namespace op
             // Other parameters
             datum.scaleInputToNetInputs = scaleInputToNetInputs;
             datum.netInputSizes = netInputSizes;
+            datum.netInputResolution = netInputResolution;
+            datum.netInputRoi = netInputRoi;
+            datum.poseReused = poseReused;
             datum.scaleInputToOutput = scaleInputToOutput;
             datum.scaleNetToOutput = scaleNetToOutput;
             datum.elementRendered = elementRendered;
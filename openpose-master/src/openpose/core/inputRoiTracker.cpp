@@ -0,0 +1,109 @@
+#include <openpose/utilities/fastMath.hpp>
+#include <openpose/utilities/keypoint.hpp>
+#include <openpose/core/inputRoiTracker.hpp>
+
+namespace op
+{
+    // Minimum ROI size relative to the frame, so the people are not upsampled too much
+    const auto MIN_ROI_SIZE_RATIO = 0.25f;
+
+    InputRoiTracker::InputRoiTracker(const int fullFrameInterval, const float padding, const float maxRoiAreaRatio,
+                                     const float keypointThreshold) :
+        mFullFrameInterval{fullFrameInterval},
+        mPadding{padding},
+        mMaxRoiAreaRatio{maxRoiAreaRatio},
+        mKeypointThreshold{keypointThreshold},
+        mFramesSinceFullFrame{0},
+        mNumberPeople{0}
+    {
+        try
+        {
+            if (mFullFrameInterval < 1)
+                error("The full frame interval must be >= 1.", __LINE__, __FUNCTION__, __FILE__);
+            if (mPadding < 0.f)
+                error("The ROI padding must be >= 0.", __LINE__, __FUNCTION__, __FILE__);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    Rectangle<int> InputRoiTracker::getRoi(const Point<int>& inputSize)
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock{mMutex};
+            // Full frame: no people tracked or re-detection
+            mFramesSinceFullFrame++;
+            if (mPeopleRectangle.area() <= 0.f || mFramesSinceFullFrame >= mFullFrameInterval)
+            {
+                mFramesSinceFullFrame = 0;
+                return Rectangle<int>{};
+            }
+            // Padded people bounding box, with a minimum size
+            const auto width = fastMax(mPeopleRectangle.width * (1.f + 2.f*mPadding),
+                                       MIN_ROI_SIZE_RATIO * inputSize.x);
+            const auto height = fastMax(mPeopleRectangle.height * (1.f + 2.f*mPadding),
+                                        MIN_ROI_SIZE_RATIO * inputSize.y);
+            const auto center = mPeopleRectangle.center();
+            const auto xMin = fastTruncate(intRound(center.x - width / 2.f), 0, inputSize.x);
+            const auto yMin = fastTruncate(intRound(center.y - height / 2.f), 0, inputSize.y);
+            const auto xMax = fastTruncate(intRound(center.x + width / 2.f), 0, inputSize.x);
+            const auto yMax = fastTruncate(intRound(center.y + height / 2.f), 0, inputSize.y);
+            const Rectangle<int> roi{xMin, yMin, xMax - xMin, yMax - yMin};
+            // Full frame if the ROI would not save much
+            if (roi.width <= 0 || roi.height <= 0 || roi.area() > mMaxRoiAreaRatio * inputSize.area())
+                return Rectangle<int>{};
+            return roi;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return Rectangle<int>{};
+        }
+    }
+
+    void InputRoiTracker::update(const Array<float>& poseKeypoints, const Rectangle<int>& roi)
+    {
+        try
+        {
+            // Bounding box of all the people
+            const auto numberPeople = poseKeypoints.getSize(0);
+            auto xMin = 0.f;
+            auto yMin = 0.f;
+            auto xMax = 0.f;
+            auto yMax = 0.f;
+            auto numberFound = 0;
+            for (auto person = 0 ; person < numberPeople ; person++)
+            {
+                const auto personRectangle = getKeypointsRectangle(poseKeypoints, person, mKeypointThreshold);
+                if (personRectangle.area() > 0.f)
+                {
+                    const auto personBottomRight = personRectangle.bottomRight();
+                    xMin = (numberFound == 0 ? personRectangle.x : fastMin(xMin, personRectangle.x));
+                    yMin = (numberFound == 0 ? personRectangle.y : fastMin(yMin, personRectangle.y));
+                    xMax = (numberFound == 0 ? personBottomRight.x : fastMax(xMax, personBottomRight.x));
+                    yMax = (numberFound == 0 ? personBottomRight.y : fastMax(yMax, personBottomRight.y));
+                    numberFound++;
+                }
+            }
+            std::lock_guard<std::mutex> lock{mMutex};
+            // Track loss inside the ROI: full frame in the next frame
+            if (numberFound == 0 || (roi.area() > 0 && numberFound < mNumberPeople))
+            {
+                mPeopleRectangle = Rectangle<float>{};
+                mNumberPeople = 0;
+            }
+            else
+            {
+                mPeopleRectangle = Rectangle<float>{xMin, yMin, xMax - xMin, yMax - yMin};
+                mNumberPeople = numberFound;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+}
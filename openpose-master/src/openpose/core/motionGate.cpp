@@ -0,0 +1,59 @@
+#include <opencv2/imgproc/imgproc.hpp> // cv::COLOR_BGR2GRAY, cv::cvtColor, cv::resize
+#include <openpose/utilities/fastMath.hpp>
+#include <openpose/core/motionGate.hpp>
+
+namespace op
+{
+    MotionGate::MotionGate(const float motionThreshold, const int maxReusedFrames, const int thumbnailWidth) :
+        mMotionThreshold{motionThreshold},
+        mMaxReusedFrames{maxReusedFrames},
+        mThumbnailWidth{thumbnailWidth},
+        mReusedFrames{0}
+    {
+        try
+        {
+            if (mMotionThreshold < 0.f)
+                error("The motion threshold must be >= 0.", __LINE__, __FUNCTION__, __FILE__);
+            if (mMaxReusedFrames < 0)
+                error("The maximum number of reused frames must be >= 0.", __LINE__, __FUNCTION__, __FILE__);
+            if (mThumbnailWidth < 1)
+                error("The thumbnail width must be >= 1.", __LINE__, __FUNCTION__, __FILE__);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    bool MotionGate::isStatic(const cv::Mat& cvInputData)
+    {
+        try
+        {
+            // Security checks
+            if (cvInputData.empty() || cvInputData.channels() != 3)
+                error("Input images must be 3-channel BGR.", __LINE__, __FUNCTION__, __FILE__);
+            // Downsampled gray frame (downsampled first, so the color conversion is negligible)
+            const cv::Size thumbnailSize{mThumbnailWidth, fastMax(1, intRound(mThumbnailWidth * cvInputData.rows
+                                                                              / (float)cvInputData.cols))};
+            cv::resize(cvInputData, mThumbnail, thumbnailSize, 0, 0, cv::INTER_AREA);
+            cv::cvtColor(mThumbnail, mThumbnail, cv::COLOR_BGR2GRAY);
+            // Static: similar to the last processed frame and not reused for too long
+            if (mReusedFrames < mMaxReusedFrames && mThumbnail.size() == mProcessedThumbnail.size()
+                && cv::norm(mThumbnail, mProcessedThumbnail, cv::NORM_L1) / (double)mThumbnail.total()
+                    <= mMotionThreshold)
+            {
+                mReusedFrames++;
+                return true;
+            }
+            // Processed frame
+            std::swap(mThumbnail, mProcessedThumbnail);
+            mReusedFrames = 0;
+            return false;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+}
@@ -1,12 +1,28 @@
 #include <numeric> // std::accumulate
 #ifdef USE_CAFFE
+    #include <algorithm> // std::find, std::sort
     #include <atomic>
+    #include <chrono>
+    #include <cstring> // std::memcmp
+    #include <fstream> // std::ifstream, std::ofstream
+    #include <iomanip> // std::setprecision
+    #include <list>
+    #include <map>
     #include <mutex>
+    #include <sstream> // std::ostringstream
     #include <caffe/net.hpp>
+    #include <caffe/syncedmem.hpp>
+    #include <caffe/layers/concat_layer.hpp>
+    #include <caffe/layers/conv_layer.hpp>
+    #include <caffe/util/layer_scheduler.hpp>
+    #include <caffe/util/math_functions.hpp> // caffe::caffe_copy
+    #include <caffe/util/upgrade_proto.hpp> // caffe::ReadNetParamsFromBinaryFileOrDie
     #include <glog/logging.h> // google::InitGoogleLogging
 #endif
 #include <openpose/utilities/cuda.hpp>
+#include <openpose/utilities/fastMath.hpp>
 #include <openpose/utilities/fileSystem.hpp>
+#include <openpose/utilities/memoryMappedFile.hpp>
 #include <openpose/utilities/standard.hpp>
 #include <openpose/core/netCaffe.hpp>
 
@@ -14,6 +30,39 @@ namespace op
 {
     std::mutex sMutexNetCaffe;
     std::atomic<bool> sGoogleLoggingInitialized{false};
+    // Layer profiling (NetCaffe::setLayerProfiling), sLayerProfilingFolder guarded by sMutexNetCaffe
+    std::atomic<unsigned long long> sLayerProfilingFrames{0ull};
+    std::string sLayerProfilingFolder;
+    std::atomic<unsigned long long> sNetCaffeCounter{0ull};
+
+    #ifdef USE_CAFFE
+        // Memory plan of an input size: arena offset of each planned blob
+        struct BlobMemoryPlan
+        {
+            std::vector<std::pair<int, unsigned long long>> blobOffsets;
+            unsigned long long arenaBytes;
+        };
+
+        // Flat weights written beside the trained model by convert_caffemodel_to_flat: same path with the `.flat`
+        // extension instead of `.caffemodel` (e.g., pose_iter_440000.caffemodel -> pose_iter_440000.flat)
+        std::string getFlatTrainedModel(const std::string& caffeTrainedModel)
+        {
+            try
+            {
+                const std::string extension{".caffemodel"};
+                if (caffeTrainedModel.size() <= extension.size()
+                    || caffeTrainedModel.compare(caffeTrainedModel.size() - extension.size(), extension.size(),
+                                                 extension) != 0)
+                    return "";
+                return caffeTrainedModel.substr(0, caffeTrainedModel.size() - extension.size()) + ".flat";
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return "";
+            }
+        }
+    #endif
 
     struct NetCaffe::ImplNetCaffe
     {
@@ -23,24 +72,56 @@ namespace op
             const std::string mCaffeProto;
             const std::string mCaffeTrainedModel;
             const std::string mLastBlobName;
+            const bool mPlanMemory;
+            int mIntraOpThreads;
+            const std::vector<std::string> mEarlyExitBlobNames;
+            const int mInterOpThreads;
+            const unsigned long long mInstanceId;
             std::vector<int> mNetInputSize4D;
             // Init with thread
             std::unique_ptr<caffe::Net<float>> upCaffeNet;
+            std::shared_ptr<caffe::Net<float>> spWeightsNet;
+            std::unique_ptr<caffe::LayerScheduler<float>> upLayerScheduler;
+            boost::shared_ptr<caffe::Blob<float>> spLastBlob;
+            // spLastBlob, or its own blob with early exit
             boost::shared_ptr<caffe::Blob<float>> spOutputBlob;
+            std::unique_ptr<caffe::SyncedMemory> upBlobArena;
+            // Memory plans of the last input sizes (most recently used first)
+            std::list<std::pair<std::vector<int>, BlobMemoryPlan>> mBlobMemoryPlans;
+            bool mMemoryReported;
+            // Early exit
+            std::vector<caffe::Blob<float>*> mEarlyExitBlobs;
+            int mEarlyExitLayer;
+            bool mForwardPassStopped;
+            // Layer profiling
+            std::vector<LayerStatistics> mLayerStatistics;
+            unsigned long long mProfiledFrames;
 
             ImplNetCaffe(const std::string& caffeProto, const std::string& caffeTrainedModel, const int gpuId,
-                         const bool enableGoogleLogging, const std::string& lastBlobName) :
+                         const bool enableGoogleLogging, const std::string& lastBlobName, const bool planMemory,
+                         const int intraOpThreads, const std::vector<std::string>& earlyExitBlobNames,
+                         const int interOpThreads) :
                 mGpuId{gpuId},
                 mCaffeProto{caffeProto},
                 mCaffeTrainedModel{caffeTrainedModel},
-                mLastBlobName{lastBlobName}
+                mLastBlobName{lastBlobName},
+                mPlanMemory{planMemory},
+                mIntraOpThreads{intraOpThreads},
+                mEarlyExitBlobNames(earlyExitBlobNames),
+                mInterOpThreads{interOpThreads},
+                mInstanceId{sNetCaffeCounter++},
+                mMemoryReported{false},
+                mEarlyExitLayer{-1},
+                mForwardPassStopped{false},
+                mProfiledFrames{0ull}
             {
                 const std::string message{".\nPossible causes:\n\t1. Not downloading the OpenPose trained models."
                                           "\n\t2. Not running OpenPose from the same directory where the `model`"
                                           " folder is located.\n\t3. Using paths with spaces."};
                 if (!existFile(mCaffeProto))
                     error("Prototxt file not found: " + mCaffeProto + message, __LINE__, __FUNCTION__, __FILE__);
-                if (!existFile(mCaffeTrainedModel))
+                const auto flatTrainedModel = getFlatTrainedModel(mCaffeTrainedModel);
+                if (!existFile(mCaffeTrainedModel) && (flatTrainedModel.empty() || !existFile(flatTrainedModel)))
                     error("Caffe trained model file not found: " + mCaffeTrainedModel + message,
                           __LINE__, __FUNCTION__, __FILE__);
                 // Double if condition in order to speed up the program if it is called several times
@@ -58,6 +139,427 @@ namespace op
     };
 
     #ifdef USE_CAFFE
+        // Process-wide registry of trained weights: one read-only net per (prototxt, model, GPU) owns the parameter
+        // blobs, which every NetCaffe instance shares (Net::ShareTrainedLayersWith) while keeping its own activations
+        std::mutex sMutexWeightsRegistry;
+        std::map<std::string, std::weak_ptr<caffe::Net<float>>> sWeightsRegistry;
+
+        // Flat weights (3rdparty/caffe/tools/convert_caffemodel_to_flat.cpp): 32-byte header (magic "CAFFEFLT",
+        // uint32 version, uint32 #blobs, uint64 table offset, uint64 data offset), one table entry per blob (uint64
+        // layer name length, blob index, #axes, axes, data offset and count, then the name padded to 8 bytes) and
+        // the float data of each blob 64-byte aligned, so the parameter blobs can point directly into the mapping
+        const char FLAT_WEIGHTS_MAGIC[8] = {'C', 'A', 'F', 'F', 'E', 'F', 'L', 'T'};
+        const unsigned int FLAT_WEIGHTS_VERSION = 1u;
+
+        bool isFlatTrainedModel(const std::string& caffeTrainedModel)
+        {
+            try
+            {
+                char magic[sizeof(FLAT_WEIGHTS_MAGIC)];
+                std::ifstream ifstream{caffeTrainedModel, std::ios::binary};
+                return ifstream.read(magic, sizeof(magic))
+                    && std::memcmp(magic, FLAT_WEIGHTS_MAGIC, sizeof(FLAT_WEIGHTS_MAGIC)) == 0;
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return false;
+            }
+        }
+
+        void shareFlatTrainedLayers(caffe::Net<float>& caffeNet, MemoryMappedFile& memoryMappedFile,
+                                    const std::string& caffeTrainedModel)
+        {
+            try
+            {
+                const auto fileSize = memoryMappedFile.getSize();
+                auto* const dataPtr = memoryMappedFile.getPtr();
+                const auto readUint64 = [&](unsigned long long& offset)
+                {
+                    if (offset + sizeof(unsigned long long) > fileSize)
+                        error("Truncated flat weights file: " + caffeTrainedModel, __LINE__, __FUNCTION__, __FILE__);
+                    const auto value = *(const unsigned long long*)(dataPtr + offset);
+                    offset += sizeof(unsigned long long);
+                    return value;
+                };
+                // Header
+                if (fileSize < 32ull)
+                    error("Truncated flat weights file: " + caffeTrainedModel, __LINE__, __FUNCTION__, __FILE__);
+                const auto* const versionAndSize = (const unsigned int*)(dataPtr + sizeof(FLAT_WEIGHTS_MAGIC));
+                if (versionAndSize[0] != FLAT_WEIGHTS_VERSION)
+                    error("Unsupported flat weights version: " + std::to_string(versionAndSize[0]),
+                          __LINE__, __FUNCTION__, __FILE__);
+                auto offset = 16ull;
+                const auto tableOffset = readUint64(offset);
+                offset = tableOffset;
+                // Table
+                for (auto entry = 0u ; entry < versionAndSize[1] ; entry++)
+                {
+                    const auto nameLength = readUint64(offset);
+                    const auto blobIndex = readUint64(offset);
+                    std::vector<int> shape(readUint64(offset));
+                    for (auto& dimension : shape)
+                        dimension = (int)readUint64(offset);
+                    const auto dataOffset = readUint64(offset);
+                    const auto count = readUint64(offset);
+                    if (offset + nameLength > fileSize || dataOffset + count * sizeof(float) > fileSize
+                        || dataOffset % sizeof(float) != 0)
+                        error("Corrupted flat weights file: " + caffeTrainedModel, __LINE__, __FUNCTION__, __FILE__);
+                    const std::string layerName{dataPtr + offset, nameLength};
+                    offset += (nameLength + 7) / 8 * 8;
+                    // Same behavior than Net::CopyTrainedLayersFrom: layers not in the prototxt are ignored
+                    if (!caffeNet.has_layer(layerName))
+                        continue;
+                    auto& layerBlobs = caffeNet.layer_by_name(layerName)->blobs();
+                    if (blobIndex >= layerBlobs.size() || layerBlobs[blobIndex]->shape() != shape
+                        || (unsigned long long)layerBlobs[blobIndex]->count() != count)
+                        error("Trained weights of layer " + layerName + " do not match the prototxt.",
+                              __LINE__, __FUNCTION__, __FILE__);
+                    // Zero-copy: the blob points into the (copy-on-write) mapping
+                    if (count > 0ull)
+                        layerBlobs[blobIndex]->set_cpu_data((float*)(dataPtr + dataOffset));
+                }
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        // INT8 calibration (examples/tests/int8Calibration.cpp): the calibrated weights file also stores the
+        // quantization scales of each convolution, which the prototxt-built layers do not have
+        void copyInt8Scales(caffe::Net<float>& caffeNet, const caffe::NetParameter& trainedNetParameter)
+        {
+            try
+            {
+                auto numberInt8Layers = 0;
+                for (const auto& layerParameter : trainedNetParameter.layer())
+                {
+                    const auto& convolutionParameter = layerParameter.convolution_param();
+                    if (convolutionParameter.int8_input_scale() <= 0.f || !caffeNet.has_layer(layerParameter.name()))
+                        continue;
+                    auto* convolutionLayer = dynamic_cast<caffe::ConvolutionLayer<float>*>(
+                        caffeNet.layer_by_name(layerParameter.name()).get());
+                    if (convolutionLayer == nullptr)
+                        error("INT8 scales given for the non-convolution layer " + layerParameter.name() + ".",
+                              __LINE__, __FUNCTION__, __FILE__);
+                    convolutionLayer->set_int8_scales(
+                        convolutionParameter.int8_input_scale(),
+                        std::vector<float>(convolutionParameter.int8_weight_scale().begin(),
+                                           convolutionParameter.int8_weight_scale().end()));
+                    numberInt8Layers++;
+                }
+                if (numberInt8Layers > 0)
+                    log(std::to_string(numberInt8Layers) + " INT8-calibrated convolutions.",
+                        Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        void shareInt8Scales(caffe::Net<float>& caffeNet, const caffe::Net<float>& weightsNet)
+        {
+            try
+            {
+                for (auto layer = 0u ; layer < weightsNet.layers().size() ; layer++)
+                {
+                    const auto* convolutionLayer = dynamic_cast<const caffe::ConvolutionLayer<float>*>(
+                        weightsNet.layers()[layer].get());
+                    const auto& layerName = weightsNet.layer_names()[layer];
+                    if (convolutionLayer != nullptr && convolutionLayer->int8_input_scale() > 0.f)
+                    {
+                        auto* targetLayer = dynamic_cast<caffe::ConvolutionLayer<float>*>(
+                            caffeNet.layer_by_name(layerName).get());
+                        if (targetLayer != nullptr)
+                            targetLayer->set_int8_scales(convolutionLayer->int8_input_scale(),
+                                                         convolutionLayer->int8_weight_scales());
+                    }
+                }
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        std::shared_ptr<caffe::Net<float>> getSharedWeightsNet(const std::string& caffeProto,
+                                                               const std::string& caffeTrainedModel,
+                                                               const int gpuId)
+        {
+            try
+            {
+                #ifdef USE_CUDA
+                    const auto device = "GPU " + std::to_string(gpuId);
+                #else
+                    UNUSED(gpuId);
+                    const std::string device{"CPU"};
+                #endif
+                const auto key = caffeProto + "|" + caffeTrainedModel + "|" + device;
+                // Lock kept while loading, so concurrent threads wait for the same weights instead of loading them
+                std::lock_guard<std::mutex> lock{sMutexWeightsRegistry};
+                auto spWeightsNet = sWeightsRegistry[key].lock();
+                if (spWeightsNet == nullptr)
+                {
+                    // A flat file beside the caffemodel is preferred over it
+                    const auto flatTrainedModel = getFlatTrainedModel(caffeTrainedModel);
+                    const auto& weightsFile = (!flatTrainedModel.empty() && existFile(flatTrainedModel)
+                                               ? flatTrainedModel : caffeTrainedModel);
+                    if (isFlatTrainedModel(weightsFile))
+                    {
+                        // The mapping is released after the net that points into it
+                        std::shared_ptr<MemoryMappedFile> spMemoryMappedFile{
+                            std::make_shared<MemoryMappedFile>(weightsFile, true)
+                        };
+                        spWeightsNet = std::shared_ptr<caffe::Net<float>>{
+                            new caffe::Net<float>{caffeProto, caffe::TEST},
+                            [spMemoryMappedFile](caffe::Net<float>* caffeNet) { delete caffeNet; }
+                        };
+                        shareFlatTrainedLayers(*spWeightsNet, *spMemoryMappedFile, weightsFile);
+                    }
+                    else if (weightsFile != caffeTrainedModel)
+                        error("Flat weights file without the flat weights header: " + weightsFile + ".",
+                              __LINE__, __FUNCTION__, __FILE__);
+                    else if (getFileExtension(caffeTrainedModel) == ".h5")
+                    {
+                        spWeightsNet = std::make_shared<caffe::Net<float>>(caffeProto, caffe::TEST);
+                        spWeightsNet->CopyTrainedLayersFrom(caffeTrainedModel);
+                    }
+                    else
+                    {
+                        caffe::NetParameter trainedNetParameter;
+                        caffe::ReadNetParamsFromBinaryFileOrDie(caffeTrainedModel, &trainedNetParameter);
+                        spWeightsNet = std::make_shared<caffe::Net<float>>(caffeProto, caffe::TEST);
+                        spWeightsNet->CopyTrainedLayersFrom(trainedNetParameter);
+                        copyInt8Scales(*spWeightsNet, trainedNetParameter);
+                    }
+                    // Move the weights to the device now: afterwards, the shared SyncedMemory heads are only read
+                    // (never transitioned) by the concurrent forward passes
+                    for (const auto& param : spWeightsNet->params())
+                    {
+                        #ifdef USE_CUDA
+                            param->gpu_data();
+                        #else
+                            param->cpu_data();
+                        #endif
+                    }
+                    cudaCheck(__LINE__, __FUNCTION__, __FILE__);
+                    sWeightsRegistry[key] = spWeightsNet;
+                    log("Loaded trained weights " + weightsFile + " (" + device + ").",
+                        Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+                }
+                else
+                    log("Sharing already loaded trained weights " + caffeTrainedModel + " (" + device + ").",
+                        Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+                return spWeightsNet;
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return nullptr;
+            }
+        }
+
+        // Concatenation along the channels (for each image of the batch) of blobs with the same num, height and width
+        void concatenateChannels(caffe::Blob<float>& outputBlob, const std::vector<caffe::Blob<float>*>& blobs)
+        {
+            try
+            {
+                auto shape = blobs.at(0)->shape();
+                shape.at(1) = 0;
+                for (const auto* blob : blobs)
+                {
+                    if (blob->num_axes() != 4 || blob->shape(0) != shape[0] || blob->shape(2) != shape[2]
+                        || blob->shape(3) != shape[3])
+                        error("Blobs with different num, height or width cannot be concatenated.",
+                              __LINE__, __FUNCTION__, __FILE__);
+                    shape[1] += blob->shape(1);
+                }
+                outputBlob.Reshape(shape);
+                #ifdef USE_CUDA
+                    auto* outputPtr = outputBlob.mutable_gpu_data();
+                #else
+                    auto* outputPtr = outputBlob.mutable_cpu_data();
+                #endif
+                for (auto num = 0 ; num < shape[0] ; num++)
+                    for (const auto* blob : blobs)
+                    {
+                        const auto count = blob->count(1);
+                        #ifdef USE_CUDA
+                            caffe::caffe_copy(count, blob->gpu_data() + num * count, outputPtr);
+                        #else
+                            caffe::caffe_copy(count, blob->cpu_data() + num * count, outputPtr);
+                        #endif
+                        outputPtr += count;
+                    }
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        // Forward pass of the layers [start, end]. If layerStatistics is not nullptr, each layer is run and timed
+        // individually
+        inline void forwardFromTo(caffe::Net<float>& caffeNet, caffe::LayerScheduler<float>* const layerScheduler,
+                                  std::vector<LayerStatistics>* const layerStatistics, const int start, const int end)
+        {
+            try
+            {
+                if (layerStatistics != nullptr)
+                {
+                    for (auto layer = start ; layer <= end ; layer++)
+                    {
+                        const auto beginTime = std::chrono::high_resolution_clock::now();
+                        caffeNet.ForwardFromTo(layer, layer);
+                        #ifdef USE_CUDA
+                            cudaDeviceSynchronize();
+                        #endif
+                        const auto layerMs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::high_resolution_clock::now() - beginTime
+                        ).count() * 1e-6;
+                        auto& layerStatistic = layerStatistics->at(layer);
+                        layerStatistic.calls++;
+                        layerStatistic.totalMs += layerMs;
+                        layerStatistic.maxMs = fastMax(layerStatistic.maxMs, layerMs);
+                        const auto& topBlobs = caffeNet.top_vecs()[layer];
+                        layerStatistic.outputBytes = 0ull;
+                        for (const auto* topBlob : topBlobs)
+                            layerStatistic.outputBytes += topBlob->count() * sizeof(float);
+                        layerStatistic.outputShape = (topBlobs.empty() ? std::vector<int>{} : topBlobs[0]->shape());
+                    }
+                }
+                else if (layerScheduler != nullptr)
+                    layerScheduler->ForwardFromTo(start, end);
+                else
+                    caffeNet.ForwardFromTo(start, end);
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        std::vector<LayerStatistics> getEmptyLayerStatistics(const caffe::Net<float>& caffeNet)
+        {
+            try
+            {
+                std::vector<LayerStatistics> layerStatistics(caffeNet.layers().size());
+                for (auto layer = 0u ; layer < layerStatistics.size() ; layer++)
+                    layerStatistics[layer] = LayerStatistics{caffeNet.layer_names()[layer],
+                                                             caffeNet.layers()[layer]->type(), 0ull, 0., 0., 0ull, {}};
+                return layerStatistics;
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return {};
+            }
+        }
+
+        std::string toFixed(const double value, const int decimals)
+        {
+            std::ostringstream ostringstream;
+            ostringstream << std::fixed << std::setprecision(decimals) << value;
+            return ostringstream.str();
+        }
+
+        std::string shapeToString(const std::vector<int>& shape)
+        {
+            std::string shapeString;
+            for (auto i = 0u ; i < shape.size() ; i++)
+                shapeString += (i > 0 ? "x" : "") + std::to_string(shape[i]);
+            return shapeString;
+        }
+
+        // Table of the layers sorted by time (logged), also written as JSON into reportFolder if not empty
+        void reportLayerStatistics(std::vector<LayerStatistics> layerStatistics, const unsigned long long numberFrames,
+                                   const std::string& netName, const std::vector<int>& netInputSize,
+                                   const std::string& reportFolder, const unsigned long long instanceId)
+        {
+            try
+            {
+                std::stable_sort(layerStatistics.begin(), layerStatistics.end(),
+                                 [](const LayerStatistics& a, const LayerStatistics& b)
+                                 { return a.totalMs > b.totalMs; });
+                auto totalMs = 0.;
+                auto totalOutputBytes = 0ull;
+                for (const auto& layerStatistic : layerStatistics)
+                {
+                    totalMs += layerStatistic.totalMs;
+                    totalOutputBytes += layerStatistic.outputBytes;
+                }
+                const auto mb = 1. / (1024. * 1024.);
+                const auto frameMs = totalMs / numberFrames;
+                const auto percentage = [&](const LayerStatistics& layerStatistic)
+                {
+                    return (totalMs > 0. ? 100. * layerStatistic.totalMs / totalMs : 0.);
+                };
+                const auto pad = [](std::string text, const std::size_t width)
+                {
+                    text.resize(fastMax(width, text.size()), ' ');
+                    return text;
+                };
+                // Logged table
+                std::string message = "Layer profile of " + netName + " (input " + shapeToString(netInputSize) + ", "
+                                    + std::to_string(numberFrames) + " frames): " + toFixed(frameMs, 3)
+                                    + " ms/frame, " + toFixed(totalOutputBytes * mb, 1) + " MB of layer outputs"
+                                    + "\n    " + pad("Layer", 28) + pad("Type", 14) + pad("ms/frame", 11)
+                                    + pad("%", 8) + pad("Max ms", 11) + pad("Calls", 8) + pad("Output MB", 11)
+                                    + "Output shape";
+                for (const auto& layerStatistic : layerStatistics)
+                    message += "\n    " + pad(layerStatistic.name, 28) + pad(layerStatistic.type, 14)
+                             + pad(toFixed(layerStatistic.totalMs / numberFrames, 3), 11)
+                             + pad(toFixed(percentage(layerStatistic), 2), 8)
+                             + pad(toFixed(layerStatistic.maxMs, 3), 11) + pad(std::to_string(layerStatistic.calls), 8)
+                             + pad(toFixed(layerStatistic.outputBytes * mb, 2), 11)
+                             + shapeToString(layerStatistic.outputShape);
+                log(message, Priority::High);
+                // JSON
+                if (!reportFolder.empty())
+                {
+                    if (!existDir(reportFolder))
+                        mkdir(reportFolder);
+                    const auto jsonPath = formatAsDirectory(reportFolder) + netName + "_" + shapeToString(netInputSize)
+                                        + "_" + std::to_string(instanceId) + "_layers.json";
+                    std::ofstream jsonOfstream{jsonPath};
+                    if (!jsonOfstream.is_open())
+                        error("Layer profile file could not be opened: " + jsonPath + ".",
+                              __LINE__, __FUNCTION__, __FILE__);
+                    const auto jsonArray = [](const std::vector<int>& values)
+                    {
+                        std::string array{"["};
+                        for (auto i = 0u ; i < values.size() ; i++)
+                            array += (i > 0 ? ", " : "") + std::to_string(values[i]);
+                        return array + "]";
+                    };
+                    jsonOfstream << "{\n\t\"net\": \"" << netName << "\",\n\t\"input_shape\": "
+                                 << jsonArray(netInputSize) << ",\n\t\"frames\": " << numberFrames
+                                 << ",\n\t\"ms_per_frame\": " << toFixed(frameMs, 4)
+                                 << ",\n\t\"output_bytes\": " << totalOutputBytes << ",\n\t\"layers\": [";
+                    for (auto i = 0u ; i < layerStatistics.size() ; i++)
+                    {
+                        const auto& layerStatistic = layerStatistics[i];
+                        jsonOfstream << (i > 0 ? "," : "") << "\n\t\t{\"name\": \"" << layerStatistic.name
+                                     << "\", \"type\": \"" << layerStatistic.type
+                                     << "\", \"ms_per_frame\": " << toFixed(layerStatistic.totalMs / numberFrames, 4)
+                                     << ", \"percentage\": " << toFixed(percentage(layerStatistic), 2)
+                                     << ", \"max_ms\": " << toFixed(layerStatistic.maxMs, 4)
+                                     << ", \"calls\": " << layerStatistic.calls
+                                     << ", \"output_bytes\": " << layerStatistic.outputBytes
+                                     << ", \"output_shape\": " << jsonArray(layerStatistic.outputShape) << "}";
+                    }
+                    jsonOfstream << "\n\t]\n}\n";
+                    log("Layer profile written into " + jsonPath + ".", Priority::High);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
         inline void reshapeNetCaffe(caffe::Net<float>* caffeNet, const std::vector<int>& dimensions)
         {
             try
@@ -71,13 +573,267 @@ namespace op
                 error(e.what(), __LINE__, __FUNCTION__, __FILE__);
             }
         }
+
+        // Caffe mode, device and CPU threads are per thread, so they must be set on any thread running a net (e.g.,
+        // TaskPool threads)
+        inline void setCaffeThreadContext(const int gpuId, const int intraOpThreads)
+        {
+            try
+            {
+                #ifdef USE_CUDA
+                    caffe::Caffe::set_mode(caffe::Caffe::GPU);
+                    caffe::Caffe::SetDevice(gpuId);
+                #else
+                    UNUSED(gpuId);
+                    caffe::Caffe::set_mode(caffe::Caffe::CPU);
+                #endif
+                // Threads of the CPU layers (per calling thread, so parallel workers do not oversubscribe the cores)
+                if (intraOpThreads > 0 && caffe::Caffe::cpu_threads() != intraOpThreads)
+                    caffe::Caffe::set_cpu_threads(intraOpThreads);
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        // Arena offsets aligned as cudaMalloc, so cuDNN/cuBLAS see the same alignment than with individual blobs
+        const auto BLOB_ARENA_ALIGNMENT = 256ull;
+        // Number of input sizes whose memory plan is kept (e.g., image directories, multi-scale, ROI crops)
+        const auto BLOB_MEMORY_PLAN_CACHE_SIZE = 8u;
+
+        struct BlobLifetime
+        {
+            int blobIndex;
+            int firstLayer;
+            int lastLayer;
+            unsigned long long bytes;
+            unsigned long long offset;
+            std::vector<int> layers;
+        };
+
+        // Whether both blobs can be in use at the same time. With a LayerScheduler, layers that do not precede
+        // each other might run concurrently, so disjoint sequential lifetimes are not enough
+        bool blobLifetimesOverlap(const BlobLifetime& a, const BlobLifetime& b,
+                                  const caffe::LayerScheduler<float>* const layerScheduler)
+        {
+            if (b.lastLayer < a.firstLayer)
+                return blobLifetimesOverlap(b, a, layerScheduler);
+            if (b.firstLayer <= a.lastLayer)
+                return true;
+            if (layerScheduler != nullptr)
+                for (const auto aLayer : a.layers)
+                    for (const auto bLayer : b.layers)
+                        if (!layerScheduler->precedes(aLayer, bLayer))
+                            return true;
+            return false;
+        }
+
+        // Whether the layer makes its tops share the data of bottom[0] (Blob::ShareData) instead of writing them
+        bool layerSharesData(const caffe::Layer<float>& layer, const int numberBottoms, const int numberTops)
+        {
+            const std::string type{layer.type()};
+            return (type == "Split" || type == "Flatten" || type == "Reshape"
+                    || (type == "Concat" && numberBottoms == 1) || (type == "Slice" && numberTops == 1));
+        }
+
+        int getAliasRoot(std::vector<int>& aliasParents, int blobIndex)
+        {
+            while (aliasParents[blobIndex] != blobIndex)
+                blobIndex = aliasParents[blobIndex] = aliasParents[aliasParents[blobIndex]];
+            return blobIndex;
+        }
+
+        // Inference-only memory planner: each intermediate blob lives from the layer that produces it until the
+        // last layer that reads it (layers run sequentially in ForwardFrom, or as ordered by layerScheduler if not
+        // nullptr), and blobs whose lifetimes do not overlap are placed at the same arena offsets. Blobs aliased by
+        // Split/Flatten/Reshape-like layers are planned as a single blob (the layers re-share the data on each
+        // forward), and so are the in-place bottoms of a Concat with its top (re-pointed into the planned top
+        // afterwards). The input blob, the network outputs and outputBlob are not planned.
+        BlobMemoryPlan planBlobMemory(const caffe::Net<float>& caffeNet, const caffe::Blob<float>* const outputBlob,
+                                      const caffe::LayerScheduler<float>* const layerScheduler,
+                                      const Priority priority)
+        {
+            try
+            {
+                const auto& blobs = caffeNet.blobs();
+                const auto numberLayers = (int)caffeNet.layers().size();
+                // Blob lifetimes
+                std::vector<BlobLifetime> blobLifetimes(blobs.size());
+                for (auto blobIndex = 0u ; blobIndex < blobs.size() ; blobIndex++)
+                    blobLifetimes[blobIndex] = BlobLifetime{
+                        (int)blobIndex, numberLayers, -1,
+                        ((blobs[blobIndex]->count() * sizeof(float) + BLOB_ARENA_ALIGNMENT - 1)
+                         / BLOB_ARENA_ALIGNMENT) * BLOB_ARENA_ALIGNMENT,
+                        0ull, {}
+                    };
+                // Alias groups (tops sharing the data of their bottom)
+                std::vector<int> aliasParents(blobs.size());
+                std::iota(aliasParents.begin(), aliasParents.end(), 0);
+                for (auto layer = 0 ; layer < numberLayers ; layer++)
+                {
+                    const auto& bottomIds = caffeNet.bottom_ids(layer);
+                    const auto& topIds = caffeNet.top_ids(layer);
+                    if (!bottomIds.empty()
+                        && layerSharesData(*caffeNet.layers()[layer], (int)bottomIds.size(), (int)topIds.size()))
+                        for (const auto blobIndex : topIds)
+                            aliasParents[getAliasRoot(aliasParents, blobIndex)] = getAliasRoot(aliasParents,
+                                                                                                bottomIds[0]);
+                    // In-place Concat bottoms point into the Concat top, so the top must be the group root
+                    const auto* concatLayer = dynamic_cast<const caffe::ConcatLayer<float>*>(
+                        caffeNet.layers()[layer].get());
+                    if (concatLayer != nullptr)
+                        for (auto i = 0u ; i < bottomIds.size() ; i++)
+                            if (concatLayer->is_in_place_bottom(i))
+                                aliasParents[getAliasRoot(aliasParents, bottomIds[i])] = getAliasRoot(aliasParents,
+                                                                                                      topIds[0]);
+                }
+                // Lifetimes (accumulated on the root of each alias group)
+                for (auto layer = 0 ; layer < numberLayers ; layer++)
+                {
+                    for (const auto blobIndex : caffeNet.top_ids(layer))
+                    {
+                        auto& blobLifetime = blobLifetimes[getAliasRoot(aliasParents, blobIndex)];
+                        blobLifetime.firstLayer = fastMin(blobLifetime.firstLayer, layer);
+                        blobLifetime.lastLayer = fastMax(blobLifetime.lastLayer, layer);
+                        blobLifetime.layers.emplace_back(layer);
+                    }
+                    for (const auto blobIndex : caffeNet.bottom_ids(layer))
+                    {
+                        auto& blobLifetime = blobLifetimes[getAliasRoot(aliasParents, blobIndex)];
+                        blobLifetime.lastLayer = fastMax(blobLifetime.lastLayer, layer);
+                        blobLifetime.layers.emplace_back(layer);
+                    }
+                }
+                // Blobs that keep their own memory (the whole alias group if any of its blobs must)
+                std::vector<bool> keepMemory(blobs.size(), false);
+                keepMemory[getAliasRoot(aliasParents, 0)] = true;
+                for (const auto blobIndex : caffeNet.input_blob_indices())
+                    keepMemory[getAliasRoot(aliasParents, blobIndex)] = true;
+                for (const auto blobIndex : caffeNet.output_blob_indices())
+                    keepMemory[getAliasRoot(aliasParents, blobIndex)] = true;
+                for (auto blobIndex = 0u ; blobIndex < blobs.size() ; blobIndex++)
+                {
+                    const auto rootIndex = getAliasRoot(aliasParents, (int)blobIndex);
+                    if (blobs[blobIndex].get() == outputBlob || blobLifetimes[rootIndex].firstLayer == numberLayers
+                        || blobs[blobIndex]->count() == 0)
+                        keepMemory[rootIndex] = true;
+                }
+                // Greedy placement (biggest blobs first): lowest offset not used by any already placed blob whose
+                // lifetime overlaps
+                std::vector<BlobLifetime> plannedBlobs;
+                auto keptBytes = 0ull;
+                auto unplannedBytes = 0ull;
+                for (const auto& blobLifetime : blobLifetimes)
+                {
+                    // Aliased blobs do not own memory, with or without planning
+                    if (getAliasRoot(aliasParents, blobLifetime.blobIndex) != blobLifetime.blobIndex)
+                        continue;
+                    if (keepMemory[blobLifetime.blobIndex])
+                        keptBytes += blobLifetime.bytes;
+                    else
+                    {
+                        plannedBlobs.emplace_back(blobLifetime);
+                        unplannedBytes += blobLifetime.bytes;
+                    }
+                }
+                std::sort(plannedBlobs.begin(), plannedBlobs.end(),
+                          [](const BlobLifetime& a, const BlobLifetime& b) { return a.bytes > b.bytes; });
+                auto arenaBytes = 0ull;
+                for (auto i = 0u ; i < plannedBlobs.size() ; i++)
+                {
+                    auto& blobLifetime = plannedBlobs[i];
+                    std::vector<const BlobLifetime*> overlappingBlobs;
+                    for (auto j = 0u ; j < i ; j++)
+                        if (blobLifetimesOverlap(plannedBlobs[j], blobLifetime, layerScheduler))
+                            overlappingBlobs.emplace_back(&plannedBlobs[j]);
+                    std::sort(overlappingBlobs.begin(), overlappingBlobs.end(),
+                              [](const BlobLifetime* a, const BlobLifetime* b) { return a->offset < b->offset; });
+                    blobLifetime.offset = 0ull;
+                    for (const auto* overlappingBlob : overlappingBlobs)
+                    {
+                        if (blobLifetime.offset + blobLifetime.bytes <= overlappingBlob->offset)
+                            break;
+                        blobLifetime.offset = fastMax(blobLifetime.offset,
+                                                      overlappingBlob->offset + overlappingBlob->bytes);
+                    }
+                    arenaBytes = fastMax(arenaBytes, blobLifetime.offset + blobLifetime.bytes);
+                }
+                BlobMemoryPlan blobMemoryPlan{{}, arenaBytes};
+                for (const auto& blobLifetime : plannedBlobs)
+                    blobMemoryPlan.blobOffsets.emplace_back(blobLifetime.blobIndex, blobLifetime.offset);
+                // Diffs are lazily allocated by Caffe and never touched by a TEST-phase forward pass
+                auto diffBytes = 0ull;
+                for (const auto& blob : blobs)
+                    if (blob->diff() != nullptr && blob->diff()->head() != caffe::SyncedMemory::UNINITIALIZED)
+                        diffBytes += blob->diff()->size();
+                const auto mb = 1. / (1024. * 1024.);
+                log("Caffe activation memory: " + std::to_string((keptBytes + unplannedBytes) * mb) + " MB without"
+                    " planning, " + std::to_string((keptBytes + arenaBytes) * mb) + " MB planned ("
+                    + std::to_string(plannedBlobs.size()) + " blobs in a " + std::to_string(arenaBytes * mb)
+                    + " MB arena). Allocated diffs: " + std::to_string(diffBytes * mb) + " MB.",
+                    priority, __LINE__, __FUNCTION__, __FILE__);
+                return blobMemoryPlan;
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return BlobMemoryPlan{{}, 0ull};
+            }
+        }
+
+        // It points the planned blobs into the arena, which only grows (i.e., it fits the biggest input size used
+        // so far), so switching between already planned input sizes does not allocate memory
+        void applyBlobMemoryPlan(std::unique_ptr<caffe::SyncedMemory>& upBlobArena, caffe::Net<float>& caffeNet,
+                                 const BlobMemoryPlan& blobMemoryPlan)
+        {
+            try
+            {
+                // The previous arena is released afterwards, once no blob points into it
+                std::unique_ptr<caffe::SyncedMemory> upPreviousBlobArena;
+                if (upBlobArena == nullptr || upBlobArena->size() < blobMemoryPlan.arenaBytes)
+                {
+                    upPreviousBlobArena = std::move(upBlobArena);
+                    upBlobArena.reset(new caffe::SyncedMemory{fastMax(blobMemoryPlan.arenaBytes,
+                                                                      BLOB_ARENA_ALIGNMENT)});
+                }
+                #ifdef USE_CUDA
+                    auto* arenaPtr = (char*)upBlobArena->mutable_gpu_data();
+                #else
+                    auto* arenaPtr = (char*)upBlobArena->mutable_cpu_data();
+                #endif
+                const auto& blobs = caffeNet.blobs();
+                for (const auto& blobOffset : blobMemoryPlan.blobOffsets)
+                {
+                    auto* blobPtr = (float*)(arenaPtr + blobOffset.second);
+                    #ifdef USE_CUDA
+                        blobs[blobOffset.first]->set_gpu_data(blobPtr);
+                    #else
+                        blobs[blobOffset.first]->set_cpu_data(blobPtr);
+                    #endif
+                }
+                for (auto layer = 0u ; layer < caffeNet.layers().size() ; layer++)
+                {
+                    auto* concatLayer = dynamic_cast<caffe::ConcatLayer<float>*>(caffeNet.layers()[layer].get());
+                    if (concatLayer != nullptr)
+                        concatLayer->ShareInPlaceBottoms(caffeNet.bottom_vecs()[layer], caffeNet.top_vecs()[layer]);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
     #endif
 
     NetCaffe::NetCaffe(const std::string& caffeProto, const std::string& caffeTrainedModel, const int gpuId,
-                       const bool enableGoogleLogging, const std::string& lastBlobName)
+                       const bool enableGoogleLogging, const std::string& lastBlobName, const bool planMemory,
+                       const int intraOpThreads, const std::vector<std::string>& earlyExitBlobNames,
+                       const int interOpThreads)
         #ifdef USE_CAFFE
             : upImpl{new ImplNetCaffe{caffeProto, caffeTrainedModel, gpuId, enableGoogleLogging,
-                                      lastBlobName}}
+                                      lastBlobName, planMemory, intraOpThreads, earlyExitBlobNames,
+                                      interOpThreads}}
         #endif
     {
         try
@@ -88,6 +844,10 @@ namespace op
                 UNUSED(caffeTrainedModel);
                 UNUSED(gpuId);
                 UNUSED(lastBlobName);
+                UNUSED(planMemory);
+                UNUSED(intraOpThreads);
+                UNUSED(earlyExitBlobNames);
+                UNUSED(interOpThreads);
                 error("OpenPose must be compiled with the `USE_CAFFE` macro definition in order to use this"
                       " functionality.", __LINE__, __FUNCTION__, __FILE__);
             #endif
@@ -108,20 +868,53 @@ namespace op
         {
             #ifdef USE_CAFFE
                 // Initialize net
-                #ifdef USE_CUDA
-                    caffe::Caffe::set_mode(caffe::Caffe::GPU);
-                    caffe::Caffe::SetDevice(upImpl->mGpuId);
-                #else
-                    caffe::Caffe::set_mode(caffe::Caffe::CPU);
-                #endif
+                setCaffeThreadContext(upImpl->mGpuId, upImpl->mIntraOpThreads);
                 upImpl->upCaffeNet.reset(new caffe::Net<float>{upImpl->mCaffeProto, caffe::TEST});
-                upImpl->upCaffeNet->CopyTrainedLayersFrom(upImpl->mCaffeTrainedModel);
+                // Trained weights loaded once per process and GPU, and shared with every other instance
+                upImpl->spWeightsNet = getSharedWeightsNet(upImpl->mCaffeProto, upImpl->mCaffeTrainedModel,
+                                                           upImpl->mGpuId);
+                upImpl->upCaffeNet->ShareTrainedLayersWith(upImpl->spWeightsNet.get());
+                shareInt8Scales(*upImpl->upCaffeNet, *upImpl->spWeightsNet);
                 cudaCheck(__LINE__, __FUNCTION__, __FILE__);
                 // Set spOutputBlob
-                upImpl->spOutputBlob = upImpl->upCaffeNet->blob_by_name(upImpl->mLastBlobName);
-                if (upImpl->spOutputBlob == nullptr)
+                upImpl->spLastBlob = upImpl->upCaffeNet->blob_by_name(upImpl->mLastBlobName);
+                if (upImpl->spLastBlob == nullptr)
                     error("The output blob is a nullptr. Did you use the same name than the prototxt? (Used: "
                           + upImpl->mLastBlobName + ").", __LINE__, __FUNCTION__, __FILE__);
+                upImpl->spOutputBlob = upImpl->spLastBlob;
+                // Early exit: last layer writing any of the early-exit blobs
+                if (!upImpl->mEarlyExitBlobNames.empty())
+                {
+                    const auto& blobNames = upImpl->upCaffeNet->blob_names();
+                    for (const auto& blobName : upImpl->mEarlyExitBlobNames)
+                    {
+                        const auto blobIndex = (int)(std::find(blobNames.begin(), blobNames.end(), blobName)
+                                                     - blobNames.begin());
+                        if (blobIndex == (int)blobNames.size())
+                            error("Early-exit blob " + blobName + " not found in " + upImpl->mCaffeProto + ".",
+                                  __LINE__, __FUNCTION__, __FILE__);
+                        upImpl->mEarlyExitBlobs.emplace_back(upImpl->upCaffeNet->blobs()[blobIndex].get());
+                        for (auto layer = 0 ; layer < (int)upImpl->upCaffeNet->layers().size() ; layer++)
+                        {
+                            const auto& topIds = upImpl->upCaffeNet->top_ids(layer);
+                            if (std::find(topIds.begin(), topIds.end(), blobIndex) != topIds.end())
+                                upImpl->mEarlyExitLayer = fastMax(upImpl->mEarlyExitLayer, layer);
+                        }
+                    }
+                    upImpl->spOutputBlob.reset(new caffe::Blob<float>{});
+                }
+                // Independent layers run concurrently (CPU only, the GPU version uses a single CUDA stream)
+                if (upImpl->mInterOpThreads > 1)
+                {
+                    #ifdef USE_CUDA
+                        log("Concurrent layers (interOpThreads) are only used by the CPU version.",
+                            Priority::Normal, __LINE__, __FUNCTION__, __FILE__);
+                    #else
+                        upImpl->upLayerScheduler.reset(new caffe::LayerScheduler<float>{
+                            upImpl->upCaffeNet.get(), upImpl->mInterOpThreads, fastMax(0, upImpl->mIntraOpThreads)
+                        });
+                    #endif
+                }
                 cudaCheck(__LINE__, __FUNCTION__, __FILE__);
             #endif
         }
@@ -142,12 +935,64 @@ namespace op
                 if (inputData.getNumberDimensions() != 4 || inputData.getSize(1) != 3)
                     error("The Array inputData must have 4 dimensions: [batch size, 3 (RGB), height, width].",
                           __LINE__, __FUNCTION__, __FILE__);
+                // Calling thread might not be the one that initialized the net
+                setCaffeThreadContext(upImpl->mGpuId, upImpl->mIntraOpThreads);
                 // Reshape Caffe net if required
                 if (!vectorsAreEqual(upImpl->mNetInputSize4D, inputData.getSize()))
                 {
                     upImpl->mNetInputSize4D = inputData.getSize();
                     reshapeNetCaffe(upImpl->upCaffeNet.get(), inputData.getSize());
+                    // Blob shapes changed -> memory plan of the new size, cached so sizes used again (e.g., image
+                    // directories, multi-scale or ROI crops) are not planned again (only the first plan is reported
+                    // by default)
+                    if (upImpl->mPlanMemory)
+                    {
+                        auto& blobMemoryPlans = upImpl->mBlobMemoryPlans;
+                        auto blobMemoryPlan = blobMemoryPlans.begin();
+                        while (blobMemoryPlan != blobMemoryPlans.end()
+                               && !vectorsAreEqual(blobMemoryPlan->first, upImpl->mNetInputSize4D))
+                            blobMemoryPlan++;
+                        if (blobMemoryPlan != blobMemoryPlans.end())
+                            blobMemoryPlans.splice(blobMemoryPlans.begin(), blobMemoryPlans, blobMemoryPlan);
+                        else
+                        {
+                            blobMemoryPlans.emplace_front(
+                                upImpl->mNetInputSize4D,
+                                planBlobMemory(*upImpl->upCaffeNet, upImpl->spLastBlob.get(),
+                                               upImpl->upLayerScheduler.get(),
+                                               (upImpl->mMemoryReported ? Priority::Low : Priority::High)));
+                            if (blobMemoryPlans.size() > BLOB_MEMORY_PLAN_CACHE_SIZE)
+                                blobMemoryPlans.pop_back();
+                            upImpl->mMemoryReported = true;
+                        }
+                        applyBlobMemoryPlan(upImpl->upBlobArena, *upImpl->upCaffeNet,
+                                            blobMemoryPlans.front().second);
+                    }
+                    // Layer profiles are per input size
+                    upImpl->mLayerStatistics.clear();
+                    upImpl->mProfiledFrames = 0ull;
+                }
+                // Layer profiling: report of the previous numberFrames forward passes
+                const auto layerProfilingFrames = sLayerProfilingFrames.load();
+                if (layerProfilingFrames > 0ull && upImpl->mProfiledFrames >= layerProfilingFrames)
+                {
+                    std::unique_lock<std::mutex> lock{sMutexNetCaffe};
+                    const auto reportFolder = sLayerProfilingFolder;
+                    lock.unlock();
+                    reportLayerStatistics(upImpl->mLayerStatistics, upImpl->mProfiledFrames,
+                                          getFileNameNoExtension(upImpl->mCaffeProto), upImpl->mNetInputSize4D,
+                                          reportFolder, upImpl->mInstanceId);
+                    upImpl->mLayerStatistics.clear();
+                    upImpl->mProfiledFrames = 0ull;
                 }
+                if (layerProfilingFrames == 0ull)
+                    upImpl->mLayerStatistics.clear();
+                else if (upImpl->mLayerStatistics.empty())
+                {
+                    upImpl->mLayerStatistics = getEmptyLayerStatistics(*upImpl->upCaffeNet);
+                    upImpl->mProfiledFrames = 0ull;
+                }
+                auto* const layerStatistics = (upImpl->mLayerStatistics.empty() ? nullptr : &upImpl->mLayerStatistics);
                 // Copy frame data to GPU memory
                 #ifdef USE_CUDA
                     auto* gpuImagePtr = upImpl->upCaffeNet->blobs().at(0)->mutable_gpu_data();
@@ -158,7 +1003,18 @@ namespace op
                     std::copy(inputData.getConstPtr(), inputData.getConstPtr() + inputData.getVolume(), cpuImagePtr);
                 #endif
                 // Perform deep network forward pass
-                upImpl->upCaffeNet->ForwardFrom(0);
+                const auto lastLayer = (int)upImpl->upCaffeNet->layers().size() - 1;
+                if (upImpl->mEarlyExitBlobs.empty())
+                    forwardFromTo(*upImpl->upCaffeNet, upImpl->upLayerScheduler.get(), layerStatistics, 0, lastLayer);
+                else
+                {
+                    forwardFromTo(*upImpl->upCaffeNet, upImpl->upLayerScheduler.get(), layerStatistics, 0,
+                                  upImpl->mEarlyExitLayer);
+                    concatenateChannels(*upImpl->spOutputBlob, upImpl->mEarlyExitBlobs);
+                    upImpl->mForwardPassStopped = true;
+                }
+                if (layerStatistics != nullptr)
+                    upImpl->mProfiledFrames++;
                 // Cuda checks
                 #ifdef USE_CUDA
                     cudaCheck(__LINE__, __FUNCTION__, __FILE__);
@@ -173,6 +1029,55 @@ namespace op
         }
     }
 
+    void NetCaffe::forwardPassRemaining() const
+    {
+        try
+        {
+            #ifdef USE_CAFFE
+                if (upImpl->mForwardPassStopped)
+                {
+                    setCaffeThreadContext(upImpl->mGpuId, upImpl->mIntraOpThreads);
+                    forwardFromTo(*upImpl->upCaffeNet, upImpl->upLayerScheduler.get(),
+                                  (upImpl->mLayerStatistics.empty() ? nullptr : &upImpl->mLayerStatistics),
+                                  upImpl->mEarlyExitLayer + 1, (int)upImpl->upCaffeNet->layers().size() - 1);
+                    concatenateChannels(*upImpl->spOutputBlob, {upImpl->spLastBlob.get()});
+                    upImpl->mForwardPassStopped = false;
+                    #ifdef USE_CUDA
+                        cudaCheck(__LINE__, __FUNCTION__, __FILE__);
+                    #endif
+                }
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void NetCaffe::setIntraOpThreads(const int intraOpThreads)
+    {
+        try
+        {
+            #ifdef USE_CAFFE
+                if (upImpl->mIntraOpThreads != intraOpThreads)
+                {
+                    upImpl->mIntraOpThreads = intraOpThreads;
+                    // The layer scheduler splits the intra-op threads between the concurrent layers
+                    if (upImpl->upLayerScheduler != nullptr)
+                        upImpl->upLayerScheduler.reset(new caffe::LayerScheduler<float>{
+                            upImpl->upCaffeNet.get(), upImpl->mInterOpThreads, fastMax(0, upImpl->mIntraOpThreads)
+                        });
+                }
+            #else
+                UNUSED(intraOpThreads);
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     boost::shared_ptr<caffe::Blob<float>> NetCaffe::getOutputBlob() const
     {
         try
@@ -189,4 +1094,38 @@ namespace op
             return nullptr;
         }
     }
+
+    std::vector<LayerStatistics> NetCaffe::getLayerStatistics() const
+    {
+        try
+        {
+            #ifdef USE_CAFFE
+                return upImpl->mLayerStatistics;
+            #else
+                return {};
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
+    void NetCaffe::setLayerProfiling(const unsigned long long numberFrames, const std::string& reportFolder)
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock{sMutexNetCaffe};
+            sLayerProfilingFolder = reportFolder;
+            sLayerProfilingFrames = numberFrames;
+            if (numberFrames > 0ull)
+                log("Caffe layer profiling enabled: report every " + std::to_string(numberFrames) + " frames"
+                    + (reportFolder.empty() ? "." : " (JSON files in " + reportFolder + ")."), Priority::High);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
 }
@@ -0,0 +1,106 @@
+#include <openpose/utilities/fastMath.hpp>
+#include <openpose/core/netResolutionController.hpp>
+
+namespace op
+{
+    NetResolutionController::NetResolutionController(const Point<int>& netInputResolution,
+                                                     const double targetLatencyMs, const int minNetInputHeight,
+                                                     const int heightStep, const double hysteresis,
+                                                     const int framesPerDecision) :
+        mTargetLatencyMs{targetLatencyMs},
+        mHysteresis{hysteresis},
+        mFramesPerDecision{framesPerDecision},
+        mStep{0u},
+        mFrames{0},
+        mLatencyMs{0.}
+    {
+        try
+        {
+            // Security checks
+            if (netInputResolution.y <= 0 || netInputResolution.y % 16 != 0)
+                error("The adaptive net resolution requires a net input height > 0 and multiple of 16.",
+                      __LINE__, __FUNCTION__, __FILE__);
+            if (minNetInputHeight <= 0 || minNetInputHeight % 16 != 0 || heightStep <= 0 || heightStep % 16 != 0)
+                error("The minimum net input height and the height step must be > 0 and multiples of 16.",
+                      __LINE__, __FUNCTION__, __FILE__);
+            if (targetLatencyMs <= 0.)
+                error("The target latency must be > 0.", __LINE__, __FUNCTION__, __FILE__);
+            if (hysteresis < 0. || hysteresis >= 1.)
+                error("The hysteresis must be in the range [0, 1).", __LINE__, __FUNCTION__, __FILE__);
+            if (framesPerDecision < 1)
+                error("The number of frames per decision must be >= 1.", __LINE__, __FUNCTION__, __FILE__);
+            // Ladder (from the highest resolution), the width keeps the aspect ratio of netInputResolution
+            for (auto height = netInputResolution.y ; height >= fastMin(minNetInputHeight, netInputResolution.y) ;
+                 height -= heightStep)
+            {
+                const auto width = (netInputResolution.x > 0
+                                    ? fastMax(16, 16 * intRound(netInputResolution.x * height
+                                                                / (float)netInputResolution.y / 16.f))
+                                    : netInputResolution.x);
+                mLadder.emplace_back(Point<int>{width, height});
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    Point<int> NetResolutionController::getNetInputResolution()
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock{mMutex};
+            return mLadder.at(mStep);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return Point<int>{};
+        }
+    }
+
+    void NetResolutionController::reportLatency(const Point<int>& netInputResolution, const double latencyMs)
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock{mMutex};
+            // Frames of a previous step (Point::operator!= only compares areas)
+            const auto& currentResolution = mLadder.at(mStep);
+            if (netInputResolution.x != currentResolution.x || netInputResolution.y != currentResolution.y)
+                return;
+            // Average latency of the current step
+            mLatencyMs += latencyMs;
+            mFrames++;
+            if (mFrames < mFramesPerDecision)
+                return;
+            const auto averageLatencyMs = mLatencyMs / mFrames;
+            mLatencyMs = 0.;
+            mFrames = 0;
+            // Step down, or step up if the upper step is expected to keep the target (latency ~ net input area)
+            auto step = mStep;
+            if (averageLatencyMs > mTargetLatencyMs * (1. + mHysteresis))
+            {
+                if (step + 1u < mLadder.size())
+                    step++;
+            }
+            else if (step > 0u)
+            {
+                const auto heightRatio = mLadder[step-1].y / (double)mLadder[step].y;
+                if (averageLatencyMs * heightRatio * heightRatio < mTargetLatencyMs * (1. - mHysteresis))
+                    step--;
+            }
+            if (step != mStep)
+            {
+                mStep = step;
+                log("Net input height changed to " + std::to_string(mLadder[mStep].y) + " (average latency: "
+                    + std::to_string(intRound(averageLatencyMs)) + " ms).", Priority::Normal,
+                    __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+}
@@ -1,58 +1,158 @@
+#include <openpose/thread/taskPool.hpp>
+#include <openpose/utilities/fastMath.hpp>
 #include <openpose/core/nmsBase.hpp>
 
 namespace op
 {
+    // Peaks of the region of a channel (x in [xBegin, xEnd), y in [yBegin, yEnd), inside [1, width-1) x
+    // [1, height-1)), appended after the first peakCount ones. The pixels inside any of the numberSkippedRegions
+    // skippedRegions (already searched) are ignored. It returns the new number of peaks
+    template <typename T>
+    int nmsRegionCpu(T* targetPtr, const T* const sourcePtr, const T threshold, const int width, const int height,
+                     const int maxPeaks, int peakCount, const int xBegin, const int xEnd, const int yBegin,
+                     const int yEnd, const Rectangle<int>* const skippedRegions, const int numberSkippedRegions)
+    {
+        try
+        {
+            for (auto y = yBegin ; y < yEnd && peakCount < maxPeaks ; y++)
+            {
+                for (auto x = xBegin ; x < xEnd && peakCount < maxPeaks ; x++)
+                {
+                    const auto* const centerPtr = sourcePtr + y*width + x;
+                    const auto value = *centerPtr;
+                    if (value > threshold
+                        && value > centerPtr[-width-1] && value > centerPtr[-width]
+                        && value > centerPtr[-width+1] && value > centerPtr[-1] && value > centerPtr[1]
+                        && value > centerPtr[width-1] && value > centerPtr[width]
+                        && value > centerPtr[width+1])
+                    {
+                        auto skipped = false;
+                        for (auto i = 0 ; i < numberSkippedRegions && !skipped ; i++)
+                        {
+                            const auto& skippedRegion = skippedRegions[i];
+                            skipped = (x >= skippedRegion.x && x < skippedRegion.x + skippedRegion.width
+                                       && y >= skippedRegion.y && y < skippedRegion.y + skippedRegion.height);
+                        }
+                        if (skipped)
+                            continue;
+                        // Accurate peak location: considered neighboors
+                        T xAcc = 0.f;
+                        T yAcc = 0.f;
+                        T scoreAcc = 0.f;
+                        const auto dWidth = 3;
+                        const auto dHeight = 3;
+                        for (auto yNeighbor = fastMax(0, y-dHeight) ;
+                             yNeighbor <= fastMin(height-1, y+dHeight) ; yNeighbor++)
+                        {
+                            for (auto xNeighbor = fastMax(0, x-dWidth) ;
+                                 xNeighbor <= fastMin(width-1, x+dWidth) ; xNeighbor++)
+                            {
+                                const auto score = sourcePtr[yNeighbor * width + xNeighbor];
+                                if (score > 0)
+                                {
+                                    xAcc += xNeighbor*score;
+                                    yAcc += yNeighbor*score;
+                                    scoreAcc += score;
+                                }
+                            }
+                        }
+                        const auto outputIndex = (peakCount + 1) * 3;
+                        targetPtr[outputIndex] = xAcc / scoreAcc;
+                        targetPtr[outputIndex + 1] = yAcc / scoreAcc;
+                        targetPtr[outputIndex + 2] = value;
+                        peakCount++;
+                    }
+                }
+            }
+            return peakCount;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return peakCount;
+        }
+    }
+
     template <typename T>
     void nmsCpu(T* targetPtr, int* kernelPtr, const T* const sourcePtr, const T threshold, const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize)
     {
         try
         {
-            UNUSED(targetPtr);
             UNUSED(kernelPtr);
-            UNUSED(sourcePtr);
-            UNUSED(threshold);
-            UNUSED(targetSize);
-            UNUSED(sourceSize);
-            error("CPU version not completely implemented.", __LINE__, __FUNCTION__, __FILE__);
+            // Same output than nmsGpu: for each channel, [0] = number of peaks, and then maxPeaks (x, y, score)
+            // triplets, where (x, y) is the score-weighted average of the 7x7 neighborhood of each 3x3 local maximum
+            const auto num = sourceSize[0];
+            const auto height = sourceSize[2];
+            const auto width = sourceSize[3];
+            const auto channels = targetSize[1];
+            const auto maxPeaks = targetSize[2]-1;
+            const auto imageOffset = height * width;
+            const auto offsetTarget = (maxPeaks+1)*targetSize[3];
 
-            // TODO: THIS CODE IS WORKING, BUT IT DOES NOT CONSIDER THE MAX NUMBER OF PEAKS
-            // const int num = bottom->shape(0);
-            // //const int channel = bottom->shape(1);
-            // const int oriSpatialHeight = bottom->shape(2);
-            // const int oriSpatialWidth = bottom->shape(3);
-
-            // T* dst_pointer = top->mutable_cpu_data();
-            // const T* const src_pointer = bottom->cpu_data();
-            // const int offset2 = oriSpatialHeight * oriSpatialWidth;
-            // const int offset2_dst = (mMaxPeaks+1)*2;
+            // Channels are independent -> 1 task per channel
+            TaskPool::getInstance().parallelFor(
+                "nmsCpu", 0, num * channels,
+                [&](const int channelBegin, const int channelEnd)
+                {
+                    for (auto offsetChannel = channelBegin ; offsetChannel < channelEnd ; offsetChannel++)
+                    {
+                        auto* targetPtrOffsetted = targetPtr + offsetChannel * offsetTarget;
+                        targetPtrOffsetted[0] = T(nmsRegionCpu(
+                            targetPtrOffsetted, sourcePtr + offsetChannel * imageOffset, threshold, width, height,
+                            maxPeaks, 0, 1, width-1, 1, height-1, (const Rectangle<int>*)nullptr, 0));
+                    }
+                },
+                1
+            );
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
 
-            //stupid method
-            // for (int n = 0; n < num; n++)
-            // {
-            //     //assume only one channel
-            //     int peakCount = 0;
-            //     for (int y = 0; y < oriSpatialHeight; y++)
-            //     {
-            //         for (int x = 0; x < oriSpatialWidth; x++)
-            //         {
-            //             const T value = src_pointer[n * offset2 + y*oriSpatialWidth + x];
-            //             if (value >= mThreshold)
-            //             {
-            //                 const T top = (y == 0) ? 0 : src_pointer[n * offset2 + (y-1)*oriSpatialWidth + x];
-            //                 const T bottom = (y == oriSpatialHeight - 1) ? 0 : src_pointer[n * offset2 + (y+1)*oriSpatialWidth + x];
-            //                 const T left = (x == 0) ? 0 : src_pointer[n * offset2 + y*oriSpatialWidth + (x-1)];
-            //                 const T right = (x == oriSpatialWidth - 1) ? 0 : src_pointer[n * offset2 + y*oriSpatialWidth + (x+1)];
-            //                 if (value > top && value > bottom && value > left && value > right)
-            //                 {
-            //                     dst_pointer[n*offset2_dst + (peakCount + 1) * 2] = x;
-            //                     dst_pointer[n*offset2_dst + (peakCount + 1) * 2 + 1] = y;
-            //                     peakCount++;
-            //                 }
-            //             }
-            //         }
-            //     }
-            //     dst_pointer[n*offset2_dst] = peakCount;
-            // }
+    template <typename T>
+    void nmsWindowsCpu(T* targetPtr, int* peakOwnersPtr, const T* const sourcePtr, const T threshold,
+                       const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize,
+                       const std::vector<std::vector<Rectangle<int>>>& windows)
+    {
+        try
+        {
+            // Security checks
+            if (sourceSize[0] != 1)
+                error("The local peak search only works with 1 heat map (merged scales).",
+                      __LINE__, __FUNCTION__, __FILE__);
+            const auto height = sourceSize[2];
+            const auto width = sourceSize[3];
+            const auto channels = targetSize[1];
+            const auto maxPeaks = targetSize[2]-1;
+            const auto imageOffset = height * width;
+            const auto offsetTarget = (maxPeaks+1)*targetSize[3];
+            for (auto channel = 0 ; channel < channels ; channel++)
+            {
+                auto* targetPtrOffsetted = targetPtr + channel * offsetTarget;
+                auto* peakOwnersPtrOffsetted = peakOwnersPtr + channel * (maxPeaks+1);
+                auto peakCount = 0;
+                if (channel < (int)windows.size())
+                {
+                    const auto& channelWindows = windows[channel];
+                    for (auto owner = 0 ; owner < (int)channelWindows.size() ; owner++)
+                    {
+                        // Window clipped to the searchable region, the overlap with the previous windows of the
+                        // channel is skipped
+                        const auto& window = channelWindows[owner];
+                        const auto previousPeakCount = peakCount;
+                        peakCount = nmsRegionCpu(
+                            targetPtrOffsetted, sourcePtr + channel * imageOffset, threshold, width, height,
+                            maxPeaks, peakCount, fastMax(1, window.x), fastMin(width-1, window.x + window.width),
+                            fastMax(1, window.y), fastMin(height-1, window.y + window.height),
+                            channelWindows.data(), owner);
+                        for (auto peak = previousPeakCount ; peak < peakCount ; peak++)
+                            peakOwnersPtrOffsetted[peak+1] = owner;
+                    }
+                }
+                targetPtrOffsetted[0] = T(peakCount);
+            }
         }
         catch (const std::exception& e)
         {
@@ -62,4 +162,12 @@ namespace op
 
     template void nmsCpu(float* targetPtr, int* kernelPtr, const float* const sourcePtr, const float threshold, const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize);
     template void nmsCpu(double* targetPtr, int* kernelPtr, const double* const sourcePtr, const double threshold, const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize);
+    template void nmsWindowsCpu(float* targetPtr, int* peakOwnersPtr, const float* const sourcePtr,
+                                const float threshold, const std::array<int, 4>& targetSize,
+                                const std::array<int, 4>& sourceSize,
+                                const std::vector<std::vector<Rectangle<int>>>& windows);
+    template void nmsWindowsCpu(double* targetPtr, int* peakOwnersPtr, const double* const sourcePtr,
+                                const double threshold, const std::array<int, 4>& targetSize,
+                                const std::array<int, 4>& sourceSize,
+                                const std::vector<std::vector<Rectangle<int>>>& windows);
 }
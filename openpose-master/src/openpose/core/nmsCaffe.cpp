@@ -80,7 +80,10 @@ namespace op
                 topShape[2] = maxPeaks+1; // # maxPeaks + 1
                 topShape[3] = 3;  // X, Y, score
                 topBlob->Reshape(topShape);
-                upImpl->mKernelBlob.Reshape(bottomShape);
+                // Only nmsGpu uses the kernel blob
+                #ifdef USE_CUDA
+                    upImpl->mKernelBlob.Reshape(bottomShape);
+                #endif
 
                 // Array sizes
                 upImpl->mTopSize = std::array<int, 4>{topBlob->shape(0), topBlob->shape(1),
@@ -118,8 +121,8 @@ namespace op
         try
         {
             #ifdef USE_CAFFE
-                nmsCpu(top.at(0)->mutable_cpu_data(), upImpl->mKernelBlob.mutable_cpu_data(), bottom.at(0)->cpu_data(),
-                       mThreshold, upImpl->mTopSize, upImpl->mBottomSize);
+                nmsCpu(top.at(0)->mutable_cpu_data(), (int*)nullptr, bottom.at(0)->cpu_data(), mThreshold,
+                       upImpl->mTopSize, upImpl->mBottomSize);
             #else
                 UNUSED(bottom);
                 UNUSED(top);
@@ -1,8 +1,67 @@
-// #include <opencv2/imgproc/imgproc.hpp>
+#include <openpose/thread/taskPool.hpp>
+#include <openpose/utilities/fastMath.hpp>
 #include <openpose/core/resizeAndMergeBase.hpp>
 
 namespace op
 {
+    // Same bicubic interpolation than the CUDA version (see cuda.hu)
+    template <typename T>
+    inline T cubicInterpolate(const T v0, const T v1, const T v2, const T v3, const T dx)
+    {
+        // http://www.paulinternet.nl/?page=bicubic
+        return (-0.5f * v0 + 1.5f * v1 - 1.5f * v2 + 0.5f * v3) * dx * dx * dx
+                + (v0 - 2.5f * v1 + 2.f * v2 - 0.5f * v3) * dx * dx
+                - 0.5f * (v0 - v2) * dx
+                + v1;
+    }
+
+    template <typename T>
+    inline void cubicSequentialData(int* intArray, T& delta, const T source, const int size)
+    {
+        intArray[1] = fastTruncate(int(source + 1e-5), 0, size - 1);
+        intArray[0] = fastMax(0, intArray[1] - 1);
+        intArray[2] = fastMin(size - 1, intArray[1] + 1);
+        intArray[3] = fastMin(size - 1, intArray[2] + 1);
+        delta = source - intArray[1];
+    }
+
+    // target = ((addToTarget ? target : 0) + resized(source)) * scaleResult
+    template <typename T>
+    void resizeChannel(T* targetPtr, const T* const sourcePtr, const T scaleWidth, const T scaleHeight,
+                       const int sourceWidth, const int sourceHeight, const int targetWidth, const int targetHeight,
+                       const bool addToTarget, const T scaleResult)
+    {
+        // The horizontal indexes & weights are the same for all the rows
+        std::vector<std::array<int, 4>> xIntArrays(targetWidth);
+        std::vector<T> dxs(targetWidth);
+        for (auto x = 0 ; x < targetWidth ; x++)
+        {
+            const T xSource = (x + T(0.5f)) / scaleWidth - T(0.5f);
+            cubicSequentialData(xIntArrays[x].data(), dxs[x], xSource, sourceWidth);
+        }
+        for (auto y = 0 ; y < targetHeight ; y++)
+        {
+            int yIntArray[4];
+            T dy;
+            const T ySource = (y + T(0.5f)) / scaleHeight - T(0.5f);
+            cubicSequentialData(yIntArray, dy, ySource, sourceHeight);
+            auto* targetRow = targetPtr + y*targetWidth;
+            for (auto x = 0 ; x < targetWidth ; x++)
+            {
+                const auto& xIntArray = xIntArrays[x];
+                T temp[4];
+                for (auto i = 0 ; i < 4 ; i++)
+                {
+                    const auto* const sourceRow = sourcePtr + yIntArray[i]*sourceWidth;
+                    temp[i] = cubicInterpolate(sourceRow[xIntArray[0]], sourceRow[xIntArray[1]],
+                                               sourceRow[xIntArray[2]], sourceRow[xIntArray[3]], dxs[x]);
+                }
+                const auto interpolated = cubicInterpolate(temp[0], temp[1], temp[2], temp[3], dy);
+                targetRow[x] = ((addToTarget ? targetRow[x] : T(0)) + interpolated) * scaleResult;
+            }
+        }
+    }
+
     template <typename T>
     void resizeAndMergeCpu(T* targetPtr, const std::vector<const T*>& sourcePtrs,
                            const std::array<int, 4>& targetSize,
@@ -11,50 +70,84 @@ namespace op
     {
         try
         {
-            UNUSED(targetPtr);
-            UNUSED(sourcePtrs);
-            UNUSED(scaleInputToNetInputs);
-            UNUSED(targetSize);
-            UNUSED(sourceSizes);
-            error("CPU version not completely implemented.", __LINE__, __FUNCTION__, __FILE__);
-
-            // TODO: THIS CODE IS WORKING, BUT IT DOES NOT CONSIDER THE SCALES (I.E. SCALE NUMBER, START AND GAP) 
-            // const int num = bottom->shape(0);
-            // const int channel = bottom->shape(1);
-            // const int sourceHeight = bottom->shape(2);
-            // const int sourceWidth = bottom->shape(3);
-            // const int targetHeight = top->shape(2);
-            // const int targetWidth = top->shape(3);
-
-            // //stupid method
-            // for (int n = 0; n < num; n++)
-            // {
-            //     for (int c = 0; c < channel; c++)
-            //     {
-            //         //fill source
-            //         cv::Mat source(sourceWidth, sourceHeight, CV_32FC1);
-            //         const auto sourceOffsetChannel = sourceHeight * sourceWidth;
-            //         const auto sourceOffsetNum = sourceOffsetChannel * channel;
-            //         const auto sourceOffset = n*sourceOffsetNum + c*sourceOffsetChannel;
-            //         const T* const sourcePtrs = bottom->cpu_data();
-            //         for (int y = 0; y < sourceHeight; y++)
-            //             for (int x = 0; x < sourceWidth; x++)
-            //                 source.at<T>(x,y) = sourcePtrs[sourceOffset + y*sourceWidth + x];
+            // Security checks
+            if (sourceSizes.empty())
+                error("sourceSizes cannot be empty.", __LINE__, __FUNCTION__, __FILE__);
+            if (sourcePtrs.size() != sourceSizes.size() || sourceSizes.size() != scaleInputToNetInputs.size())
+                error("Size(sourcePtrs) must match size(sourceSizes) and size(scaleInputToNetInputs). Currently: "
+                      + std::to_string(sourcePtrs.size()) + " vs. " + std::to_string(sourceSizes.size()) + " vs. "
+                      + std::to_string(scaleInputToNetInputs.size()) + ".", __LINE__, __FUNCTION__, __FILE__);
 
-            //         // spatial resize
-            //         cv::Mat target;
-            //         cv::resize(source, target, {targetWidth, targetHeight}, 0, 0, CV_INTER_CUBIC);
+            // Parameters
+            const auto channels = targetSize[1];
+            const auto targetHeight = targetSize[2];
+            const auto targetWidth = targetSize[3];
+            const auto targetChannelOffset = targetWidth * targetHeight;
+            const auto& sourceSize = sourceSizes[0];
+            const auto sourceHeight = sourceSize[2];
+            const auto sourceWidth = sourceSize[3];
 
-            //         //fill top
-            //         const auto targetOffsetChannel = targetHeight * targetWidth;
-            //         const auto targetOffsetNum = targetOffsetChannel * channel;
-            //         const auto targetOffset = n*targetOffsetNum + c*targetOffsetChannel;
-            //         T* targetPtr = top->mutable_cpu_data();
-            //         for (int y = 0; y < targetHeight; y++)
-            //             for (int x = 0; x < targetWidth; x++)
-            //                 targetPtr[targetOffset + y*targetWidth + x] = target.at<T>(x,y);
-            //     }
-            // }
+            // No multi-scale merging or no merging required
+            if (sourceSizes.size() == 1)
+            {
+                const auto num = sourceSize[0];
+                if (targetSize[0] > 1 || num == 1)
+                {
+                    const auto sourceChannelOffset = sourceHeight * sourceWidth;
+                    const auto scaleWidth = targetWidth / T(sourceWidth);
+                    const auto scaleHeight = targetHeight / T(sourceHeight);
+                    // Each channel is an independent task
+                    TaskPool::getInstance().parallelFor(
+                        "resizeAndMergeCpu", 0, num * channels,
+                        [&](const int offsetBegin, const int offsetEnd)
+                        {
+                            for (auto offset = offsetBegin ; offset < offsetEnd ; offset++)
+                                resizeChannel(targetPtr + offset * targetChannelOffset,
+                                              sourcePtrs.at(0) + offset * sourceChannelOffset, scaleWidth,
+                                              scaleHeight, sourceWidth, sourceHeight, targetWidth, targetHeight,
+                                              false, T(1));
+                        },
+                        1
+                    );
+                }
+                // Old inefficient multi-scale merging
+                else
+                    error("It should never reache this point. Notify us otherwise.", __LINE__, __FUNCTION__, __FILE__);
+            }
+            // Multi-scaling merging
+            else
+            {
+                const auto scaleToMainScaleWidth = targetWidth / T(sourceWidth);
+                const auto scaleToMainScaleHeight = targetHeight / T(sourceHeight);
+                const auto numberScales = sourceSizes.size();
+                // Each channel is an independent task, the scales are accumulated sequentially inside it
+                TaskPool::getInstance().parallelFor(
+                    "resizeAndMergeCpu", 0, channels,
+                    [&](const int channelBegin, const int channelEnd)
+                    {
+                        for (auto c = channelBegin ; c < channelEnd ; c++)
+                        {
+                            for (auto i = 0u ; i < numberScales ; i++)
+                            {
+                                const auto& currentSize = sourceSizes.at(i);
+                                const auto currentHeight = currentSize[2];
+                                const auto currentWidth = currentSize[3];
+                                const auto sourceChannelOffset = currentHeight * currentWidth;
+                                const auto scaleInputToNet = scaleInputToNetInputs[i] / scaleInputToNetInputs[0];
+                                // First image --> overwrite, rest --> add, last --> also average all
+                                resizeChannel(targetPtr + c * targetChannelOffset,
+                                              sourcePtrs[i] + c * sourceChannelOffset,
+                                              scaleToMainScaleWidth / scaleInputToNet,
+                                              scaleToMainScaleHeight / scaleInputToNet,
+                                              currentWidth, currentHeight, targetWidth, targetHeight,
+                                              (i > 0),
+                                              (i < numberScales - 1 ? T(1) : T(1) / T(numberScales)));
+                            }
+                        }
+                    },
+                    1
+                );
+            }
         }
         catch (const std::exception& e)
         {
@@ -31,14 +31,31 @@ namespace op
 
     std::tuple<std::vector<double>, std::vector<Point<int>>, double, Point<int>> ScaleAndSizeExtractor::extract(
         const Point<int>& inputResolution) const
+    {
+        try
+        {
+            return extract(inputResolution, mNetInputResolution);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return std::make_tuple(std::vector<double>{}, std::vector<Point<int>>{}, 1., Point<int>{});
+        }
+    }
+
+    std::tuple<std::vector<double>, std::vector<Point<int>>, double, Point<int>> ScaleAndSizeExtractor::extract(
+        const Point<int>& inputResolution, const Point<int>& netInputResolution) const
     {
         try
         {
             // Security checks
             if (inputResolution.area() <= 0)
                 error("Wrong input element (empty cvInputData).", __LINE__, __FUNCTION__, __FILE__);
+            if ((netInputResolution.x > 0 && netInputResolution.x % 16 != 0)
+                || (netInputResolution.y > 0 && netInputResolution.y % 16 != 0))
+                error("Net input resolution must be multiples of 16.", __LINE__, __FUNCTION__, __FILE__);
             // Set poseNetInputSize
-            auto poseNetInputSize = mNetInputResolution;
+            auto poseNetInputSize = netInputResolution;
             if (poseNetInputSize.x <= 0 || poseNetInputSize.y <= 0)
             {
                 // Security checks
@@ -1,14 +1,182 @@
+#include <algorithm> // std::copy, std::fill
+#include <cmath> // std::exp
+#include <limits> // std::numeric_limits
+#include <openpose/utilities/fastMath.hpp>
 #include <openpose/experimental/tracking/personIdExtractor.hpp>
 
 namespace op
 {
-    PersonIdExtractor::PersonIdExtractor() :
-        mNextPersonId{0ll}
+    // OKS constant (COCO-like, the same one for all the body parts so it works for any PoseModel)
+    const auto OKS_KAPPA = 0.1f;
+
+    Rectangle<float> getVisibleRectangle(const float* const keypoints, const int numberParts, const float threshold)
+    {
+        try
+        {
+            auto minX = std::numeric_limits<float>::max();
+            auto maxX = std::numeric_limits<float>::lowest();
+            auto minY = minX;
+            auto maxY = maxX;
+            for (auto part = 0 ; part < numberParts ; part++)
+            {
+                if (keypoints[3*part+2] > threshold)
+                {
+                    minX = fastMin(minX, keypoints[3*part]);
+                    maxX = fastMax(maxX, keypoints[3*part]);
+                    minY = fastMin(minY, keypoints[3*part+1]);
+                    maxY = fastMax(maxY, keypoints[3*part+1]);
+                }
+            }
+            if (maxX >= minX && maxY >= minY)
+                return Rectangle<float>{minX, minY, maxX - minX, maxY - minY};
+            return Rectangle<float>{};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return Rectangle<float>{};
+        }
+    }
+
+    float getSimilarity(const float* const trackKeypoints, const Rectangle<float>& trackRectangle,
+                        const float* const keypoints, const Rectangle<float>& rectangle, const int numberParts,
+                        const float threshold)
+    {
+        try
+        {
+            // Keypoint-weighted IoU: IoU of the bounding boxes x fraction of keypoints visible in both
+            const auto intersectionWidth = fastMin(trackRectangle.x + trackRectangle.width,
+                                                   rectangle.x + rectangle.width)
+                                         - fastMax(trackRectangle.x, rectangle.x);
+            const auto intersectionHeight = fastMin(trackRectangle.y + trackRectangle.height,
+                                                    rectangle.y + rectangle.height)
+                                          - fastMax(trackRectangle.y, rectangle.y);
+            const auto intersection = (intersectionWidth > 0.f && intersectionHeight > 0.f
+                                       ? intersectionWidth * intersectionHeight : 0.f);
+            const auto unionArea = trackRectangle.area() + rectangle.area() - intersection;
+            // OKS, with the track bounding box as object scale
+            const auto scale2 = fastMax(trackRectangle.area(), 1.f);
+            const auto oksNormalization = 1.f / (2.f * scale2 * OKS_KAPPA * OKS_KAPPA);
+            auto numberCommon = 0;
+            auto numberUnion = 0;
+            auto numberTrack = 0;
+            auto oks = 0.f;
+            for (auto part = 0 ; part < numberParts ; part++)
+            {
+                const auto visibleTrack = trackKeypoints[3*part+2] > threshold;
+                const auto visible = keypoints[3*part+2] > threshold;
+                numberTrack += visibleTrack;
+                numberUnion += (visibleTrack || visible);
+                if (visibleTrack && visible)
+                {
+                    numberCommon++;
+                    const auto dx = trackKeypoints[3*part] - keypoints[3*part];
+                    const auto dy = trackKeypoints[3*part+1] - keypoints[3*part+1];
+                    oks += std::exp(-(dx*dx + dy*dy) * oksNormalization);
+                }
+            }
+            if (numberCommon == 0)
+                return 0.f;
+            const auto iou = (unionArea > 0.f ? intersection / unionArea : 0.f) * numberCommon / (float)numberUnion;
+            oks /= numberTrack;
+            return 0.5f * (iou + oks);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 0.f;
+        }
+    }
+
+    void assignMinimumCost(std::vector<int>& assignment, const std::vector<float>& costs, const int size,
+                           std::vector<float>& floatBuffer, std::vector<int>& intBuffer)
+    {
+        try
+        {
+            // Hungarian algorithm (O(size^3)) over the square costs matrix (row-major), with potentials. It returns
+            // the column assigned to each row
+            const auto infinity = std::numeric_limits<float>::max();
+            floatBuffer.assign(3*(size+1), 0.f);
+            intBuffer.assign(3*(size+1), 0);
+            auto* const u = floatBuffer.data();
+            auto* const v = u + size + 1;
+            auto* const minV = v + size + 1;
+            auto* const p = intBuffer.data();
+            auto* const way = p + size + 1;
+            auto* const used = way + size + 1;
+            for (auto row = 1 ; row <= size ; row++)
+            {
+                p[0] = row;
+                auto j0 = 0;
+                std::fill(minV, minV + size + 1, infinity);
+                std::fill(used, used + size + 1, 0);
+                do
+                {
+                    used[j0] = 1;
+                    const auto i0 = p[j0];
+                    const auto* const costsRow = &costs[(i0-1)*size];
+                    auto delta = infinity;
+                    auto j1 = 0;
+                    for (auto j = 1 ; j <= size ; j++)
+                    {
+                        if (!used[j])
+                        {
+                            const auto current = costsRow[j-1] - u[i0] - v[j];
+                            if (current < minV[j])
+                            {
+                                minV[j] = current;
+                                way[j] = j0;
+                            }
+                            if (minV[j] < delta)
+                            {
+                                delta = minV[j];
+                                j1 = j;
+                            }
+                        }
+                    }
+                    for (auto j = 0 ; j <= size ; j++)
+                    {
+                        if (used[j])
+                        {
+                            u[p[j]] += delta;
+                            v[j] -= delta;
+                        }
+                        else
+                            minV[j] -= delta;
+                    }
+                    j0 = j1;
+                } while (p[j0] != 0);
+                do
+                {
+                    const auto j1 = way[j0];
+                    p[j0] = p[j1];
+                    j0 = j1;
+                } while (j0 != 0);
+            }
+            assignment.resize(size);
+            for (auto column = 1 ; column <= size ; column++)
+                assignment[p[column]-1] = column-1;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    PersonIdExtractor::PersonIdExtractor(const float minSimilarity, const int maxFramesLost,
+                                         const float keypointThreshold) :
+        mMinSimilarity{minSimilarity},
+        mMaxFramesLost{maxFramesLost},
+        mKeypointThreshold{keypointThreshold},
+        mNextPersonId{0ll},
+        mNumberParts{0}
     {
         try
         {
-            error("PersonIdExtractor (`identification` flag) not available yet, but we are working on it! Coming"
-                  " soon!", __LINE__, __FUNCTION__, __FILE__);
+            if (mMinSimilarity < 0.f || mMinSimilarity > 1.f)
+                error("The minimum similarity must be in the range [0, 1].", __LINE__, __FUNCTION__, __FILE__);
+            if (mMaxFramesLost < 0)
+                error("The maximum number of frames lost must be >= 0.", __LINE__, __FUNCTION__, __FILE__);
         }
         catch (const std::exception& e)
         {
@@ -24,10 +192,112 @@ namespace op
     {
         try
         {
-            // Dummy: giving a new id to each element
-            Array<long long> poseIds{poseKeypoints.getSize(0), -1};
-            for (auto i = 0u ; i < poseIds.getVolume() ; i++)
-                poseIds[i] = mNextPersonId++;
+            const auto numberPeople = poseKeypoints.getSize(0);
+            const auto numberParts = poseKeypoints.getSize(1);
+            // New PoseModel (or first frame): reset tracks
+            if (numberPeople > 0 && numberParts != mNumberParts)
+            {
+                mNumberParts = numberParts;
+                mTrackIds.clear();
+                mTrackKeypoints.clear();
+                mTrackFramesLost.clear();
+            }
+            const auto numberTracks = (int)mTrackIds.size();
+            const auto personArea = 3 * mNumberParts;
+            // Similarities (#tracks x #people) and costs (square matrix, 1 for non-valid associations and padding)
+            auto& trackOfPerson = mTrackOfPerson;
+            trackOfPerson.assign(numberPeople, -1);
+            if (numberTracks > 0 && numberPeople > 0)
+            {
+                auto& rectangles = mRectangles;
+                rectangles.resize(numberPeople);
+                for (auto person = 0 ; person < numberPeople ; person++)
+                    rectangles[person] = getVisibleRectangle(&poseKeypoints[person*personArea], mNumberParts,
+                                                             mKeypointThreshold);
+                const auto size = fastMax(numberTracks, numberPeople);
+                mSimilarities.assign(numberTracks * numberPeople, 0.f);
+                mCosts.assign(size * size, 1.f);
+                for (auto track = 0 ; track < numberTracks ; track++)
+                {
+                    const auto* const trackKeypoints = &mTrackKeypoints[track*personArea];
+                    const auto trackRectangle = getVisibleRectangle(trackKeypoints, mNumberParts,
+                                                                    mKeypointThreshold);
+                    for (auto person = 0 ; person < numberPeople ; person++)
+                    {
+                        const auto similarity = getSimilarity(trackKeypoints, trackRectangle,
+                                                              &poseKeypoints[person*personArea], rectangles[person],
+                                                              mNumberParts, mKeypointThreshold);
+                        mSimilarities[track*numberPeople + person] = similarity;
+                        if (similarity >= mMinSimilarity)
+                            mCosts[track*size + person] = 1.f - similarity;
+                    }
+                }
+                assignMinimumCost(mAssignment, mCosts, size, mHungarianBuffer, mHungarianIndexes);
+                for (auto track = 0 ; track < numberTracks ; track++)
+                {
+                    const auto person = mAssignment[track];
+                    if (person < numberPeople && mSimilarities[track*numberPeople + person] >= mMinSimilarity)
+                        trackOfPerson[person] = track;
+                }
+            }
+            // Update matched tracks (the parts not visible in this frame keep their last location)
+            auto& trackMatched = mTrackMatched;
+            trackMatched.assign(numberTracks, false);
+            for (auto person = 0 ; person < numberPeople ; person++)
+            {
+                const auto track = trackOfPerson[person];
+                if (track >= 0)
+                {
+                    trackMatched[track] = true;
+                    mTrackFramesLost[track] = 0;
+                    auto* const trackKeypoints = &mTrackKeypoints[track*personArea];
+                    const auto* const keypoints = &poseKeypoints[person*personArea];
+                    for (auto part = 0 ; part < mNumberParts ; part++)
+                        if (keypoints[3*part+2] > mKeypointThreshold)
+                            std::copy(&keypoints[3*part], &keypoints[3*part+3], &trackKeypoints[3*part]);
+                }
+            }
+            // Age out lost tracks
+            auto numberKept = 0;
+            for (auto track = 0 ; track < numberTracks ; track++)
+            {
+                if (!trackMatched[track])
+                    mTrackFramesLost[track]++;
+                if (mTrackFramesLost[track] <= mMaxFramesLost)
+                {
+                    if (numberKept != track)
+                    {
+                        mTrackIds[numberKept] = mTrackIds[track];
+                        mTrackFramesLost[numberKept] = mTrackFramesLost[track];
+                        std::copy(&mTrackKeypoints[track*personArea], &mTrackKeypoints[(track+1)*personArea],
+                                  &mTrackKeypoints[numberKept*personArea]);
+                    }
+                    // Index of the track after removing the lost ones
+                    for (auto& trackOfPersonI : trackOfPerson)
+                        if (trackOfPersonI == track)
+                            trackOfPersonI = numberKept;
+                    numberKept++;
+                }
+            }
+            mTrackIds.resize(numberKept);
+            mTrackFramesLost.resize(numberKept);
+            mTrackKeypoints.resize(numberKept * personArea);
+            // Ids, and new tracks for the unmatched people
+            if (numberPeople == 0)
+                return Array<long long>{};
+            Array<long long> poseIds{numberPeople, -1};
+            for (auto person = 0 ; person < numberPeople ; person++)
+            {
+                if (trackOfPerson[person] < 0)
+                {
+                    trackOfPerson[person] = (int)mTrackIds.size();
+                    mTrackIds.emplace_back(mNextPersonId++);
+                    mTrackFramesLost.emplace_back(0);
+                    mTrackKeypoints.insert(mTrackKeypoints.end(), &poseKeypoints[person*personArea],
+                                           &poseKeypoints[person*personArea] + personArea);
+                }
+                poseIds[person] = mTrackIds[trackOfPerson[person]];
+            }
             return poseIds;
         }
         catch (const std::exception& e)
@@ -1,10 +1,17 @@
 #include <openpose/pose/poseParameters.hpp>
 #include <openpose/utilities/check.hpp>
+#include <openpose/utilities/fastMath.hpp>
 #include <openpose/utilities/keypoint.hpp>
 #include <openpose/face/faceDetector.hpp>
  
 namespace op
 {
+    // Person id tracking: minimum average pose keypoint score of a person to look for its face, maximum number of
+    // frames a face rectangle is reused when its head keypoints are missed, and weight of the previous face size
+    const auto MIN_PERSON_SCORE = 0.1f;
+    const auto MAX_FRAMES_FACE_REUSED = 3ull;
+    const auto PREVIOUS_FACE_SIZE_WEIGHT = 0.5f;
+
     FaceDetector::FaceDetector(const PoseModel poseModel) :
         mNeck{poseBodyPartMapStringToKey(poseModel, "Neck")},
         mNose{poseBodyPartMapStringToKey(poseModel, std::vector<std::string>{"Nose", "Head"})},
@@ -128,4 +135,61 @@ namespace op
             return {};
         }
     }
+
+    std::vector<Rectangle<float>> FaceDetector::trackFaces(const Array<float>& poseKeypoints,
+                                                           const double scaleInputToOutput,
+                                                           const Array<long long>& poseIds,
+                                                           const unsigned long long id)
+    {
+        try
+        {
+            // Baseline detectFaces
+            auto faceRectangles = detectFaces(poseKeypoints, scaleInputToOutput);
+            if (poseIds.empty() || poseIds.getSize(0) != (int)faceRectangles.size())
+                return faceRectangles;
+            std::lock_guard<std::mutex> lock{mMutex};
+            for (auto person = 0u ; person < faceRectangles.size() ; person++)
+            {
+                auto& faceRectangle = faceRectangles[person];
+                // Low-confidence people skipped
+                if (getAverageScore(poseKeypoints, person) < MIN_PERSON_SCORE)
+                {
+                    faceRectangle = Rectangle<float>{};
+                    continue;
+                }
+                const auto facePrevious = mFacesPreviousById.find(poseIds[person]);
+                // Head keypoints missed -> previous rectangle
+                if (faceRectangle.area() <= 0)
+                {
+                    if (facePrevious != mFacesPreviousById.end())
+                        faceRectangle = facePrevious->second.first;
+                    continue;
+                }
+                // Current location (up to date), averaged size (the pose-based size is noisier)
+                if (facePrevious != mFacesPreviousById.end())
+                {
+                    const auto& previousRectangle = facePrevious->second.first;
+                    const auto faceSize = (1.f - PREVIOUS_FACE_SIZE_WEIGHT) * faceRectangle.width
+                                        + PREVIOUS_FACE_SIZE_WEIGHT * fastMax(previousRectangle.width,
+                                                                              previousRectangle.height);
+                    faceRectangle = recenter(faceRectangle, faceSize, faceSize);
+                }
+                mFacesPreviousById[poseIds[person]] = std::make_pair(faceRectangle, id);
+            }
+            // Stale people removed
+            for (auto facePrevious = mFacesPreviousById.begin() ; facePrevious != mFacesPreviousById.end() ; )
+            {
+                if (facePrevious->second.second + MAX_FRAMES_FACE_REUSED < id)
+                    facePrevious = mFacesPreviousById.erase(facePrevious);
+                else
+                    facePrevious++;
+            }
+            return faceRectangles;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
 }
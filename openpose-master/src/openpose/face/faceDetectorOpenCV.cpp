@@ -1,32 +1,25 @@
 #include <opencv2/imgproc/imgproc.hpp> // cv::COLOR_BGR2GRAY
 #include <openpose/pose/poseParameters.hpp>
+#include <openpose/utilities/fastMath.hpp>
 #include <openpose/face/faceDetectorOpenCV.hpp>
 
 namespace op
 {
-    FaceDetectorOpenCV::FaceDetectorOpenCV(const std::string& modelFolder)
-    {
-        try
-        {
-            const std::string faceDetectorModelPath{modelFolder + "face/haarcascade_frontalface_alt.xml"};
-            if (!mFaceCascade.load(faceDetectorModelPath))
-                error("Face detector model not found at: " + faceDetectorModelPath, __LINE__, __FUNCTION__, __FILE__);
-        }
-        catch (const std::exception& e)
-        {
-            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
-        }
-    }
+    // Maximum area of the scanned images (larger ones are pyrDown'ed)
+    const auto MAX_SCANNED_AREA = 640*360;
+    // Region of interest around a previous face, relative to its size
+    const auto PREVIOUS_FACE_ROI_RATIO = 2.f;
 
-    std::vector<Rectangle<float>> FaceDetectorOpenCV::detectFaces(const cv::Mat& cvInputData)
+    std::vector<Rectangle<float>> detectFacesOpenCV(cv::CascadeClassifier& faceCascade, const cv::Mat& cvInputData,
+                                                    const cv::Rect& region)
     {
         try
         {
             // Image to grey and pyrDown
             cv::Mat frameGray;
-            cv::cvtColor(cvInputData, frameGray, cv::COLOR_BGR2GRAY);
+            cv::cvtColor(cvInputData(region), frameGray, cv::COLOR_BGR2GRAY);
             auto multiplier = 1.f;
-            while (frameGray.cols * frameGray.rows > 640*360)
+            while (frameGray.cols * frameGray.rows > MAX_SCANNED_AREA)
             {
                 cv::pyrDown(frameGray, frameGray);
                 multiplier *= 2.f;
@@ -34,7 +27,7 @@ namespace op
             // Face detection - Example from:
             // http://docs.opencv.org/2.4/doc/tutorials/objdetect/cascade_classifier/cascade_classifier.html
             std::vector<cv::Rect> detectedFaces;
-            mFaceCascade.detectMultiScale(frameGray, detectedFaces, 1.2, 3, 0|CV_HAAR_SCALE_IMAGE);
+            faceCascade.detectMultiScale(frameGray, detectedFaces, 1.2, 3, 0|CV_HAAR_SCALE_IMAGE);
             // Rescale rectangles
             std::vector<Rectangle<float>> faceRectangles(detectedFaces.size());
             for(auto i = 0u; i < detectedFaces.size(); i++)
@@ -45,6 +38,103 @@ namespace op
                 faceRectangles.at(i).width = 1.5f*detectedFaces.at(i).width;
                 faceRectangles.at(i).height = 1.5f*detectedFaces.at(i).height;
                 faceRectangles.at(i) *= multiplier;
+                faceRectangles.at(i).x += region.x;
+                faceRectangles.at(i).y += region.y;
+            }
+            return faceRectangles;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
+    FaceDetectorOpenCV::FaceDetectorOpenCV(const std::string& modelFolder, const int fullScanInterval) :
+        mFullScanInterval{fullScanInterval},
+        mFramesSinceFullScan{0}
+    {
+        try
+        {
+            if (mFullScanInterval < 1)
+                error("The full scan interval must be >= 1.", __LINE__, __FUNCTION__, __FILE__);
+            const std::string faceDetectorModelPath{modelFolder + "face/haarcascade_frontalface_alt.xml"};
+            if (!mFaceCascade.load(faceDetectorModelPath))
+                error("Face detector model not found at: " + faceDetectorModelPath, __LINE__, __FUNCTION__, __FILE__);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    std::vector<Rectangle<float>> FaceDetectorOpenCV::detectFaces(const cv::Mat& cvInputData)
+    {
+        try
+        {
+            // Scan around the previous faces
+            mFramesSinceFullScan++;
+            if (!mPreviousFaces.empty() && mFramesSinceFullScan < mFullScanInterval)
+            {
+                std::vector<Rectangle<float>> regionsOfInterest;
+                for (const auto& previousFace : mPreviousFaces)
+                    regionsOfInterest.emplace_back(recenter(previousFace, PREVIOUS_FACE_ROI_RATIO*previousFace.width,
+                                                            PREVIOUS_FACE_ROI_RATIO*previousFace.height));
+                mPreviousFaces = detectFaces(cvInputData, regionsOfInterest);
+            }
+            // Full scan
+            else
+            {
+                mFramesSinceFullScan = 0;
+                mPreviousFaces = detectFacesOpenCV(mFaceCascade, cvInputData,
+                                                   cv::Rect{0, 0, cvInputData.cols, cvInputData.rows});
+            }
+            return mPreviousFaces;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
+    std::vector<Rectangle<float>> FaceDetectorOpenCV::detectFaces(
+        const cv::Mat& cvInputData, const std::vector<Rectangle<float>>& regionsOfInterest)
+    {
+        try
+        {
+            std::vector<Rectangle<float>> faceRectangles;
+            for (const auto& regionOfInterest : regionsOfInterest)
+            {
+                // Region clipped to the frame
+                const auto xMin = fastTruncate(intRound(regionOfInterest.x), 0, cvInputData.cols);
+                const auto yMin = fastTruncate(intRound(regionOfInterest.y), 0, cvInputData.rows);
+                const auto xMax = fastTruncate(intRound(regionOfInterest.x + regionOfInterest.width), 0,
+                                               cvInputData.cols);
+                const auto yMax = fastTruncate(intRound(regionOfInterest.y + regionOfInterest.height), 0,
+                                               cvInputData.rows);
+                if (xMax - xMin < 1 || yMax - yMin < 1)
+                    continue;
+                // Faces of the region, except the ones already found in an overlapping region
+                const auto regionFaces = detectFacesOpenCV(mFaceCascade, cvInputData,
+                                                           cv::Rect{xMin, yMin, xMax - xMin, yMax - yMin});
+                for (const auto& regionFace : regionFaces)
+                {
+                    const auto center = regionFace.center();
+                    auto repeated = false;
+                    for (const auto& faceRectangle : faceRectangles)
+                    {
+                        const auto bottomRight = faceRectangle.bottomRight();
+                        if (faceRectangle.x <= center.x && center.x <= bottomRight.x
+                            && faceRectangle.y <= center.y && center.y <= bottomRight.y)
+                        {
+                            repeated = true;
+                            break;
+                        }
+                    }
+                    if (!repeated)
+                        faceRectangles.emplace_back(regionFace);
+                }
             }
             return faceRectangles;
         }
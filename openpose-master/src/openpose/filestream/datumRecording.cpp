@@ -0,0 +1,348 @@
+#include <chrono>
+#include <cstring> // std::memcmp, std::memcpy
+#include <fstream> // std::ofstream
+#include <openpose/utilities/memoryMappedFile.hpp>
+#include <openpose/filestream/datumRecording.hpp>
+
+namespace op
+{
+    namespace
+    {
+        // File layout (native endianness, every block padded to 8 bytes):
+        //     Header: magic (8 bytes), version (uint32), flags (uint32), #frames (uint64), index offset (uint64)
+        //     Frames: id (uint64), timestamp (int64), name, cvInputData, scaleInputToNetInputs, netInputSizes,
+        //             scaleInputToOutput, netOutputSize, scaleNetToOutput, poseKeypoints, poseScores, poseHeatMaps
+        //     Index: offset (uint64) of each frame
+        const char RECORDING_MAGIC[8] = {'O', 'P', 'D', 'A', 'T', 'U', 'M', 'R'};
+        const unsigned int RECORDING_VERSION = 1u;
+        const unsigned int RECORDING_FLAG_HEAT_MAPS = 1u;
+        const unsigned long long RECORDING_HEADER_SIZE = 32ull;
+
+        inline unsigned long long alignTo8(const unsigned long long size)
+        {
+            return (size + 7ull) & ~7ull;
+        }
+
+        // Sequential bounds-checked reader over the mapped memory
+        class RecordingCursor
+        {
+        public:
+            RecordingCursor(const char* const dataPtr, const unsigned long long fileSize,
+                            const unsigned long long offset) :
+                mDataPtr{dataPtr},
+                mFileSize{fileSize},
+                mOffset{offset}
+            {
+            }
+
+            const char* readBytes(const unsigned long long size)
+            {
+                if (mOffset + size > mFileSize)
+                    error("Corrupted recording (frame data out of the file bounds).",
+                          __LINE__, __FUNCTION__, __FILE__);
+                const auto* const bytesPtr = mDataPtr + mOffset;
+                mOffset += alignTo8(size);
+                return bytesPtr;
+            }
+
+            template <typename T>
+            T readValue()
+            {
+                T value;
+                std::memcpy(&value, readBytes(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            std::string readString()
+            {
+                const auto size = readValue<unsigned long long>();
+                return std::string{readBytes(size), size};
+            }
+
+            cv::Mat readCvMat()
+            {
+                const auto* const header = (const int*)readBytes(4*sizeof(int));
+                const auto numberBytes = readValue<unsigned long long>();
+                auto* const pixelsPtr = (void*)readBytes(numberBytes);
+                if (header[0] <= 0 || header[1] <= 0)
+                    return cv::Mat{};
+                return cv::Mat(header[0], header[1], header[2], pixelsPtr);
+            }
+
+            Array<float> readArray()
+            {
+                const auto numberDimensions = readValue<unsigned long long>();
+                const auto* const sizesPtr = (const int*)readBytes(numberDimensions * sizeof(int));
+                const std::vector<int> sizes(sizesPtr, sizesPtr + numberDimensions);
+                Array<float> array{sizes};
+                const auto volume = (array.empty() ? 0ull : (unsigned long long)array.getVolume());
+                const auto* const valuesPtr = readBytes(volume * sizeof(float));
+                if (volume > 0)
+                    std::memcpy(array.getPtr(), valuesPtr, volume * sizeof(float));
+                return array;
+            }
+
+        private:
+            const char* const mDataPtr;
+            const unsigned long long mFileSize;
+            unsigned long long mOffset;
+        };
+    }
+
+    struct DatumRecorder::ImplDatumRecorder
+    {
+        std::ofstream mOfstream;
+        const bool mRecordHeatMaps;
+        std::vector<unsigned long long> mFrameOffsets;
+        std::chrono::high_resolution_clock::time_point mFirstFrameTime;
+
+        ImplDatumRecorder(const std::string& filePath, const bool recordHeatMaps) :
+            mOfstream{filePath, std::ios::binary},
+            mRecordHeatMaps{recordHeatMaps}
+        {
+        }
+
+        void writeBytes(const void* const dataPtr, const unsigned long long size)
+        {
+            const char padding[8] = {0};
+            mOfstream.write((const char*)dataPtr, size);
+            mOfstream.write(padding, alignTo8(size) - size);
+        }
+
+        template <typename T>
+        void writeValue(const T value)
+        {
+            writeBytes(&value, sizeof(T));
+        }
+
+        void writeString(const std::string& string)
+        {
+            writeValue((unsigned long long)string.size());
+            writeBytes(string.data(), string.size());
+        }
+
+        void writeCvMat(const cv::Mat& cvMat)
+        {
+            // Non-continuous matrices (e.g. ROIs) are copied into a continuous one first
+            const cv::Mat continuousMat = (cvMat.isContinuous() ? cvMat : cvMat.clone());
+            const int header[4] = {continuousMat.rows, continuousMat.cols, continuousMat.type(), 0};
+            writeBytes(header, sizeof(header));
+            const auto numberBytes = (unsigned long long)(continuousMat.total() * continuousMat.elemSize());
+            writeValue(numberBytes);
+            writeBytes(continuousMat.data, numberBytes);
+        }
+
+        void writeArray(const Array<float>& array)
+        {
+            const auto sizes = array.getSize();
+            writeValue((unsigned long long)sizes.size());
+            writeBytes(sizes.data(), sizes.size() * sizeof(int));
+            writeBytes(array.getConstPtr(), (array.empty() ? 0 : array.getVolume()) * sizeof(float));
+        }
+    };
+
+    struct DatumRecording::ImplDatumRecording
+    {
+        const char* mDataPtr;
+        unsigned long long mFileSize;
+        unsigned long long mNumberFrames;
+        unsigned int mFlags;
+        const unsigned long long* mFrameOffsetsPtr;
+        std::unique_ptr<MemoryMappedFile> upMemoryMappedFile;
+
+        ImplDatumRecording() :
+            mDataPtr{nullptr},
+            mFileSize{0ull},
+            mNumberFrames{0ull},
+            mFlags{0u},
+            mFrameOffsetsPtr{nullptr}
+        {
+        }
+    };
+
+    DatumRecorder::DatumRecorder(const std::string& filePath, const bool recordHeatMaps) :
+        upImpl{new ImplDatumRecorder{filePath, recordHeatMaps}}
+    {
+        try
+        {
+            if (!upImpl->mOfstream.is_open())
+                error("Recording file could not be opened: " + filePath, __LINE__, __FUNCTION__, __FILE__);
+            // Header (#frames and index offset are filled by close())
+            upImpl->mOfstream.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+            const unsigned int versionAndFlags[2] = {RECORDING_VERSION,
+                                                     (recordHeatMaps ? RECORDING_FLAG_HEAT_MAPS : 0u)};
+            upImpl->writeBytes(versionAndFlags, sizeof(versionAndFlags));
+            upImpl->writeValue(0ull);
+            upImpl->writeValue(0ull);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    DatumRecorder::~DatumRecorder()
+    {
+        try
+        {
+            close();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void DatumRecorder::record(const Datum& datum)
+    {
+        try
+        {
+            if (!upImpl->mOfstream.is_open())
+                error("DatumRecorder::record called after DatumRecorder::close.", __LINE__, __FUNCTION__, __FILE__);
+            // Timestamp relative to the first frame
+            const auto now = std::chrono::high_resolution_clock::now();
+            if (upImpl->mFrameOffsets.empty())
+                upImpl->mFirstFrameTime = now;
+            const auto timestampNs = (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                now - upImpl->mFirstFrameTime
+            ).count();
+            // Frame
+            upImpl->mFrameOffsets.emplace_back((unsigned long long)upImpl->mOfstream.tellp());
+            upImpl->writeValue(datum.id);
+            upImpl->writeValue(timestampNs);
+            upImpl->writeString(datum.name);
+            upImpl->writeCvMat(datum.cvInputData);
+            upImpl->writeValue((unsigned long long)datum.scaleInputToNetInputs.size());
+            upImpl->writeBytes(datum.scaleInputToNetInputs.data(), datum.scaleInputToNetInputs.size() * sizeof(double));
+            upImpl->writeValue((unsigned long long)datum.netInputSizes.size());
+            for (const auto& netInputSize : datum.netInputSizes)
+            {
+                const int size[2] = {netInputSize.x, netInputSize.y};
+                upImpl->writeBytes(size, sizeof(size));
+            }
+            upImpl->writeValue(datum.scaleInputToOutput);
+            const int netOutputSize[2] = {datum.netOutputSize.x, datum.netOutputSize.y};
+            upImpl->writeBytes(netOutputSize, sizeof(netOutputSize));
+            upImpl->writeValue(datum.scaleNetToOutput);
+            upImpl->writeArray(datum.poseKeypoints);
+            upImpl->writeArray(datum.poseScores);
+            upImpl->writeArray(upImpl->mRecordHeatMaps ? datum.poseHeatMaps : Array<float>{});
+            if (!upImpl->mOfstream.good())
+                error("Error while writing the recording file.", __LINE__, __FUNCTION__, __FILE__);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void DatumRecorder::close()
+    {
+        try
+        {
+            if (upImpl->mOfstream.is_open())
+            {
+                // Index
+                const auto indexOffset = (unsigned long long)upImpl->mOfstream.tellp();
+                upImpl->writeBytes(upImpl->mFrameOffsets.data(),
+                                   upImpl->mFrameOffsets.size() * sizeof(unsigned long long));
+                // Complete header
+                upImpl->mOfstream.seekp(sizeof(RECORDING_MAGIC) + 2*sizeof(unsigned int));
+                upImpl->writeValue((unsigned long long)upImpl->mFrameOffsets.size());
+                upImpl->writeValue(indexOffset);
+                upImpl->mOfstream.close();
+                log("Recorded " + std::to_string(upImpl->mFrameOffsets.size()) + " frames.", Priority::High);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    DatumRecording::DatumRecording(const std::string& filePath) :
+        upImpl{new ImplDatumRecording{}}
+    {
+        try
+        {
+            // Map file (copy-on-write, so the frames can be modified, e.g. by rendering, without touching the file)
+            upImpl->upMemoryMappedFile.reset(new MemoryMappedFile{filePath, true});
+            upImpl->mDataPtr = upImpl->upMemoryMappedFile->getPtr();
+            upImpl->mFileSize = upImpl->upMemoryMappedFile->getSize();
+            // Header
+            if (upImpl->mFileSize < RECORDING_HEADER_SIZE
+                || std::memcmp(upImpl->mDataPtr, RECORDING_MAGIC, sizeof(RECORDING_MAGIC)) != 0)
+                error("File is not an OpenPose Datum recording: " + filePath, __LINE__, __FUNCTION__, __FILE__);
+            RecordingCursor cursor{upImpl->mDataPtr, upImpl->mFileSize, sizeof(RECORDING_MAGIC)};
+            const auto* const versionAndFlags = (const unsigned int*)cursor.readBytes(2*sizeof(unsigned int));
+            if (versionAndFlags[0] != RECORDING_VERSION)
+                error("Unsupported recording version: " + std::to_string(versionAndFlags[0]),
+                      __LINE__, __FUNCTION__, __FILE__);
+            upImpl->mFlags = versionAndFlags[1];
+            upImpl->mNumberFrames = cursor.readValue<unsigned long long>();
+            const auto indexOffset = cursor.readValue<unsigned long long>();
+            if (indexOffset == 0ull)
+                error("The recording was not properly closed (no frame index): " + filePath,
+                      __LINE__, __FUNCTION__, __FILE__);
+            // Index
+            RecordingCursor indexCursor{upImpl->mDataPtr, upImpl->mFileSize, indexOffset};
+            upImpl->mFrameOffsetsPtr = (const unsigned long long*)indexCursor.readBytes(
+                upImpl->mNumberFrames * sizeof(unsigned long long)
+            );
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    DatumRecording::~DatumRecording()
+    {
+    }
+
+    unsigned long long DatumRecording::getNumberFrames() const
+    {
+        return upImpl->mNumberFrames;
+    }
+
+    bool DatumRecording::hasHeatMaps() const
+    {
+        return (upImpl->mFlags & RECORDING_FLAG_HEAT_MAPS) != 0u;
+    }
+
+    void DatumRecording::getFrame(RecordedFrame& recordedFrame, const unsigned long long frameIndex) const
+    {
+        try
+        {
+            if (frameIndex >= upImpl->mNumberFrames)
+                error("Frame index out of bounds (" + std::to_string(frameIndex) + " vs. "
+                      + std::to_string(upImpl->mNumberFrames) + " frames).", __LINE__, __FUNCTION__, __FILE__);
+            RecordingCursor cursor{upImpl->mDataPtr, upImpl->mFileSize, upImpl->mFrameOffsetsPtr[frameIndex]};
+            recordedFrame.id = cursor.readValue<unsigned long long>();
+            recordedFrame.timestampNs = cursor.readValue<long long>();
+            recordedFrame.name = cursor.readString();
+            recordedFrame.cvInputData = cursor.readCvMat();
+            recordedFrame.scaleInputToNetInputs.resize(cursor.readValue<unsigned long long>());
+            const auto numberScalesBytes = recordedFrame.scaleInputToNetInputs.size() * sizeof(double);
+            std::memcpy(recordedFrame.scaleInputToNetInputs.data(), cursor.readBytes(numberScalesBytes),
+                        numberScalesBytes);
+            recordedFrame.netInputSizes.resize(cursor.readValue<unsigned long long>());
+            for (auto& netInputSize : recordedFrame.netInputSizes)
+            {
+                const auto* const sizePtr = (const int*)cursor.readBytes(2*sizeof(int));
+                netInputSize = Point<int>{sizePtr[0], sizePtr[1]};
+            }
+            recordedFrame.scaleInputToOutput = cursor.readValue<double>();
+            const auto* const netOutputSizePtr = (const int*)cursor.readBytes(2*sizeof(int));
+            recordedFrame.netOutputSize = Point<int>{netOutputSizePtr[0], netOutputSizePtr[1]};
+            recordedFrame.scaleNetToOutput = cursor.readValue<double>();
+            recordedFrame.poseKeypoints = cursor.readArray();
+            recordedFrame.poseScores = cursor.readArray();
+            recordedFrame.poseHeatMaps = cursor.readArray();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+}
@@ -3,6 +3,7 @@
 namespace op
 {
     DEFINE_TEMPLATE_DATUM(WCocoJsonSaver);
+    DEFINE_TEMPLATE_DATUM(WDatumRecorder);
     DEFINE_TEMPLATE_DATUM(WFaceSaver);
     DEFINE_TEMPLATE_DATUM(WHandSaver);
     DEFINE_TEMPLATE_DATUM(WHeatMapSaver);
@@ -123,6 +123,11 @@ namespace op
         }
     }
 
+    // Person id tracking: minimum average pose keypoint score of a person to look for its hands, and maximum
+    // number of frames a hand rectangle is reused when its arm keypoints are missed
+    const auto MIN_PERSON_SCORE = 0.1f;
+    const auto MAX_FRAMES_HAND_REUSED = 3ull;
+
     HandDetector::HandDetector(const PoseModel poseModel) :
         // Parentheses instead of braces to avoid error in GCC 4.8
         mPoseIndexes(getPoseKeypoints(poseModel, {"LWrist", "LElbow", "LShoulder", "RWrist", "RElbow", "RShoulder"})),
@@ -161,18 +166,54 @@ namespace op
         }
     }
 
-    std::vector<std::array<Rectangle<float>, 2>> HandDetector::trackHands(const Array<float>& poseKeypoints, const double scaleInputToOutput)
+    std::vector<std::array<Rectangle<float>, 2>> HandDetector::trackHands(const Array<float>& poseKeypoints, const double scaleInputToOutput,
+                                                                          const Array<long long>& poseIds,
+                                                                          const unsigned long long id)
     {
         try
         {
             std::lock_guard<std::mutex> lock{mMutex};
             // Baseline detectHands
             auto handRectangles = detectHands(poseKeypoints, scaleInputToOutput);
+            // Person ids: previous hands of the same person
+            if (!poseIds.empty() && poseIds.getSize(0) == (int)handRectangles.size())
+            {
+                const auto currentId = fastMax(id, mCurrentId);
+                for (auto person = 0u ; person < handRectangles.size() ; person++)
+                {
+                    // Low-confidence people skipped
+                    if (getAverageScore(poseKeypoints, person) < MIN_PERSON_SCORE)
+                    {
+                        handRectangles[person] = std::array<Rectangle<float>, 2>();
+                        continue;
+                    }
+                    const auto handsPrevious = mHandsPreviousById.find(poseIds[person]);
+                    if (handsPrevious != mHandsPreviousById.end())
+                    {
+                        for (auto hand = 0 ; hand < 2 ; hand++)
+                        {
+                            // Each hand ages on its own (e.g., one hand occluded while the other one is found)
+                            const auto& handPrevious = handsPrevious->second[hand];
+                            if (handPrevious.first.area() <= 0
+                                || handPrevious.second + MAX_FRAMES_HAND_REUSED < currentId)
+                                continue;
+                            // Arm keypoints missed -> previous rectangle
+                            if (handRectangles[person][hand].area() <= 0)
+                                handRectangles[person][hand] = handPrevious.first;
+                            else
+                                trackHand(handRectangles[person][hand], {handPrevious.first});
+                        }
+                    }
+                }
+            }
             // If previous hands saved
-            for (auto& handRectangle : handRectangles)
+            else
             {
-                trackHand(handRectangle[0], mHandLeftPrevious);
-                trackHand(handRectangle[1], mHandRightPrevious);
+                for (auto& handRectangle : handRectangles)
+                {
+                    trackHand(handRectangle[0], mHandLeftPrevious);
+                    trackHand(handRectangle[1], mHandRightPrevious);
+                }
             }
             // Return result
             return handRectangles;
@@ -184,7 +225,8 @@ namespace op
         }
     }
 
-    void HandDetector::updateTracker(const std::array<Array<float>, 2>& handKeypoints, const unsigned long long id)
+    void HandDetector::updateTracker(const std::array<Array<float>, 2>& handKeypoints, const unsigned long long id,
+                                     const Array<long long>& poseIds)
     {
         try
         {
@@ -199,9 +241,9 @@ namespace op
                 mPoseTrack.resize(numberPeople);
                 mHandLeftPrevious.clear();
                 mHandRightPrevious.clear();
+                const auto scoreThreshold = 0.66667f;
                 for (auto person = 0u ; person < mPoseTrack.size() ; person++)
                 {
-                    const auto scoreThreshold = 0.66667f;
                     // Left hand
                     if (getAverageScore(handKeypoints[0], person) > scoreThreshold)
                     {
@@ -217,6 +259,32 @@ namespace op
                             mHandRightPrevious.emplace_back(handRightRectangle);
                     }
                 }
+                // Person ids: only the hands found are updated (the other one keeps its rectangle and frame id)
+                if (!poseIds.empty() && poseIds.getSize(0) == numberPeople)
+                {
+                    for (auto person = 0 ; person < numberPeople ; person++)
+                    {
+                        for (auto hand = 0 ; hand < 2 ; hand++)
+                        {
+                            if (getAverageScore(handKeypoints[hand], person) > scoreThreshold)
+                            {
+                                const auto handRectangle = getKeypointsRectangle(handKeypoints[hand], person,
+                                                                                 thresholdRectangle);
+                                if (handRectangle.area() > 0)
+                                    mHandsPreviousById[poseIds[person]][hand] = std::make_pair(handRectangle, id);
+                            }
+                        }
+                    }
+                }
+                // People whose both hands were not found lately are removed
+                for (auto handsPrevious = mHandsPreviousById.begin() ; handsPrevious != mHandsPreviousById.end() ; )
+                {
+                    if (handsPrevious->second[0].second + MAX_FRAMES_HAND_REUSED < id
+                        && handsPrevious->second[1].second + MAX_FRAMES_HAND_REUSED < id)
+                        handsPrevious = mHandsPreviousById.erase(handsPrevious);
+                    else
+                        handsPrevious++;
+                }
             }
         }
         catch (const std::exception& e)
@@ -9,7 +9,8 @@ namespace op
     void connectBodyPartsCpu(Array<T>& poseKeypoints, Array<T>& poseScores, const T* const heatMapPtr,
                              const T* const peaksPtr, const PoseModel poseModel, const Point<int>& heatMapSize,
                              const int maxPeaks, const T interMinAboveThreshold, const T interThreshold,
-                             const int minSubsetCnt, const T minSubsetScore, const T scaleFactor)
+                             const int minSubsetCnt, const T minSubsetScore, const T scaleFactor,
+                             const int* const peakOwnersPtr)
     {
         try
         {
@@ -136,10 +137,17 @@ namespace op
                     std::vector<std::tuple<double, int, int>> temp;
                     const auto* mapX = heatMapPtr + mapIdx[2*pairIndex] * heatMapOffset;
                     const auto* mapY = heatMapPtr + mapIdx[2*pairIndex+1] * heatMapOffset;
+                    const auto* const ownersAPtr = (peakOwnersPtr != nullptr
+                                                    ? peakOwnersPtr + bodyPartA*(maxPeaks+1) : nullptr);
+                    const auto* const ownersBPtr = (peakOwnersPtr != nullptr
+                                                    ? peakOwnersPtr + bodyPartB*(maxPeaks+1) : nullptr);
                     for (auto i = 1; i <= numberA; i++)
                     {
                         for (auto j = 1; j <= numberB; j++)
                         {
+                            // Local peak search: only the limbs of each tracked person
+                            if (peakOwnersPtr != nullptr && ownersAPtr[i] != ownersBPtr[j])
+                                continue;
                             const auto vectorAToBX = candidateBPtr[j*3] - candidateAPtr[i*3];
                             const auto vectorAToBY = candidateBPtr[j*3+1] - candidateAPtr[i*3+1];
                             const auto vectorAToBMax = fastMax(std::abs(vectorAToBX), std::abs(vectorAToBY));
@@ -356,11 +364,13 @@ namespace op
                                       const PoseModel poseModel, const Point<int>& heatMapSize,
                                       const int maxPeaks, const float interMinAboveThreshold,
                                       const float interThreshold, const int minSubsetCnt,
-                                      const float minSubsetScore, const float scaleFactor);
+                                      const float minSubsetScore, const float scaleFactor,
+                                      const int* const peakOwnersPtr);
     template void connectBodyPartsCpu(Array<double>& poseKeypoints, Array<double>& poseScores,
                                       const double* const heatMapPtr, const double* const peaksPtr,
                                       const PoseModel poseModel, const Point<int>& heatMapSize,
                                       const int maxPeaks, const double interMinAboveThreshold,
                                       const double interThreshold, const int minSubsetCnt,
-                                      const double minSubsetScore, const double scaleFactor);
+                                      const double minSubsetScore, const double scaleFactor,
+                                      const int* const peakOwnersPtr);
 }
@@ -7,7 +7,8 @@
 namespace op
 {
     template <typename T>
-    BodyPartConnectorCaffe<T>::BodyPartConnectorCaffe()
+    BodyPartConnectorCaffe<T>::BodyPartConnectorCaffe() :
+        mPeakOwnersPtr{nullptr}
     {
         try
         {
@@ -156,6 +157,19 @@ namespace op
         }
     }
 
+    template <typename T>
+    void BodyPartConnectorCaffe<T>::setPeakOwners(const int* const peakOwnersPtr)
+    {
+        try
+        {
+            mPeakOwnersPtr = {peakOwnersPtr};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
     template <typename T>
     void BodyPartConnectorCaffe<T>::Forward_cpu(const std::vector<caffe::Blob<T>*>& bottom, Array<T>& poseKeypoints,
                                                 Array<T>& poseScores)
@@ -170,7 +184,7 @@ namespace op
                 connectBodyPartsCpu(poseKeypoints, poseScores, heatMapsPtr, peaksPtr, mPoseModel,
                                     Point<int>{heatMapsBlob->shape(3), heatMapsBlob->shape(2)},
                                     maxPeaks, mInterMinAboveThreshold, mInterThreshold,
-                                    mMinSubsetCnt, mMinSubsetScore, mScaleNetToOutput);
+                                    mMinSubsetCnt, mMinSubsetScore, mScaleNetToOutput, mPeakOwnersPtr);
             #else
                 UNUSED(bottom);
                 UNUSED(poseKeypoints);
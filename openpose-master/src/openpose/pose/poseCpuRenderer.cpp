@@ -8,14 +8,16 @@ namespace op
                                      const bool blendOriginalFrame, const float alphaKeypoint,
                                      const float alphaHeatMap) :
         Renderer{renderThreshold, alphaKeypoint, alphaHeatMap, blendOriginalFrame},
-        PoseRenderer{poseModel}
+        PoseRenderer{poseModel},
+        mTrainPersonIds{{-1ll, -1ll}}
     {
     }
 
     std::pair<int, std::string> PoseCpuRenderer::renderPose(Array<float>& outputData,
                                                             const Array<float>& poseKeypoints,
                                                             const float scaleInputToOutput,
-                                                            const float scaleNetToOutput)
+                                                            const float scaleNetToOutput,
+                                                            const Array<long long>& poseIds)
     {
         try
         {
@@ -33,7 +35,7 @@ namespace op
                 scaleKeypoints(poseKeypointsRescaled, scaleInputToOutput);
                 // Render keypoints
                 renderPoseKeypointsCpu(outputData, poseKeypointsRescaled, mPoseModel, mRenderThreshold,
-                                       mBlendOriginalFrame);
+                                       mBlendOriginalFrame, poseIds, &mTrainPersonIds);
             }
             // Draw heat maps / PAFs
             else
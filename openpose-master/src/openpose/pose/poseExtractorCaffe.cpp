@@ -1,14 +1,20 @@
 #ifdef USE_CAFFE
+    #include <algorithm> // std::max_element
+    #include <thread> // std::thread::hardware_concurrency
     #include <caffe/blob.hpp>
 #endif
 #include <openpose/core/netCaffe.hpp>
+#include <openpose/core/nmsBase.hpp>
 #include <openpose/core/nmsCaffe.hpp>
 #include <openpose/core/resizeAndMergeCaffe.hpp>
 #include <openpose/pose/bodyPartConnectorCaffe.hpp>
 #include <openpose/pose/poseParameters.hpp>
+#include <openpose/thread/taskPool.hpp>
 #include <openpose/utilities/check.hpp>
 #include <openpose/utilities/cuda.hpp>
 #include <openpose/utilities/fastMath.hpp>
+#include <openpose/utilities/fileSystem.hpp>
+#include <openpose/utilities/keypoint.hpp>
 #include <openpose/utilities/openCv.hpp>
 #include <openpose/utilities/standard.hpp>
 #include <openpose/pose/poseExtractorCaffe.hpp>
@@ -23,6 +29,14 @@ namespace op
             const int mGpuId;
             const std::string mModelFolder;
             const bool mEnableGoogleLogging;
+            const int mIntraOpThreads;
+            const bool mInt8Inference;
+            const int mEarlyExitStage;
+            const float mEarlyExitThreshold;
+            const int mInterOpThreads;
+            const int mLocalPeakSearchInterval;
+            const int mTileSize;
+            const int mTileOverlap;
             // General parameters
             std::vector<std::shared_ptr<NetCaffe>> spCaffeNets;
             std::shared_ptr<ResizeAndMergeCaffe<float>> spResizeAndMergeCaffe;
@@ -35,16 +49,38 @@ namespace op
             std::shared_ptr<caffe::Blob<float>> spHeatMapsBlob;
             std::shared_ptr<caffe::Blob<float>> spPeaksBlob;
             std::shared_ptr<caffe::Blob<float>> spPoseBlob;
+            // Local peak search
+            int mFramesSinceGlobalSearch;
+            Array<float> mTrackedKeypoints;
+            Point<int> mTrackedHeatMapSize;
+            std::vector<std::vector<Rectangle<int>>> mPeakWindows;
+            std::vector<int> mPeakOwners;
+            // Tiled inference (per scale)
+            std::vector<std::shared_ptr<caffe::Blob<float>>> spTiledOutputBlobs;
+            std::vector<Array<float>> mTileInputs;
+            std::vector<std::vector<float>> mTileWeights;
 
             ImplPoseExtractorCaffe(const PoseModel poseModel, const int gpuId,
-                                   const std::string& modelFolder, const bool enableGoogleLogging) :
+                                   const std::string& modelFolder, const bool enableGoogleLogging,
+                                   const int intraOpThreads, const bool int8Inference, const int earlyExitStage,
+                                   const float earlyExitThreshold, const int interOpThreads,
+                                   const int localPeakSearchInterval, const int tileSize, const int tileOverlap) :
                 mPoseModel{poseModel},
                 mGpuId{gpuId},
                 mModelFolder{modelFolder},
                 mEnableGoogleLogging{enableGoogleLogging},
+                mIntraOpThreads{intraOpThreads},
+                mInt8Inference{int8Inference},
+                mEarlyExitStage{earlyExitStage},
+                mEarlyExitThreshold{earlyExitThreshold},
+                mInterOpThreads{interOpThreads},
+                mLocalPeakSearchInterval{localPeakSearchInterval},
+                mTileSize{tileSize},
+                mTileOverlap{tileOverlap},
                 spResizeAndMergeCaffe{std::make_shared<ResizeAndMergeCaffe<float>>()},
                 spNmsCaffe{std::make_shared<NmsCaffe<float>>()},
-                spBodyPartConnectorCaffe{std::make_shared<BodyPartConnectorCaffe<float>>()}
+                spBodyPartConnectorCaffe{std::make_shared<BodyPartConnectorCaffe<float>>()},
+                mFramesSinceGlobalSearch{0}
             {
             }
         #endif
@@ -72,7 +108,7 @@ namespace op
         inline void reshapePoseExtractorCaffe(std::shared_ptr<ResizeAndMergeCaffe<float>>& resizeAndMergeCaffe,
                                               std::shared_ptr<NmsCaffe<float>>& nmsCaffe,
                                               std::shared_ptr<BodyPartConnectorCaffe<float>>& bodyPartConnectorCaffe,
-                                              std::vector<boost::shared_ptr<caffe::Blob<float>>>& caffeNetOutputBlob,
+                                              const std::vector<caffe::Blob<float>*>& caffeNetOutputBlobs,
                                               std::shared_ptr<caffe::Blob<float>>& heatMapsBlob,
                                               std::shared_ptr<caffe::Blob<float>>& peaksBlob,
                                               std::shared_ptr<caffe::Blob<float>>& poseBlob,
@@ -82,7 +118,6 @@ namespace op
             try
             {
                 // HeatMaps extractor blob and layer
-                const auto caffeNetOutputBlobs = caffeNetSharedToPtr(caffeNetOutputBlob);
                 resizeAndMergeCaffe->Reshape(caffeNetOutputBlobs, {heatMapsBlob.get()},
                                              getPoseNetDecreaseFactor(poseModel), 1.f/scaleInputToNetInput);
                 // Pose extractor blob and layer
@@ -100,18 +135,269 @@ namespace op
             }
         }
 
+        // Mean over the body part heat maps of their maximum value
+        float getMeanBodyPartPeak(caffe::Blob<float>& caffeNetOutputBlob, const PoseModel poseModel)
+        {
+            try
+            {
+                const auto numberBodyParts = (int)getPoseNumberBodyParts(poseModel);
+                const auto channelArea = caffeNetOutputBlob.shape(2) * caffeNetOutputBlob.shape(3);
+                const auto* heatMapPtr = caffeNetOutputBlob.cpu_data();
+                auto peakSum = 0.f;
+                for (auto part = 0 ; part < numberBodyParts ; part++)
+                {
+                    const auto* partHeatMapPtr = heatMapPtr + part * channelArea;
+                    peakSum += *std::max_element(partHeatMapPtr, partHeatMapPtr + channelArea);
+                }
+                return (numberBodyParts > 0 ? peakSum / numberBodyParts : 0.f);
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return 0.f;
+            }
+        }
+
+        // Whether a net input of this size is processed by tiles
+        inline bool useTiles(const std::vector<int>& netInputSize, const int tileSize)
+        {
+            return (tileSize > 0 && (netInputSize[2] > tileSize || netInputSize[3] > tileSize));
+        }
+
+        // Tile origins along one dimension: multiples of 16 (as the net input sizes, so they are aligned with the
+        // net output) evenly spread, so consecutive tiles overlap about tileOverlap pixels (at least
+        // tileOverlap - 16)
+        std::vector<int> getTileOrigins(const int size, const int tileSize, const int tileOverlap)
+        {
+            try
+            {
+                if (size <= tileSize)
+                    return {0};
+                const auto numberTiles = (size - tileOverlap + tileSize - tileOverlap - 1) / (tileSize - tileOverlap);
+                std::vector<int> tileOrigins(numberTiles);
+                for (auto tile = 0 ; tile < numberTiles ; tile++)
+                    tileOrigins[tile] = 16 * intRound(tile * (size - tileSize) / (16.f * (numberTiles - 1)));
+                return tileOrigins;
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+                return {};
+            }
+        }
+
+        // Blending weights of a tile along one dimension (net output pixels): linear ramps over the overlaps with
+        // the previous and next tiles, so the weights of overlapping tiles add up to 1
+        void getTileWeights(std::vector<float>& tileWeights, const std::vector<int>& tileOrigins, const int tile,
+                            const int tileSize, const int decreaseFactor)
+        {
+            try
+            {
+                const auto tileOutputSize = tileSize / decreaseFactor;
+                const auto previousOverlap = (tile > 0
+                    ? (tileOrigins[tile-1] + tileSize - tileOrigins[tile]) / decreaseFactor : 0);
+                const auto nextOverlap = (tile + 1 < (int)tileOrigins.size()
+                    ? (tileOrigins[tile] + tileSize - tileOrigins[tile+1]) / decreaseFactor : 0);
+                tileWeights.resize(tileOutputSize);
+                for (auto i = 0 ; i < tileOutputSize ; i++)
+                {
+                    auto weight = 1.f;
+                    if (previousOverlap > 0)
+                        weight = fastMin(weight, (i + 0.5f) / previousOverlap);
+                    if (nextOverlap > 0)
+                        weight = fastMin(weight, (tileOutputSize - i - 0.5f) / nextOverlap);
+                    tileWeights[i] = weight;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        // Tiled inference: the net is run on overlapping tiles of the net input (so its memory only depends on the
+        // tile size), and their outputs are blended into tiledOutputBlob (same size than the net output of the
+        // whole net input)
+        void forwardPassTiled(NetCaffe& netCaffe, caffe::Blob<float>& netOutputBlob,
+                              caffe::Blob<float>& tiledOutputBlob, Array<float>& tileInput,
+                              std::vector<float>& outputWeights, const Array<float>& inputNetData,
+                              const int tileSize, const int tileOverlap, const float earlyExitThreshold,
+                              const PoseModel poseModel)
+        {
+            try
+            {
+                const auto height = inputNetData.getSize(2);
+                const auto width = inputNetData.getSize(3);
+                const auto tileHeight = fastMin(tileSize, height);
+                const auto tileWidth = fastMin(tileSize, width);
+                const auto tileOriginsY = getTileOrigins(height, tileHeight, tileOverlap);
+                const auto tileOriginsX = getTileOrigins(width, tileWidth, tileOverlap);
+                const auto decreaseFactor = intRound(getPoseNetDecreaseFactor(poseModel));
+                const auto outputHeight = height / decreaseFactor;
+                const auto outputWidth = width / decreaseFactor;
+                const auto outputArea = outputHeight * outputWidth;
+                const std::vector<int> tileInputSize{1, 3, tileHeight, tileWidth};
+                if (!vectorsAreEqual(tileInput.getSize(), tileInputSize))
+                    tileInput.reset(tileInputSize);
+                outputWeights.assign(outputArea, 0.f);
+                std::vector<float> tileWeightsY;
+                std::vector<float> tileWeightsX;
+                for (auto tileY = 0 ; tileY < (int)tileOriginsY.size() ; tileY++)
+                {
+                    getTileWeights(tileWeightsY, tileOriginsY, tileY, tileHeight, decreaseFactor);
+                    for (auto tileX = 0 ; tileX < (int)tileOriginsX.size() ; tileX++)
+                    {
+                        getTileWeights(tileWeightsX, tileOriginsX, tileX, tileWidth, decreaseFactor);
+                        // Tile of the net input
+                        const auto originY = tileOriginsY[tileY];
+                        const auto originX = tileOriginsX[tileX];
+                        for (auto channel = 0 ; channel < 3 ; channel++)
+                            for (auto y = 0 ; y < tileHeight ; y++)
+                            {
+                                const auto* const sourceRow = inputNetData.getConstPtr()
+                                                            + (channel*height + originY + y)*width + originX;
+                                std::copy(sourceRow, sourceRow + tileWidth,
+                                          tileInput.getPtr() + (channel*tileHeight + y)*tileWidth);
+                            }
+                        // Forward pass
+                        netCaffe.forwardPass(tileInput);
+                        if (earlyExitThreshold > 0.f
+                            && getMeanBodyPartPeak(netOutputBlob, poseModel) < earlyExitThreshold)
+                            netCaffe.forwardPassRemaining();
+                        // Security checks
+                        const auto channels = netOutputBlob.shape(1);
+                        const auto tileOutputHeight = netOutputBlob.shape(2);
+                        const auto tileOutputWidth = netOutputBlob.shape(3);
+                        if (tileOutputHeight * decreaseFactor != tileHeight
+                            || tileOutputWidth * decreaseFactor != tileWidth)
+                            error("Tiled inference requires a net output " + std::to_string(decreaseFactor)
+                                  + " times smaller than its input.", __LINE__, __FUNCTION__, __FILE__);
+                        // First tile: output of the whole net input
+                        if (tileY == 0 && tileX == 0)
+                        {
+                            tiledOutputBlob.Reshape({1, channels, outputHeight, outputWidth});
+                            std::fill(tiledOutputBlob.mutable_cpu_data(),
+                                      tiledOutputBlob.mutable_cpu_data() + tiledOutputBlob.count(), 0.f);
+                        }
+                        // Weighted accumulation
+                        const auto* const tileOutputPtr = netOutputBlob.cpu_data();
+                        auto* const outputPtr = tiledOutputBlob.mutable_cpu_data();
+                        const auto outputOffset = (originY / decreaseFactor) * outputWidth + originX / decreaseFactor;
+                        for (auto channel = 0 ; channel < channels ; channel++)
+                            for (auto y = 0 ; y < tileOutputHeight ; y++)
+                            {
+                                const auto* const tileRow = tileOutputPtr
+                                                          + (channel*tileOutputHeight + y)*tileOutputWidth;
+                                auto* const outputRow = outputPtr + channel*outputArea + outputOffset
+                                                      + y*outputWidth;
+                                for (auto x = 0 ; x < tileOutputWidth ; x++)
+                                    outputRow[x] += tileWeightsY[y] * tileWeightsX[x] * tileRow[x];
+                            }
+                        for (auto y = 0 ; y < tileOutputHeight ; y++)
+                            for (auto x = 0 ; x < tileOutputWidth ; x++)
+                                outputWeights[outputOffset + y*outputWidth + x] += tileWeightsY[y] * tileWeightsX[x];
+                    }
+                }
+                // Normalization (weights add up to 1 unless more than 2 tiles overlap along a dimension)
+                auto* const outputPtr = tiledOutputBlob.mutable_cpu_data();
+                for (auto channel = 0 ; channel < tiledOutputBlob.shape(1) ; channel++)
+                    for (auto i = 0 ; i < outputArea ; i++)
+                        if (outputWeights[i] > 0.f)
+                            outputPtr[channel*outputArea + i] /= outputWeights[i];
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
+        // Local peak search windows (heat map coordinates), one per tracked person (same index in all the body
+        // parts, so it identifies the peak owner): around the previous joint location, or the padded person box if
+        // that joint was not detected
+        void setLocalPeakSearchWindows(std::vector<std::vector<Rectangle<int>>>& peakWindows,
+                                       const Array<float>& trackedKeypoints, const Point<int>& heatMapSize)
+        {
+            try
+            {
+                const auto minRadius = 8.f;
+                const auto radiusRatio = 0.2f;
+                const auto numberPeople = trackedKeypoints.getSize(0);
+                const auto numberBodyParts = trackedKeypoints.getSize(1);
+                peakWindows.resize(numberBodyParts);
+                for (auto& bodyPartWindows : peakWindows)
+                    bodyPartWindows.resize(numberPeople);
+                for (auto person = 0 ; person < numberPeople ; person++)
+                {
+                    const auto personRectangle = getKeypointsRectangle(trackedKeypoints, person, 0.f);
+                    const auto radius = fastMax(minRadius,
+                                                radiusRatio * fastMax(personRectangle.width, personRectangle.height));
+                    const Rectangle<int> personWindow{
+                        fastTruncate(intRound(personRectangle.x - radius), 0, heatMapSize.x),
+                        fastTruncate(intRound(personRectangle.y - radius), 0, heatMapSize.y),
+                        intRound(personRectangle.width + 2*radius), intRound(personRectangle.height + 2*radius)
+                    };
+                    for (auto part = 0 ; part < numberBodyParts ; part++)
+                    {
+                        const auto baseIndex = trackedKeypoints.getSize(2)*(person*numberBodyParts + part);
+                        if (trackedKeypoints[baseIndex+2] > 0.f)
+                            peakWindows[part][person] = Rectangle<int>{
+                                intRound(trackedKeypoints[baseIndex] - radius),
+                                intRound(trackedKeypoints[baseIndex+1] - radius),
+                                intRound(2*radius)+1, intRound(2*radius)+1
+                            };
+                        else
+                            peakWindows[part][person] = personWindow;
+                    }
+                }
+            }
+            catch (const std::exception& e)
+            {
+                error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+
         void addCaffeNetOnThread(std::vector<std::shared_ptr<NetCaffe>>& netCaffe,
                                  std::vector<boost::shared_ptr<caffe::Blob<float>>>& caffeNetOutputBlob,
                                  const PoseModel poseModel, const int gpuId,
-                                 const std::string& modelFolder, const bool enableGoogleLogging)
+                                 const std::string& modelFolder, const bool enableGoogleLogging,
+                                 const int intraOpThreads, const bool int8Inference, const int earlyExitStage,
+                                 const int interOpThreads)
         {
             try
             {
+                // Early exit: the net output is taken from the stage earlyExitStage (the remaining stages are only run
+                // on demand)
+                std::vector<std::string> earlyExitBlobNames;
+                const auto numberStages = (int)getPoseNumberStages(poseModel);
+                if (earlyExitStage > 0)
+                {
+                    if (numberStages == 0)
+                        error("Early exit is not available for this pose model (unknown number of stages).",
+                              __LINE__, __FUNCTION__, __FILE__);
+                    if (earlyExitStage < numberStages)
+                        earlyExitBlobNames = getPoseStageOutputBlobs(poseModel, earlyExitStage);
+                }
+                // INT8-calibrated weights: same name with the `_int8` suffix
+                auto caffeTrainedModel = modelFolder + getPoseTrainedModel(poseModel);
+                if (int8Inference)
+                {
+                    const std::string extension{".caffemodel"};
+                    const auto extensionPosition = caffeTrainedModel.rfind(extension);
+                    if (extensionPosition == std::string::npos)
+                        error("Trained model without .caffemodel extension: " + caffeTrainedModel + ".",
+                              __LINE__, __FUNCTION__, __FILE__);
+                    caffeTrainedModel.insert(extensionPosition, "_int8");
+                    if (!existFile(caffeTrainedModel))
+                        error("INT8 inference requires the INT8-calibrated model " + caffeTrainedModel + " (the"
+                              " trained model with the `_int8` suffix). Generate it with"
+                              " examples/tests/int8Calibration.cpp or disable the INT8 inference.",
+                              __LINE__, __FUNCTION__, __FILE__);
+                }
                 // Add Caffe Net
                 netCaffe.emplace_back(
-                    std::make_shared<NetCaffe>(modelFolder + getPoseProtoTxt(poseModel),
-                                               modelFolder + getPoseTrainedModel(poseModel),
-                                               gpuId, enableGoogleLogging)
+                    std::make_shared<NetCaffe>(modelFolder + getPoseProtoTxt(poseModel), caffeTrainedModel,
+                                               gpuId, enableGoogleLogging, "net_output", true, intraOpThreads,
+                                               earlyExitBlobNames, interOpThreads)
                 );
                 // Initializing them on the thread
                 netCaffe.back()->initializationOnThread();
@@ -133,10 +419,16 @@ namespace op
 
     PoseExtractorCaffe::PoseExtractorCaffe(const PoseModel poseModel, const std::string& modelFolder,
                                            const int gpuId, const std::vector<HeatMapType>& heatMapTypes,
-                                           const ScaleMode heatMapScale, const bool enableGoogleLogging) :
+                                           const ScaleMode heatMapScale, const bool enableGoogleLogging,
+                                           const int intraOpThreads, const bool int8Inference,
+                                           const int earlyExitStage, const float earlyExitThreshold,
+                                           const int interOpThreads, const int localPeakSearchInterval,
+                                           const int tileSize, const int tileOverlap) :
         PoseExtractor{poseModel, heatMapTypes, heatMapScale}
         #ifdef USE_CAFFE
-        , upImpl{new ImplPoseExtractorCaffe{poseModel, gpuId, modelFolder, enableGoogleLogging}}
+        , upImpl{new ImplPoseExtractorCaffe{poseModel, gpuId, modelFolder, enableGoogleLogging, intraOpThreads,
+                                            int8Inference, earlyExitStage, earlyExitThreshold, interOpThreads,
+                                            localPeakSearchInterval, tileSize, tileOverlap}}
         #endif
     {
         try
@@ -144,12 +436,44 @@ namespace op
             #ifdef USE_CAFFE
                 // Layers parameters
                 upImpl->spBodyPartConnectorCaffe->setPoseModel(mPoseModel);
+                // Early exit
+                if (earlyExitStage < 0)
+                    error("The early exit stage must be >= 0.", __LINE__, __FUNCTION__, __FILE__);
+                if (earlyExitStage > 0)
+                    log("Pose network early exit at stage " + std::to_string(earlyExitStage)
+                        + (earlyExitThreshold > 0.f
+                            ? " (remaining stages if the mean body part peak is below "
+                              + std::to_string(earlyExitThreshold) + ")."
+                            : "."), Priority::High);
+                // Local peak search
+                if (localPeakSearchInterval < 0)
+                    error("The local peak search interval must be >= 0.", __LINE__, __FUNCTION__, __FILE__);
+                // Tiled inference
+                if (tileSize < 0 || tileSize % 16 != 0)
+                    error("The tile size must be >= 0 and a multiple of 16.", __LINE__, __FUNCTION__, __FILE__);
+                if (tileSize > 0)
+                {
+                    if (tileOverlap < 0 || tileOverlap % 16 != 0 || tileOverlap >= tileSize)
+                        error("The tile overlap must be >= 0, a multiple of 16 and smaller than the tile size.",
+                              __LINE__, __FUNCTION__, __FILE__);
+                    log("Tiled inference for net inputs larger than " + std::to_string(tileSize) + "x"
+                        + std::to_string(tileSize) + " (overlap: " + std::to_string(tileOverlap) + ").",
+                        Priority::High);
+                }
             #else
                 UNUSED(poseModel);
                 UNUSED(modelFolder);
                 UNUSED(gpuId);
                 UNUSED(heatMapTypes);
                 UNUSED(heatMapScale);
+                UNUSED(intraOpThreads);
+                UNUSED(int8Inference);
+                UNUSED(earlyExitStage);
+                UNUSED(earlyExitThreshold);
+                UNUSED(interOpThreads);
+                UNUSED(localPeakSearchInterval);
+                UNUSED(tileSize);
+                UNUSED(tileOverlap);
                 error("OpenPose must be compiled with the `USE_CAFFE` macro definition in order to use this"
                       " functionality.", __LINE__, __FUNCTION__, __FILE__);
             #endif
@@ -173,7 +497,9 @@ namespace op
                 log("Starting initialization on thread.", Priority::Low, __LINE__, __FUNCTION__, __FILE__);
                 // Initialize Caffe net
                 addCaffeNetOnThread(upImpl->spCaffeNets, upImpl->spCaffeNetOutputBlobs, upImpl->mPoseModel,
-                                    upImpl->mGpuId, upImpl->mModelFolder, upImpl->mEnableGoogleLogging);
+                                    upImpl->mGpuId, upImpl->mModelFolder, upImpl->mEnableGoogleLogging,
+                                    upImpl->mIntraOpThreads, upImpl->mInt8Inference, upImpl->mEarlyExitStage,
+                                    upImpl->mInterOpThreads);
                 #ifdef USE_CUDA
                     cudaCheck(__LINE__, __FUNCTION__, __FILE__);
                 #endif
@@ -216,14 +542,66 @@ namespace op
                 upImpl->mNetInput4DSizes.resize(numberScales);
                 while (upImpl->spCaffeNets.size() < numberScales)
                     addCaffeNetOnThread(upImpl->spCaffeNets, upImpl->spCaffeNetOutputBlobs, upImpl->mPoseModel,
-                                        upImpl->mGpuId, upImpl->mModelFolder, false);
+                                        upImpl->mGpuId, upImpl->mModelFolder, false, upImpl->mIntraOpThreads,
+                                        upImpl->mInt8Inference, upImpl->mEarlyExitStage, upImpl->mInterOpThreads);
 
-                // Process each image
+                // Tiled inference buffers
+                while (upImpl->spTiledOutputBlobs.size() < numberScales)
+                    upImpl->spTiledOutputBlobs.emplace_back(std::make_shared<caffe::Blob<float>>(1,1,1,1));
+                upImpl->mTileInputs.resize(numberScales);
+                upImpl->mTileWeights.resize(numberScales);
+
+                // 1. Caffe deep network
+                // CPU: each scale has its own net, so the scales run concurrently (latency of the slowest scale
+                // rather than the sum of all of them), splitting the intra-op threads between them
+                // GPU: sequential, all the nets share the default CUDA stream
+                #ifdef USE_CUDA
+                    const auto concurrentScales = 1;
+                #else
+                    const auto concurrentScales = (int)numberScales;
+                #endif
+                const auto intraOpThreads = (concurrentScales > 1
+                    ? fastMax(1, (upImpl->mIntraOpThreads > 0
+                                  ? upImpl->mIntraOpThreads : (int)std::thread::hardware_concurrency())
+                                 / concurrentScales)
+                    : upImpl->mIntraOpThreads);
+                for (auto i = 0u ; i < numberScales ; i++)
+                    upImpl->spCaffeNets[i]->setIntraOpThreads(intraOpThreads);
+                TaskPool::getInstance().parallelFor(
+                    "poseNetScales", 0, (int)numberScales,
+                    [&](const int scaleBegin, const int scaleEnd)
+                    {
+                        for (auto i = scaleBegin ; i < scaleEnd ; i++)
+                        {
+                            // Tiled inference: the tiles of a scale are sequential (bounded memory)
+                            if (useTiles(inputNetData[i].getSize(), upImpl->mTileSize))
+                            {
+                                forwardPassTiled(*upImpl->spCaffeNets.at(i), *upImpl->spCaffeNetOutputBlobs.at(i),
+                                                 *upImpl->spTiledOutputBlobs.at(i), upImpl->mTileInputs.at(i),
+                                                 upImpl->mTileWeights.at(i), inputNetData[i], upImpl->mTileSize,
+                                                 upImpl->mTileOverlap, upImpl->mEarlyExitThreshold, mPoseModel);
+                                continue;
+                            }
+                            upImpl->spCaffeNets.at(i)->forwardPass(inputNetData[i]);                           // ~80ms
+                            // Adaptive early exit: remaining stages if the early stage is not confident enough
+                            if (upImpl->mEarlyExitThreshold > 0.f
+                                && getMeanBodyPartPeak(*upImpl->spCaffeNetOutputBlobs.at(i), mPoseModel)
+                                    < upImpl->mEarlyExitThreshold)
+                                upImpl->spCaffeNets.at(i)->forwardPassRemaining();
+                        }
+                    },
+                    (int)numberScales / concurrentScales
+                );
+
+                // Net outputs (or their tiled version)
+                auto caffeNetOutputBlobs = caffeNetSharedToPtr(upImpl->spCaffeNetOutputBlobs);
+                for (auto i = 0u ; i < numberScales ; i++)
+                    if (useTiles(inputNetData[i].getSize(), upImpl->mTileSize))
+                        caffeNetOutputBlobs[i] = upImpl->spTiledOutputBlobs[i].get();
+
+                // Blobs shared by all the scales
                 for (auto i = 0u ; i < inputNetData.size(); i++)
                 {
-                    // 1. Caffe deep network
-                    upImpl->spCaffeNets.at(i)->forwardPass(inputNetData[i]);                                   // ~80ms
-
                     // Reshape blobs if required
                     // Note: In order to resize to input size to have same results as Matlab, uncomment the commented
                     // lines
@@ -235,7 +613,7 @@ namespace op
                                                     upImpl->mNetInput4DSizes[0][2]};
                         // upImpl->mScaleInputToNetInputs = scaleInputToNetInputs;
                         reshapePoseExtractorCaffe(upImpl->spResizeAndMergeCaffe, upImpl->spNmsCaffe,
-                                                  upImpl->spBodyPartConnectorCaffe, upImpl->spCaffeNetOutputBlobs,
+                                                  upImpl->spBodyPartConnectorCaffe, caffeNetOutputBlobs,
                                                   upImpl->spHeatMapsBlob, upImpl->spPeaksBlob, upImpl->spPoseBlob,
                                                   1.f, mPoseModel);
                                                   // scaleInputToNetInputs[i], mPoseModel);
@@ -243,7 +621,6 @@ namespace op
                 }
 
                 // 2. Resize heat maps + merge different scales
-                const auto caffeNetOutputBlobs = caffeNetSharedToPtr(upImpl->spCaffeNetOutputBlobs);
                 const std::vector<float> floatScaleRatios(scaleInputToNetInputs.begin(), scaleInputToNetInputs.end());
                 upImpl->spResizeAndMergeCaffe->setScaleRatios(floatScaleRatios);
                 #ifdef USE_CUDA
@@ -251,16 +628,8 @@ namespace op
                                                                {upImpl->spHeatMapsBlob.get()});
                     cudaCheck(__LINE__, __FUNCTION__, __FILE__);
                 #else
-                    error("ResizeAndMergeCaffe CPU version not implemented yet.", __LINE__, __FUNCTION__, __FILE__);
-                #endif
-
-                // 3. Get peaks by Non-Maximum Suppression
-                upImpl->spNmsCaffe->setThreshold((float)get(PoseProperty::NMSThreshold));
-                #ifdef USE_CUDA
-                    upImpl->spNmsCaffe->Forward_gpu({upImpl->spHeatMapsBlob.get()}, {upImpl->spPeaksBlob.get()});// ~2ms
-                    cudaCheck(__LINE__, __FUNCTION__, __FILE__);
-                #else
-                    error("NmsCaffe CPU version not implemented yet.", __LINE__, __FUNCTION__, __FILE__);
+                    upImpl->spResizeAndMergeCaffe->Forward_cpu(caffeNetOutputBlobs,
+                                                               {upImpl->spHeatMapsBlob.get()});
                 #endif
 
                 // Get scale net to output (i.e. image input)
@@ -271,8 +640,8 @@ namespace op
                 mScaleNetToOutput = {(float)resizeGetScaleFactor(netSize, inputDataSize)};
                 // mScaleNetToOutput = 1.f;
 
-                // 4. Connecting body parts
-                // Get scale net to output (i.e. image input)
+                // Body parts connection parameters
+                upImpl->spNmsCaffe->setThreshold((float)get(PoseProperty::NMSThreshold));
                 upImpl->spBodyPartConnectorCaffe->setScaleNetToOutput(mScaleNetToOutput);
                 upImpl->spBodyPartConnectorCaffe->setInterMinAboveThreshold(
                     (float)get(PoseProperty::ConnectInterMinAboveThreshold)
@@ -281,16 +650,73 @@ namespace op
                 upImpl->spBodyPartConnectorCaffe->setMinSubsetCnt((int)get(PoseProperty::ConnectMinSubsetCnt));
                 upImpl->spBodyPartConnectorCaffe->setMinSubsetScore((float)get(PoseProperty::ConnectMinSubsetScore));
 
-                // CUDA version not implemented yet
-                // #ifdef USE_CUDA
-                //     upImpl->spBodyPartConnectorCaffe->Forward_gpu({upImpl->spHeatMapsBlob.get(),
-                //                                                    upImpl->spPeaksBlob.get()},
-                //                                                   mPoseKeypoints, mPoseScores);
-                // #else
+                // 3-4. Local peak search: peaks only around the tracked people joints, and PAFs only scored for
+                // their limbs. The whole heat maps are searched if no people are tracked, periodically (new people)
+                // or if any tracked person is lost
+                const Point<int> heatMapSize{upImpl->spHeatMapsBlob->shape(3), upImpl->spHeatMapsBlob->shape(2)};
+                auto globalSearch = true;
+                if (upImpl->mLocalPeakSearchInterval > 0 && !upImpl->mTrackedKeypoints.empty()
+                    && upImpl->mFramesSinceGlobalSearch + 1 < upImpl->mLocalPeakSearchInterval
+                    && heatMapSize.x == upImpl->mTrackedHeatMapSize.x
+                    && heatMapSize.y == upImpl->mTrackedHeatMapSize.y)
+                {
+                    const auto numberTracked = upImpl->mTrackedKeypoints.getSize(0);
+                    setLocalPeakSearchWindows(upImpl->mPeakWindows, upImpl->mTrackedKeypoints, heatMapSize);
+                    const auto& peaksShape = upImpl->spPeaksBlob->shape();
+                    const auto& heatMapsShape = upImpl->spHeatMapsBlob->shape();
+                    upImpl->mPeakOwners.resize(peaksShape[1] * peaksShape[2]);
+                    nmsWindowsCpu(upImpl->spPeaksBlob->mutable_cpu_data(), upImpl->mPeakOwners.data(),
+                                  upImpl->spHeatMapsBlob->cpu_data(), (float)get(PoseProperty::NMSThreshold),
+                                  std::array<int, 4>{peaksShape[0], peaksShape[1], peaksShape[2], peaksShape[3]},
+                                  std::array<int, 4>{heatMapsShape[0], heatMapsShape[1], heatMapsShape[2],
+                                                     heatMapsShape[3]},
+                                  upImpl->mPeakWindows);
+                    upImpl->spBodyPartConnectorCaffe->setPeakOwners(upImpl->mPeakOwners.data());
                     upImpl->spBodyPartConnectorCaffe->Forward_cpu({upImpl->spHeatMapsBlob.get(),
                                                                    upImpl->spPeaksBlob.get()},
                                                                   mPoseKeypoints, mPoseScores);
-                // #endif
+                    upImpl->spBodyPartConnectorCaffe->setPeakOwners(nullptr);
+                    upImpl->mFramesSinceGlobalSearch++;
+                    globalSearch = (mPoseKeypoints.getSize(0) < numberTracked);
+                }
+                if (globalSearch)
+                {
+                    // 3. Get peaks by Non-Maximum Suppression
+                    #ifdef USE_CUDA
+                        upImpl->spNmsCaffe->Forward_gpu({upImpl->spHeatMapsBlob.get()},                         // ~2ms
+                                                        {upImpl->spPeaksBlob.get()});
+                        cudaCheck(__LINE__, __FUNCTION__, __FILE__);
+                    #else
+                        upImpl->spNmsCaffe->Forward_cpu({upImpl->spHeatMapsBlob.get()}, {upImpl->spPeaksBlob.get()});
+                    #endif
+
+                    // 4. Connecting body parts
+                    // CUDA version not implemented yet
+                    // #ifdef USE_CUDA
+                    //     upImpl->spBodyPartConnectorCaffe->Forward_gpu({upImpl->spHeatMapsBlob.get(),
+                    //                                                    upImpl->spPeaksBlob.get()},
+                    //                                                   mPoseKeypoints, mPoseScores);
+                    // #else
+                        upImpl->spBodyPartConnectorCaffe->Forward_cpu({upImpl->spHeatMapsBlob.get(),
+                                                                       upImpl->spPeaksBlob.get()},
+                                                                      mPoseKeypoints, mPoseScores);
+                    // #endif
+                    upImpl->mFramesSinceGlobalSearch = 0;
+                }
+                // Tracked people for the next frame (heat map coordinates)
+                if (upImpl->mLocalPeakSearchInterval > 0)
+                {
+                    upImpl->mTrackedKeypoints = mPoseKeypoints.clone();
+                    for (auto keypoint = 0 ; keypoint < (int)upImpl->mTrackedKeypoints.getVolume() / 3 ; keypoint++)
+                    {
+                        // Inverse of connectBodyPartsCpu: peak * scaleFactor + 0.5
+                        upImpl->mTrackedKeypoints[3*keypoint] = (upImpl->mTrackedKeypoints[3*keypoint] - 0.5f)
+                                                              / mScaleNetToOutput;
+                        upImpl->mTrackedKeypoints[3*keypoint+1] = (upImpl->mTrackedKeypoints[3*keypoint+1] - 0.5f)
+                                                                / mScaleNetToOutput;
+                    }
+                    upImpl->mTrackedHeatMapSize = heatMapSize;
+                }
             #else
                 UNUSED(inputNetData);
                 UNUSED(inputDataSize);
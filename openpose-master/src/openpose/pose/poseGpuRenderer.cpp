@@ -63,13 +63,16 @@ namespace op
     std::pair<int, std::string> PoseGpuRenderer::renderPose(Array<float>& outputData,
                                                             const Array<float>& poseKeypoints,
                                                             const float scaleInputToOutput,
-                                                            const float scaleNetToOutput)
+                                                            const float scaleNetToOutput,
+                                                            const Array<long long>& poseIds)
     {
         try
         {
             // Security checks
             if (outputData.empty())
                 error("Empty Array<float> outputData.", __LINE__, __FUNCTION__, __FILE__);
+            // Person ids only used by the CPU renderer
+            UNUSED(poseIds);
             // GPU rendering
             const auto elementRendered = spElementToRender->load();
             std::string elementRenderedName;
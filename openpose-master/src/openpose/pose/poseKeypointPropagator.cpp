@@ -0,0 +1,177 @@
+#include <opencv2/imgproc/imgproc.hpp> // cv::COLOR_BGR2GRAY, cv::cvtColor, cv::resize
+#include <opencv2/video/tracking.hpp> // cv::calcOpticalFlowPyrLK
+#include <openpose/utilities/fastMath.hpp>
+#include <openpose/pose/poseKeypointPropagator.hpp>
+
+namespace op
+{
+    // Width of the frames compared by the motion trigger
+    const auto THUMBNAIL_WIDTH = 64;
+
+    PoseKeypointPropagator::PoseKeypointPropagator(const int keyframeInterval, const float motionThreshold,
+                                                   const float minTrackedRatio, const float propagatedScoreRatio) :
+        mKeyframeInterval{keyframeInterval},
+        mMotionThreshold{motionThreshold},
+        mMinTrackedRatio{minTrackedRatio},
+        mPropagatedScoreRatio{propagatedScoreRatio},
+        mFramesSinceKeyframe{-1},
+        mKeyframeVisible{0}
+    {
+        try
+        {
+            if (mKeyframeInterval < 1)
+                error("The keyframe interval must be >= 1.", __LINE__, __FUNCTION__, __FILE__);
+            if (mPropagatedScoreRatio < 0.f || mPropagatedScoreRatio > 1.f)
+                error("The propagated score ratio must be in the range [0, 1].", __LINE__, __FUNCTION__, __FILE__);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    bool PoseKeypointPropagator::propagate(Array<float>& poseKeypoints, const cv::Mat& cvInputData)
+    {
+        try
+        {
+            // Gray frame (the previous one is kept for the optical flow)
+            updateGray(cvInputData);
+            // Keyframe: first frame, interval or new resolution
+            if (mFramesSinceKeyframe < 0 || mFramesSinceKeyframe + 1 >= mKeyframeInterval
+                || mGray.size() != mPreviousGray.size())
+                return false;
+            // Keyframe: motion
+            if (mMotionThreshold > 0.f)
+            {
+                const auto thumbnail = getThumbnail(mGray);
+                const auto meanDifference = cv::norm(thumbnail, mKeyframeThumbnail, cv::NORM_L1)
+                                          / (double)thumbnail.total();
+                if (meanDifference > mMotionThreshold)
+                    return false;
+            }
+            // Optical flow of the visible keypoints of the previous frame
+            const auto numberKeypoints = (int)mPreviousKeypoints.getVolume() / 3;
+            mPreviousPoints.clear();
+            mPointIndexes.clear();
+            mPoints.clear();
+            mStatus.clear();
+            for (auto keypoint = 0 ; keypoint < numberKeypoints ; keypoint++)
+            {
+                if (mPreviousKeypoints[3*keypoint+2] > 0.f)
+                {
+                    mPreviousPoints.emplace_back(mPreviousKeypoints[3*keypoint], mPreviousKeypoints[3*keypoint+1]);
+                    mPointIndexes.emplace_back(keypoint);
+                }
+            }
+            auto numberTracked = 0;
+            if (!mPreviousPoints.empty())
+            {
+                cv::calcOpticalFlowPyrLK(mPreviousGray, mGray, mPreviousPoints, mPoints, mStatus, mErrors,
+                                         cv::Size{21, 21}, 3);
+                for (auto i = 0u ; i < mPoints.size() ; i++)
+                {
+                    const auto& point = mPoints[i];
+                    mStatus[i] = (mStatus[i] && point.x >= 0.f && point.y >= 0.f
+                                  && point.x < mGray.cols && point.y < mGray.rows);
+                    numberTracked += mStatus[i];
+                }
+            }
+            // Keyframe: too many keypoints lost or nothing to track (e.g., no people left in the scene)
+            if (numberTracked == 0 || numberTracked < mMinTrackedRatio * mKeyframeVisible)
+                return false;
+            // Propagated keypoints
+            for (auto i = 0u ; i < mPointIndexes.size() ; i++)
+            {
+                const auto keypoint = mPointIndexes[i];
+                if (mStatus[i])
+                {
+                    mPreviousKeypoints[3*keypoint] = mPoints[i].x;
+                    mPreviousKeypoints[3*keypoint+1] = mPoints[i].y;
+                }
+                else
+                {
+                    mPreviousKeypoints[3*keypoint] = 0.f;
+                    mPreviousKeypoints[3*keypoint+1] = 0.f;
+                    mPreviousKeypoints[3*keypoint+2] = 0.f;
+                }
+            }
+            poseKeypoints = mPreviousKeypoints.clone();
+            for (auto keypoint = 0 ; keypoint < numberKeypoints ; keypoint++)
+                poseKeypoints[3*keypoint+2] *= mPropagatedScoreRatio;
+            mFramesSinceKeyframe++;
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    void PoseKeypointPropagator::setReusedFrame(const cv::Mat& cvInputData)
+    {
+        try
+        {
+            // The next optical flow starts from this frame
+            updateGray(cvInputData);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void PoseKeypointPropagator::setKeyframe(const Array<float>& poseKeypoints)
+    {
+        try
+        {
+            if (mGray.empty())
+                error("PoseKeypointPropagator::propagate() must be called before setKeyframe().",
+                      __LINE__, __FUNCTION__, __FILE__);
+            mPreviousKeypoints = poseKeypoints.clone();
+            mKeyframeVisible = 0;
+            for (auto keypoint = 0 ; keypoint < (int)mPreviousKeypoints.getVolume() / 3 ; keypoint++)
+                mKeyframeVisible += (mPreviousKeypoints[3*keypoint+2] > 0.f);
+            if (mMotionThreshold > 0.f)
+                mKeyframeThumbnail = getThumbnail(mGray);
+            mFramesSinceKeyframe = 0;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void PoseKeypointPropagator::updateGray(const cv::Mat& cvInputData)
+    {
+        try
+        {
+            // Security checks
+            if (cvInputData.empty() || cvInputData.channels() != 3)
+                error("Input images must be 3-channel BGR.", __LINE__, __FUNCTION__, __FILE__);
+            std::swap(mGray, mPreviousGray);
+            cv::cvtColor(cvInputData, mGray, cv::COLOR_BGR2GRAY);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    cv::Mat PoseKeypointPropagator::getThumbnail(const cv::Mat& gray) const
+    {
+        try
+        {
+            const cv::Size thumbnailSize{THUMBNAIL_WIDTH, fastMax(1, intRound(THUMBNAIL_WIDTH * gray.rows
+                                                                                / (float)gray.cols))};
+            cv::Mat thumbnail;
+            cv::resize(gray, thumbnail, thumbnailSize, 0, 0, cv::INTER_AREA);
+            return thumbnail;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return cv::Mat{};
+        }
+    }
+}
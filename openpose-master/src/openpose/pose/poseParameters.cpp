@@ -256,6 +256,9 @@ namespace op
     const std::array<float, (int)PoseModel::Size> POSE_CCN_DECREASE_FACTOR{
         8.f,        8.f,        8.f,        8.f,        8.f,        8.f,        8.f
     };
+    const std::array<unsigned int, (int)PoseModel::Size> POSE_NUMBER_STAGES{
+        6,          6,          4,          0,          0,          0,          0
+    };
 
     // Default Model Parameters
     // They might be modified on running time
@@ -381,6 +384,39 @@ namespace op
         }
     }
 
+    unsigned int getPoseNumberStages(const PoseModel poseModel)
+    {
+        try
+        {
+            return POSE_NUMBER_STAGES.at((int)poseModel);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 0u;
+        }
+    }
+
+    std::vector<std::string> getPoseStageOutputBlobs(const PoseModel poseModel, const unsigned int stage)
+    {
+        try
+        {
+            if (stage < 1 || stage > getPoseNumberStages(poseModel))
+                error("Stage " + std::to_string(stage) + " not available for this pose model.",
+                      __LINE__, __FUNCTION__, __FILE__);
+            // L2: heat maps, L1: PAFs
+            if (stage == 1)
+                return {"conv5_5_CPM_L2", "conv5_5_CPM_L1"};
+            const auto stageString = std::to_string(stage);
+            return {"Mconv7_stage" + stageString + "_L2", "Mconv7_stage" + stageString + "_L1"};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
     unsigned int poseBodyPartMapStringToKey(const PoseModel poseModel, const std::vector<std::string>& strings)
     {
         try
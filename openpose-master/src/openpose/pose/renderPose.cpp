@@ -6,7 +6,8 @@
 namespace op
 {
     void renderPoseKeypointsCpu(Array<float>& frameArray, const Array<float>& poseKeypoints, const PoseModel poseModel,
-                                const float renderThreshold, const bool blendOriginalFrame)
+                                const float renderThreshold, const bool blendOriginalFrame,
+                                const Array<long long>& poseIds, std::array<long long, 2>* trainPersonIds)
     {
         try
         {
@@ -26,7 +27,8 @@ namespace op
 
                 // Render keypoints
                 renderKeypointsCpu(frameArray, poseKeypoints, pairs, getPoseColors(poseModel), thicknessCircleRatio,
-                                   thicknessLineRatioWRTCircle, renderThreshold);
+                                   thicknessLineRatioWRTCircle, renderThreshold, poseIds,
+                                   trainPersonIds);
             }
         }
         catch (const std::exception& e)
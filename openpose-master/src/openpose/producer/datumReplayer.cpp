@@ -0,0 +1,248 @@
+#include <algorithm> // std::sort
+#include <chrono>
+#include <cmath> // std::abs
+#include <limits> // std::numeric_limits
+#include <mutex>
+#include <thread> // std::this_thread
+#include <openpose/utilities/fastMath.hpp>
+#include <openpose/producer/datumReplayer.hpp>
+
+namespace op
+{
+    struct DatumReplayer::ImplDatumReplayer
+    {
+        const DatumRecording mDatumRecording;
+        const bool mKeepRecordedPacing;
+        const float mKeypointTolerance;
+        mutable std::mutex mMutex;
+        unsigned long long mNextFrame;
+        std::chrono::high_resolution_clock::time_point mBeginTime;
+        std::chrono::high_resolution_clock::time_point mLastCheckTime;
+        long long mFirstTimestampNs;
+        // Per frame: time at which it was produced and latency until it was checked (< 0 if not checked yet)
+        std::vector<std::chrono::high_resolution_clock::time_point> mProducedTimes;
+        std::vector<double> mLatenciesMs;
+        unsigned long long mNumberCheckedFrames;
+        unsigned long long mNumberMismatchedFrames;
+        float mMaxKeypointError;
+
+        ImplDatumReplayer(const std::string& recordingPath, const bool keepRecordedPacing,
+                          const float keypointTolerance) :
+            mDatumRecording{recordingPath},
+            mKeepRecordedPacing{keepRecordedPacing},
+            mKeypointTolerance{keypointTolerance},
+            mNextFrame{0ull},
+            mFirstTimestampNs{0ll},
+            mProducedTimes(mDatumRecording.getNumberFrames()),
+            mLatenciesMs(mDatumRecording.getNumberFrames(), -1.),
+            mNumberCheckedFrames{0ull},
+            mNumberMismatchedFrames{0ull},
+            mMaxKeypointError{0.f}
+        {
+        }
+    };
+
+    namespace
+    {
+        // Maximum x-y difference between matching keypoints, or infinity if the number of people or the set of
+        // detected keypoints differs
+        float getKeypointError(const Array<float>& poseKeypoints, const Array<float>& recordedPoseKeypoints)
+        {
+            const auto infinity = std::numeric_limits<float>::infinity();
+            if (poseKeypoints.empty() || recordedPoseKeypoints.empty())
+                return (poseKeypoints.empty() == recordedPoseKeypoints.empty() ? 0.f : infinity);
+            if (poseKeypoints.getSize() != recordedPoseKeypoints.getSize())
+                return infinity;
+            auto maxError = 0.f;
+            for (auto i = 0u ; i < poseKeypoints.getVolume() ; i += 3)
+            {
+                const auto detected = (poseKeypoints[i+2] > 0.f);
+                if (detected != (recordedPoseKeypoints[i+2] > 0.f))
+                    return infinity;
+                if (detected)
+                    maxError = fastMax(maxError, fastMax(std::abs(poseKeypoints[i] - recordedPoseKeypoints[i]),
+                                                         std::abs(poseKeypoints[i+1] - recordedPoseKeypoints[i+1])));
+            }
+            return maxError;
+        }
+    }
+
+    DatumReplayer::DatumReplayer(const std::string& recordingPath, const bool keepRecordedPacing,
+                                 const float keypointTolerance) :
+        upImpl{new ImplDatumReplayer{recordingPath, keepRecordedPacing, keypointTolerance}}
+    {
+        try
+        {
+            log("Replaying " + std::to_string(upImpl->mDatumRecording.getNumberFrames()) + " recorded frames from "
+                + recordingPath + (keepRecordedPacing ? " at the recorded pacing." : " at maximum speed."),
+                Priority::High);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    DatumReplayer::~DatumReplayer()
+    {
+    }
+
+    unsigned long long DatumReplayer::getNumberFrames() const
+    {
+        return upImpl->mDatumRecording.getNumberFrames();
+    }
+
+    Point<int> DatumReplayer::getFrameSize() const
+    {
+        try
+        {
+            if (upImpl->mDatumRecording.getNumberFrames() == 0)
+                return Point<int>{-1, -1};
+            RecordedFrame recordedFrame;
+            upImpl->mDatumRecording.getFrame(recordedFrame, 0);
+            return Point<int>{recordedFrame.cvInputData.cols, recordedFrame.cvInputData.rows};
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return Point<int>{-1, -1};
+        }
+    }
+
+    bool DatumReplayer::getNextFrame(RecordedFrame& recordedFrame)
+    {
+        try
+        {
+            std::unique_lock<std::mutex> lock{upImpl->mMutex};
+            const auto frameIndex = upImpl->mNextFrame;
+            if (frameIndex >= upImpl->mDatumRecording.getNumberFrames())
+                return false;
+            upImpl->mNextFrame++;
+            upImpl->mDatumRecording.getFrame(recordedFrame, frameIndex);
+            // Pacing (first frame sets the time reference)
+            if (frameIndex == 0)
+            {
+                upImpl->mFirstTimestampNs = recordedFrame.timestampNs;
+                upImpl->mBeginTime = std::chrono::high_resolution_clock::now();
+            }
+            else if (upImpl->mKeepRecordedPacing)
+            {
+                const auto releaseTime = upImpl->mBeginTime + std::chrono::nanoseconds{
+                    recordedFrame.timestampNs - upImpl->mFirstTimestampNs
+                };
+                lock.unlock();
+                std::this_thread::sleep_until(releaseTime);
+                lock.lock();
+            }
+            upImpl->mProducedTimes[frameIndex] = std::chrono::high_resolution_clock::now();
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return false;
+        }
+    }
+
+    void DatumReplayer::checkFrame(const unsigned long long id, const Array<float>& poseKeypoints)
+    {
+        try
+        {
+            if (id >= upImpl->mDatumRecording.getNumberFrames())
+                error("Replayed frame id " + std::to_string(id) + " is not in the recording.",
+                      __LINE__, __FUNCTION__, __FILE__);
+            // Keypoint difference
+            auto keypointError = 0.f;
+            if (upImpl->mKeypointTolerance >= 0.f)
+            {
+                RecordedFrame recordedFrame;
+                upImpl->mDatumRecording.getFrame(recordedFrame, id);
+                keypointError = getKeypointError(poseKeypoints, recordedFrame.poseKeypoints);
+                if (keypointError > upImpl->mKeypointTolerance)
+                    log("Frame " + std::to_string(id) + " (" + recordedFrame.name + ") differs from the recording"
+                        " (max keypoint error = " + std::to_string(keypointError) + ").", Priority::Normal);
+            }
+            // Statistics
+            std::unique_lock<std::mutex> lock{upImpl->mMutex};
+            if (upImpl->mLatenciesMs[id] >= 0.)
+                error("Replayed frame id " + std::to_string(id) + " checked twice.", __LINE__, __FUNCTION__, __FILE__);
+            upImpl->mLastCheckTime = std::chrono::high_resolution_clock::now();
+            upImpl->mLatenciesMs[id] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                upImpl->mLastCheckTime - upImpl->mProducedTimes[id]
+            ).count() * 1e-6;
+            upImpl->mNumberCheckedFrames++;
+            if (upImpl->mKeypointTolerance >= 0.f && keypointError > upImpl->mKeypointTolerance)
+                upImpl->mNumberMismatchedFrames++;
+            upImpl->mMaxKeypointError = fastMax(upImpl->mMaxKeypointError, keypointError);
+            const auto allChecked = (upImpl->mNumberCheckedFrames == upImpl->mDatumRecording.getNumberFrames());
+            lock.unlock();
+            if (allChecked)
+                printReport();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    ReplayReport DatumReplayer::getReport() const
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock{upImpl->mMutex};
+            ReplayReport replayReport{upImpl->mDatumRecording.getNumberFrames(), upImpl->mNumberCheckedFrames,
+                                      upImpl->mNumberMismatchedFrames, upImpl->mMaxKeypointError, 0., 0., 0., 0., 0.};
+            std::vector<double> latenciesMs;
+            for (const auto latencyMs : upImpl->mLatenciesMs)
+                if (latencyMs >= 0.)
+                    latenciesMs.emplace_back(latencyMs);
+            if (!latenciesMs.empty())
+            {
+                std::sort(latenciesMs.begin(), latenciesMs.end());
+                auto latencySumMs = 0.;
+                for (const auto latencyMs : latenciesMs)
+                    latencySumMs += latencyMs;
+                replayReport.latencyAverageMs = latencySumMs / latenciesMs.size();
+                replayReport.latencyMedianMs = latenciesMs[latenciesMs.size() / 2];
+                replayReport.latency99Ms = latenciesMs[(latenciesMs.size() - 1) * 99 / 100];
+                replayReport.latencyMaxMs = latenciesMs.back();
+                const auto totalSeconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    upImpl->mLastCheckTime - upImpl->mBeginTime
+                ).count() * 1e-9;
+                if (totalSeconds > 0.)
+                    replayReport.fps = latenciesMs.size() / totalSeconds;
+            }
+            return replayReport;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return ReplayReport{};
+        }
+    }
+
+    void DatumReplayer::printReport(const Priority priority) const
+    {
+        try
+        {
+            const auto replayReport = getReport();
+            std::string message = "Replay report: " + std::to_string(replayReport.numberCheckedFrames) + "/"
+                                + std::to_string(replayReport.numberFrames) + " frames checked"
+                                + "\n    Throughput: " + std::to_string(replayReport.fps) + " FPS"
+                                + "\n    Latency: average = " + std::to_string(replayReport.latencyAverageMs)
+                                + " ms, median = " + std::to_string(replayReport.latencyMedianMs)
+                                + " ms, 99% = " + std::to_string(replayReport.latency99Ms)
+                                + " ms, max = " + std::to_string(replayReport.latencyMaxMs) + " ms";
+            if (upImpl->mKeypointTolerance >= 0.f)
+                message += "\n    Keypoints: " + std::to_string(replayReport.numberMismatchedFrames)
+                         + " frames differ from the recording (tolerance = "
+                         + std::to_string(upImpl->mKeypointTolerance) + ", max error = "
+                         + std::to_string(replayReport.maxKeypointError) + ")";
+            log(message, priority);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+}
@@ -4,4 +4,6 @@ namespace op
 {
     template class OP_API DatumProducer<DATUM_BASE_NO_PTR>;
     template class OP_API WDatumProducer<DATUM_BASE, DATUM_BASE_NO_PTR>;
+    DEFINE_TEMPLATE_DATUM(WDatumReplayChecker);
+    template class OP_API WDatumReplayer<DATUM_BASE, DATUM_BASE_NO_PTR>;
 }
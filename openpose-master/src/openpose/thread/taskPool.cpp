@@ -0,0 +1,393 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <openpose/utilities/fastMath.hpp>
+#include <openpose/thread/taskPool.hpp>
+
+namespace op
+{
+    namespace
+    {
+        struct Job
+        {
+            const std::function<void(const int, const int)>* functionPtr;
+            std::atomic<int> pendingTasks;
+            std::atomic<unsigned long long> stolenTasks;
+            std::exception_ptr exceptionPtr;
+            std::mutex mutex;
+            std::condition_variable condition;
+        };
+
+        struct Task
+        {
+            Job* jobPtr;
+            int begin;
+            int end;
+        };
+
+        struct TaskDeque
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        // Index of the pool thread running this code, -1 if it is not a pool thread
+        thread_local int tThreadIndex = -1;
+    }
+
+    struct TaskPool::ImplTaskPool
+    {
+        // Deques [0, #threads) belong to the pool threads, the last one receives the tasks from outside the pool
+        std::vector<std::unique_ptr<TaskDeque>> mTaskDeques;
+        std::vector<std::thread> mThreads;
+        int mNumberThreads;
+        std::atomic<long long> mQueuedTasks;
+        std::atomic<bool> mStop;
+        std::mutex mSleepMutex;
+        std::condition_variable mSleepCondition;
+        mutable std::mutex mStatisticsMutex;
+        std::map<std::string, TaskStatistics> mStatistics;
+
+        ImplTaskPool() :
+            mNumberThreads{0},
+            mQueuedTasks{0ll},
+            mStop{false}
+        {
+        }
+
+        int numberThreads() const
+        {
+            return mNumberThreads;
+        }
+
+        void push(const int dequeIndex, const Task& task)
+        {
+            std::lock_guard<std::mutex> lock{mTaskDeques[dequeIndex]->mutex};
+            mTaskDeques[dequeIndex]->tasks.emplace_back(task);
+        }
+
+        bool popBack(const int dequeIndex, Task& task)
+        {
+            auto& taskDeque = *mTaskDeques[dequeIndex];
+            std::lock_guard<std::mutex> lock{taskDeque.mutex};
+            if (taskDeque.tasks.empty())
+                return false;
+            task = taskDeque.tasks.back();
+            taskDeque.tasks.pop_back();
+            return true;
+        }
+
+        bool popFront(const int dequeIndex, Task& task)
+        {
+            auto& taskDeque = *mTaskDeques[dequeIndex];
+            std::lock_guard<std::mutex> lock{taskDeque.mutex};
+            if (taskDeque.tasks.empty())
+                return false;
+            task = taskDeque.tasks.front();
+            taskDeque.tasks.pop_front();
+            return true;
+        }
+
+        bool getTask(const int threadIndex, Task& task)
+        {
+            const auto externalDeque = numberThreads();
+            // Own tasks first (LIFO, cache friendly), then external tasks, then steal (FIFO) from other threads
+            auto found = (threadIndex >= 0 && popBack(threadIndex, task));
+            if (!found)
+                found = popFront(externalDeque, task);
+            if (!found)
+            {
+                for (auto i = 1 ; i <= externalDeque && !found ; i++)
+                {
+                    const auto victim = (threadIndex + i + externalDeque) % externalDeque;
+                    if (victim != threadIndex && popFront(victim, task))
+                    {
+                        task.jobPtr->stolenTasks++;
+                        found = true;
+                    }
+                }
+            }
+            if (found)
+                mQueuedTasks--;
+            return found;
+        }
+
+        void runTask(const Task& task)
+        {
+            auto& job = *task.jobPtr;
+            try
+            {
+                (*job.functionPtr)(task.begin, task.end);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock{job.mutex};
+                if (!job.exceptionPtr)
+                    job.exceptionPtr = std::current_exception();
+            }
+            // Decreased under the mutex, so the owner of the job cannot destroy it while it is being notified
+            std::lock_guard<std::mutex> lock{job.mutex};
+            if (--job.pendingTasks == 0)
+                job.condition.notify_all();
+        }
+
+        void threadFunction(const int threadIndex)
+        {
+            tThreadIndex = threadIndex;
+            while (true)
+            {
+                Task task;
+                if (getTask(threadIndex, task))
+                    runTask(task);
+                else
+                {
+                    std::unique_lock<std::mutex> lock{mSleepMutex};
+                    mSleepCondition.wait(lock, [this]{ return mStop || mQueuedTasks > 0; });
+                    if (mStop && mQueuedTasks <= 0)
+                        break;
+                }
+            }
+        }
+
+        void stopThreads()
+        {
+            {
+                std::lock_guard<std::mutex> lock{mSleepMutex};
+                mStop = true;
+            }
+            mSleepCondition.notify_all();
+            for (auto& thread : mThreads)
+                if (thread.joinable())
+                    thread.join();
+            mThreads.clear();
+            mNumberThreads = 0;
+            mStop = false;
+        }
+
+        void startThreads(const int numberThreadsToStart)
+        {
+            mTaskDeques.clear();
+            mNumberThreads = numberThreadsToStart;
+            for (auto i = 0 ; i <= numberThreadsToStart ; i++)
+                mTaskDeques.emplace_back(std::unique_ptr<TaskDeque>{new TaskDeque{}});
+            for (auto i = 0 ; i < numberThreadsToStart ; i++)
+                mThreads.emplace_back(std::thread{&ImplTaskPool::threadFunction, this, i});
+        }
+    };
+
+    TaskPool& TaskPool::getInstance()
+    {
+        static TaskPool sTaskPool;
+        return sTaskPool;
+    }
+
+    TaskPool::TaskPool() :
+        upImpl{new ImplTaskPool{}}
+    {
+        try
+        {
+            // The caller of parallelFor also works, so 1 core less by default
+            upImpl->startThreads(fastMax(0, (int)std::thread::hardware_concurrency() - 1));
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    TaskPool::~TaskPool()
+    {
+        try
+        {
+            upImpl->stopThreads();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void TaskPool::setNumberPipelineThreads(const int numberPipelineThreads)
+    {
+        try
+        {
+            const auto numberCores = (int)std::thread::hardware_concurrency();
+            setNumberThreads(fastMax(0, numberCores - fastMax(1, numberPipelineThreads)));
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void TaskPool::setNumberThreads(const int numberThreads)
+    {
+        try
+        {
+            if (numberThreads < 0)
+                error("The number of threads must be >= 0.", __LINE__, __FUNCTION__, __FILE__);
+            if (numberThreads != upImpl->numberThreads())
+            {
+                upImpl->stopThreads();
+                upImpl->startThreads(numberThreads);
+                log("TaskPool resized to " + std::to_string(numberThreads) + " threads.", Priority::Low,
+                    __LINE__, __FUNCTION__, __FILE__);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    int TaskPool::getNumberThreads() const
+    {
+        try
+        {
+            return upImpl->numberThreads();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return 0;
+        }
+    }
+
+    void TaskPool::parallelFor(const std::string& taskName, const int begin, const int end,
+                               const std::function<void(const int, const int)>& function, const int grainSize)
+    {
+        try
+        {
+            if (end <= begin)
+                return;
+
+            const auto beginTime = std::chrono::high_resolution_clock::now();
+            const auto numberElements = end - begin;
+            const auto numberThreads = upImpl->numberThreads();
+            // ~4 chunks per thread (counting the caller) balances load without too much scheduling overhead
+            const auto chunkSize = (grainSize > 0
+                                    ? grainSize : fastMax(1, (numberElements + 4*(numberThreads+1) - 1)
+                                                             / (4*(numberThreads+1))));
+            const auto numberTasks = (numberElements + chunkSize - 1) / chunkSize;
+
+            Job job;
+            job.functionPtr = &function;
+            job.pendingTasks = numberTasks;
+            job.stolenTasks = 0ull;
+
+            // Sequential if no pool threads or a single chunk
+            if (numberThreads == 0 || numberTasks == 1)
+            {
+                for (auto i = begin ; i < end ; i += chunkSize)
+                    function(i, fastMin(end, i + chunkSize));
+            }
+            else
+            {
+                // Queue all but the first chunk (own deque if pool thread, external deque otherwise)
+                const auto threadIndex = tThreadIndex;
+                const auto dequeIndex = (threadIndex >= 0 ? threadIndex : numberThreads);
+                for (auto i = begin + chunkSize ; i < end ; i += chunkSize)
+                    upImpl->push(dequeIndex, Task{&job, i, fastMin(end, i + chunkSize)});
+                upImpl->mQueuedTasks += numberTasks - 1;
+                {
+                    std::lock_guard<std::mutex> lock{upImpl->mSleepMutex};
+                }
+                upImpl->mSleepCondition.notify_all();
+                // The caller processes the first chunk and then helps until its job is done
+                upImpl->runTask(Task{&job, begin, fastMin(end, begin + chunkSize)});
+                while (job.pendingTasks > 0)
+                {
+                    Task task;
+                    if (upImpl->getTask(threadIndex, task))
+                        upImpl->runTask(task);
+                    // No queued tasks left -> the remaining chunks of this job are being run by other threads
+                    else
+                    {
+                        std::unique_lock<std::mutex> lock{job.mutex};
+                        job.condition.wait(lock, [&job]{ return job.pendingTasks <= 0; });
+                    }
+                }
+                // Wait until the last task releases the job
+                std::lock_guard<std::mutex> lock{job.mutex};
+                if (job.exceptionPtr)
+                    std::rethrow_exception(job.exceptionPtr);
+            }
+
+            // Statistics
+            const auto timeMs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::high_resolution_clock::now() - beginTime
+            ).count() * 1e-6;
+            std::lock_guard<std::mutex> lock{upImpl->mStatisticsMutex};
+            auto& statistics = upImpl->mStatistics[taskName];
+            if (statistics.calls == 0)
+            {
+                statistics.name = taskName;
+                statistics.maxMs = 0.;
+            }
+            statistics.calls++;
+            statistics.tasks += numberTasks;
+            statistics.stolenTasks += job.stolenTasks;
+            statistics.totalMs += timeMs;
+            statistics.maxMs = fastMax(statistics.maxMs, timeMs);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    std::vector<TaskStatistics> TaskPool::getStatistics() const
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock{upImpl->mStatisticsMutex};
+            std::vector<TaskStatistics> statistics;
+            for (const auto& keyValue : upImpl->mStatistics)
+                statistics.emplace_back(keyValue.second);
+            return statistics;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return {};
+        }
+    }
+
+    void TaskPool::printStatistics(const Priority priority) const
+    {
+        try
+        {
+            std::string message = "TaskPool statistics (" + std::to_string(getNumberThreads()) + " threads):";
+            for (const auto& statistics : getStatistics())
+                message += "\n    " + statistics.name
+                         + ": calls = " + std::to_string(statistics.calls)
+                         + ", tasks = " + std::to_string(statistics.tasks)
+                         + ", stolen = " + std::to_string(statistics.stolenTasks)
+                         + ", avg = " + std::to_string(statistics.totalMs / fastMax(1ull, statistics.calls)) + " ms"
+                         + ", max = " + std::to_string(statistics.maxMs) + " ms";
+            log(message, priority);
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void TaskPool::resetStatistics()
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock{upImpl->mStatisticsMutex};
+            upImpl->mStatistics.clear();
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+}
@@ -1,7 +1,9 @@
+#include <chrono>
 #include <ctime> // std::tm, std::time_t
 #include <fstream> // std::ifstream, std::ofstream
 #include <iostream> // std::cout, std::endl
 #include <stdexcept> // std::runtime_error
+#include <thread>
 #include <openpose/utilities/errorAndLog.hpp>
 
 namespace op
@@ -159,6 +161,141 @@ namespace op
 
 
 
+    // Asynchronous logging - Private variables and classes
+    // Bounded multi-producer single-consumer lock-free ring (D. Vyukov's bounded queue): producers reserve a slot with
+    // a CAS on mEnqueuePosition and publish it by updating its sequence number, the sink thread is the only consumer
+    const auto LOG_ASYNC_RING_SIZE = 1024ull; // Power of 2
+    const auto LOG_ASYNC_SLEEP_MS = 2;
+
+    struct LogAsyncSlot
+    {
+        std::atomic<unsigned long long> sequence;
+        char message[2*LOG_ASYNC_MESSAGE_SIZE];
+    };
+
+    class LogAsyncSink
+    {
+    public:
+        LogAsyncSink() :
+            mSlots(LOG_ASYNC_RING_SIZE),
+            mEnqueuePosition{0ull},
+            mDequeuePosition{0ull},
+            mDroppedMessages{0ull},
+            mStop{false}
+        {
+            for (auto i = 0ull ; i < mSlots.size() ; i++)
+                mSlots[i].sequence.store(i, std::memory_order_relaxed);
+            mThread = std::thread{&LogAsyncSink::threadFunction, this};
+        }
+
+        ~LogAsyncSink()
+        {
+            mStop = true;
+            if (mThread.joinable())
+                mThread.join();
+        }
+
+        void push(const char* const message, const int line, const char* const function, const char* const file)
+        {
+            auto position = mEnqueuePosition.load(std::memory_order_relaxed);
+            LogAsyncSlot* slot;
+            while (true)
+            {
+                slot = &mSlots[position & (LOG_ASYNC_RING_SIZE - 1)];
+                const auto sequence = slot->sequence.load(std::memory_order_acquire);
+                const auto difference = (long long)sequence - (long long)position;
+                if (difference == 0)
+                {
+                    if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                // Ring full -> drop instead of blocking the (probably real-time) caller
+                else if (difference < 0)
+                {
+                    mDroppedMessages++;
+                    return;
+                }
+                else
+                    position = mEnqueuePosition.load(std::memory_order_relaxed);
+            }
+            // Same format than createFullMessage()
+            if (line != -1 || function[0] != '\0' || file[0] != '\0')
+                std::snprintf(slot->message, sizeof(slot->message), "%s%s%s:%s():%d", message,
+                              (message[0] == '\0' ? "" : " in "), file, function, line);
+            else
+                std::snprintf(slot->message, sizeof(slot->message), "%s", message);
+            slot->sequence.store(position + 1, std::memory_order_release);
+        }
+
+    private:
+        std::vector<LogAsyncSlot> mSlots;
+        std::atomic<unsigned long long> mEnqueuePosition;
+        unsigned long long mDequeuePosition;
+        std::atomic<unsigned long long> mDroppedMessages;
+        std::atomic<bool> mStop;
+        std::thread mThread;
+
+        bool pop(std::string& message)
+        {
+            auto& slot = mSlots[mDequeuePosition & (LOG_ASYNC_RING_SIZE - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != mDequeuePosition + 1)
+                return false;
+            message.assign(slot.message);
+            slot.sequence.store(mDequeuePosition + LOG_ASYNC_RING_SIZE, std::memory_order_release);
+            mDequeuePosition++;
+            return true;
+        }
+
+        // Writes all the queued messages, returns false if there was none
+        bool drain(std::ofstream& loggingFile)
+        {
+            std::string message;
+            std::string batch;
+            while (pop(message))
+                batch += message + "\n";
+            const unsigned long long droppedMessages = mDroppedMessages.exchange(0ull);
+            if (droppedMessages > 0)
+                batch += "[" + std::to_string(droppedMessages) + " log messages dropped (full ring buffer)]\n";
+            if (batch.empty())
+                return false;
+            const auto logModes = ConfigureLog::getLogModes();
+            for (const auto& logMode : logModes)
+            {
+                if (logMode == LogMode::StdCout || logMode == LogMode::All)
+                    std::cout << batch << std::flush;
+                if (logMode == LogMode::FileLogging || logMode == LogMode::All)
+                {
+                    if (!loggingFile.is_open())
+                        loggingFile.open("errorLogging.txt", std::ios_base::app);
+                    loggingFile << batch << std::flush;
+                }
+            }
+            return true;
+        }
+
+        void threadFunction()
+        {
+            std::ofstream loggingFile;
+            while (!mStop)
+                if (!drain(loggingFile))
+                    std::this_thread::sleep_for(std::chrono::milliseconds{LOG_ASYNC_SLEEP_MS});
+            // Messages pushed before destruction
+            drain(loggingFile);
+        }
+    };
+
+    void logAsyncFormatted(const char* const message, const int line, const char* const function,
+                           const char* const file)
+    {
+        // Started on first use, flushed and joined at exit
+        static LogAsyncSink sLogAsyncSink;
+        sLogAsyncSink.push(message, line, function, file);
+    }
+
+
+
+
+
     // ConfigureError - Private variables
     // std::vector<ErrorMode> sErrorModes              {ErrorMode::StdRuntimeError};
     std::vector<ErrorMode> sErrorModes              {ErrorMode::StdCerr, ErrorMode::StdRuntimeError};
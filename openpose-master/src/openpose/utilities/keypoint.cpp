@@ -166,11 +166,40 @@ namespace op
 		return distance;
 	}
 
+	// Trainee of the upper or lower half of the frame, kept across frames by person id (PersonIdExtractor)
+	void keepTrainPerson(int& trainPerson, long long& trainPersonId, const Array<long long>& poseIds,
+		const std::vector<Rectangle<float>>& personRectangles, const int height, const bool upperHalf)
+	{
+		try
+		{
+			// No ids for this frame: the previous trainee is kept for the next ones
+			if ((size_t)poseIds.getVolume() != personRectangles.size())
+				return;
+			// Same person than in the previous frames if it is still in its half of the frame
+			for (auto person = 0u; person < personRectangles.size(); person++)
+			{
+				const auto& personRectangle = personRectangles[person];
+				if (poseIds[person] == trainPersonId && personRectangle.area() > 0
+					&& (upperHalf ? personRectangle.y < height / 2 : personRectangle.y > height / 2))
+				{
+					trainPerson = person;
+					return;
+				}
+			}
+			// Otherwise, the new selection
+			trainPersonId = ((unsigned int)trainPerson < personRectangles.size() ? poseIds[trainPerson] : -1);
+		}
+		catch (const std::exception& e)
+		{
+			error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+		}
+	}
+
 
 	void renderKeypointsCpu(Array<float>& frameArray, const Array<float>& keypoints,
 		const std::vector<unsigned int>& pairs, const std::vector<float> colors,
 		const float thicknessCircleRatio, const float thicknessLineRatioWRTCircle,
-		const float threshold)
+		const float threshold, const Array<long long>& poseIds, std::array<long long, 2>* trainPersonIds)
 	{
 		try
 		{
@@ -207,10 +236,12 @@ namespace op
 
 				if (is_start == true) {
 
-
+					// Person rectangles, computed once per frame
+					std::vector<Rectangle<float>> personRectangles(keypoints.getSize(0));
 					for (auto person = 0; person < keypoints.getSize(0); person++)
 					{
-						const auto person_temp_Rectangle = getKeypointsRectangle(keypoints, person, thresholdRectangle);
+						personRectangles[person] = getKeypointsRectangle(keypoints, person, thresholdRectangle);
+						const auto& person_temp_Rectangle = personRectangles[person];
 						temp_distance = abs((person_temp_Rectangle.x + person_temp_Rectangle.width / 4) - (width / 4));
 						if (person_temp_Rectangle.area() > 0) {
 
@@ -224,6 +255,13 @@ namespace op
 							}
 						}
 					}
+					// Keep the previous trainees while they are tracked (no flickering between people)
+					if (trainPersonIds != nullptr)
+					{
+						keepTrainPerson(theTrainPerson1, (*trainPersonIds)[0], poseIds, personRectangles, height, true);
+						keepTrainPerson(theTrainPerson2, (*trainPersonIds)[1], poseIds, personRectangles, height,
+							false);
+					}
 
 
 					if (keypoints.getSize(0) > 0) {
@@ -259,11 +297,11 @@ namespace op
 							//else theTrainPerson = theTrainPerson2;
 
 
-							printf("theTrainPerson: %d\n", theTrainPerson);
+							OP_LOG(Priority::Low, "theTrainPerson: %d", theTrainPerson);
 
 							// Keypoints
 							// for (auto person = 0 ; person < keypoints.getSize(0) ; person++){
-							const auto personRectangle = getKeypointsRectangle(keypoints, theTrainPerson, thresholdRectangle);
+							const auto& personRectangle = personRectangles[theTrainPerson];
 
 
 							if (personRectangle.area() > 0)
@@ -428,9 +466,9 @@ namespace op
 
 
 
-								printf("-----------------------------------------\n");
+								OP_LOG(Priority::Low, "-----------------------------------------");
 								for (int part = 0; part < numberKeypoints; part++) {
-									printf("posePoint_X[%d] = %d , posePoint_Y[%d] = %d\n", part, posePoint_X[part], part, posePoint_Y[part]);
+									OP_LOG(Priority::Low, "posePoint_X[%d] = %d , posePoint_Y[%d] = %d", part, posePoint_X[part], part, posePoint_Y[part]);
 
 								}
 
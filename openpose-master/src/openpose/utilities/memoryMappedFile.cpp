@@ -0,0 +1,113 @@
+#ifdef _WIN32
+    #include <cstring> // std::memcpy
+    #include <fstream> // std::ifstream
+    #include <iterator> // std::istreambuf_iterator
+#else
+    #include <fcntl.h> // open
+    #include <sys/mman.h> // mmap, munmap
+    #include <sys/stat.h> // fstat
+    #include <unistd.h> // close
+#endif
+#include <openpose/utilities/memoryMappedFile.hpp>
+
+namespace op
+{
+    struct MemoryMappedFile::ImplMemoryMappedFile
+    {
+        char* mDataPtr;
+        unsigned long long mSize;
+        const bool mCopyOnWrite;
+        #ifdef _WIN32
+            // unsigned long long storage keeps the 8-byte alignment of the memory-mapped version
+            std::vector<unsigned long long> mFileData;
+        #endif
+
+        explicit ImplMemoryMappedFile(const bool copyOnWrite) :
+            mDataPtr{nullptr},
+            mSize{0ull},
+            mCopyOnWrite{copyOnWrite}
+        {
+        }
+    };
+
+    MemoryMappedFile::MemoryMappedFile(const std::string& filePath, const bool copyOnWrite) :
+        upImpl{new ImplMemoryMappedFile{copyOnWrite}}
+    {
+        try
+        {
+            #ifdef _WIN32
+                std::ifstream ifstream{filePath, std::ios::binary};
+                if (!ifstream.is_open())
+                    error("File could not be opened: " + filePath, __LINE__, __FUNCTION__, __FILE__);
+                const std::string fileData{std::istreambuf_iterator<char>{ifstream}, std::istreambuf_iterator<char>{}};
+                if (fileData.empty())
+                    error("File is empty: " + filePath, __LINE__, __FUNCTION__, __FILE__);
+                upImpl->mFileData.resize((fileData.size() + 7) / 8);
+                std::memcpy(upImpl->mFileData.data(), fileData.data(), fileData.size());
+                upImpl->mDataPtr = (char*)upImpl->mFileData.data();
+                upImpl->mSize = fileData.size();
+            #else
+                const auto fileDescriptor = open(filePath.c_str(), O_RDONLY);
+                if (fileDescriptor < 0)
+                    error("File could not be opened: " + filePath, __LINE__, __FUNCTION__, __FILE__);
+                struct stat fileStat;
+                if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size <= 0)
+                {
+                    close(fileDescriptor);
+                    error("File is empty: " + filePath, __LINE__, __FUNCTION__, __FILE__);
+                }
+                upImpl->mSize = (unsigned long long)fileStat.st_size;
+                const auto protection = (copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ);
+                auto* const mappedPtr = mmap(nullptr, upImpl->mSize, protection, MAP_PRIVATE, fileDescriptor, 0);
+                close(fileDescriptor);
+                if (mappedPtr == MAP_FAILED)
+                    error("File could not be memory-mapped: " + filePath, __LINE__, __FUNCTION__, __FILE__);
+                upImpl->mDataPtr = (char*)mappedPtr;
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        try
+        {
+            #ifndef _WIN32
+                if (upImpl->mDataPtr != nullptr)
+                    munmap(upImpl->mDataPtr, upImpl->mSize);
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    const char* MemoryMappedFile::getConstPtr() const
+    {
+        return upImpl->mDataPtr;
+    }
+
+    char* MemoryMappedFile::getPtr()
+    {
+        try
+        {
+            if (!upImpl->mCopyOnWrite)
+                error("The file was mapped as read-only (copyOnWrite = false).", __LINE__, __FUNCTION__, __FILE__);
+            return upImpl->mDataPtr;
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return nullptr;
+        }
+    }
+
+    unsigned long long MemoryMappedFile::getSize() const
+    {
+        return upImpl->mSize;
+    }
+}
@@ -12,7 +12,19 @@ namespace op
                                          const std::string& modelFolder_,
                                          const std::vector<HeatMapType>& heatMapTypes_,
                                          const ScaleMode heatMapScale_, const float renderThreshold_,
-                                         const bool enableGoogleLogging_, const bool identification_) :
+                                         const bool enableGoogleLogging_, const bool identification_,
+                                         const int intraOpThreads_, const bool int8Inference_,
+                                         const int earlyExitStage_, const float earlyExitThreshold_,
+                                         const int interOpThreads_,
+                                         const unsigned long long profileLayersFrames_,
+                                         const std::string& profileLayersFolder_, const int keyframeInterval_,
+                                         const float keyframeMotionThreshold_,
+                                         const float keyframeMinTrackedRatio_, const int roiFullFrameInterval_,
+                                         const float roiPadding_, const double netResolutionTargetMs_,
+                                         const int netResolutionMinHeight_, const float motionGateThreshold_,
+                                         const int motionGateMaxReusedFrames_,
+                                         const int localPeakSearchInterval_, const int tileSize_,
+                                         const int tileOverlap_) :
         enable{enable_},
         netInputSize{netInputSize_},
         outputSize{outputSize_},
@@ -32,7 +44,26 @@ namespace op
         heatMapScale{heatMapScale_},
         renderThreshold{renderThreshold_},
         enableGoogleLogging{enableGoogleLogging_},
-        identification{identification_}
+        identification{identification_},
+        intraOpThreads{intraOpThreads_},
+        int8Inference{int8Inference_},
+        earlyExitStage{earlyExitStage_},
+        earlyExitThreshold{earlyExitThreshold_},
+        interOpThreads{interOpThreads_},
+        profileLayersFrames{profileLayersFrames_},
+        profileLayersFolder{profileLayersFolder_},
+        keyframeInterval{keyframeInterval_},
+        keyframeMotionThreshold{keyframeMotionThreshold_},
+        keyframeMinTrackedRatio{keyframeMinTrackedRatio_},
+        roiFullFrameInterval{roiFullFrameInterval_},
+        roiPadding{roiPadding_},
+        netResolutionTargetMs{netResolutionTargetMs_},
+        netResolutionMinHeight{netResolutionMinHeight_},
+        motionGateThreshold{motionGateThreshold_},
+        motionGateMaxReusedFrames{motionGateMaxReusedFrames_},
+        localPeakSearchInterval{localPeakSearchInterval_},
+        tileSize{tileSize_},
+        tileOverlap{tileOverlap_}
     {
     }
 }
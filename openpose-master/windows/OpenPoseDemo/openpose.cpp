@@ -90,6 +90,10 @@ DEFINE_int32(scale_number, 1, "Number of scales to average.");
 DEFINE_double(scale_gap, 0.3, "Scale gap between scales. No effect unless scale_number > 1. Initial scale is always 1."
 	" If you want to change the initial scale, you actually want to multiply the"
 	" `net_resolution` by your desired initial scale.");
+DEFINE_bool(int8_inference, false, "Load the INT8-calibrated body pose weights, i.e. the trained model with the `_int8`"
+	" suffix (e.g. `models/pose/coco/pose_iter_440000_int8.caffemodel`) written by"
+	" `examples/tests/int8Calibration.cpp`. The CPU version runs the convolutions that keep"
+	" their accuracy with int8 arithmetic.");
 // OpenPose Body Pose Heatmaps
 DEFINE_bool(heatmaps_add_parts, false, "If true, it will add the body part heatmaps to the final op::Datum::poseHeatMaps array,"
 	" and analogously face & hand heatmaps to op::Datum::faceHeatMaps & op::Datum::handHeatMaps"
@@ -218,6 +222,8 @@ int openPoseDemo()
 	const auto heatMapScale = op::flagsToHeatMapScaleMode(FLAGS_heatmaps_scale);
 	// Enabling Google Logging
 	const bool enableGoogleLogging = true;
+	// Threads of the CPU layers of each pose worker (-1 splits the cores between them)
+	const auto intraOpThreads = -1;
 	// Logging
 	op::log("", op::Priority::Low, __LINE__, __FUNCTION__, __FILE__);
 
@@ -231,7 +237,8 @@ int openPoseDemo()
 		poseModel, !FLAGS_disable_blending, (float)FLAGS_alpha_pose,
 		(float)FLAGS_alpha_heatmap, FLAGS_part_to_show, FLAGS_model_folder,
 		heatMapTypes, heatMapScale, (float)FLAGS_render_threshold,
-		enableGoogleLogging, FLAGS_identification };
+		enableGoogleLogging, FLAGS_identification, intraOpThreads,
+		FLAGS_int8_inference };
 	// Face configuration (use op::WrapperStructFace{} to disable it)
 	const op::WrapperStructFace wrapperStructFace{ FLAGS_face, faceNetInputSize,
 		op::flagsToRenderMode(FLAGS_face_render, FLAGS_render_pose),